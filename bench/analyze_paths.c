@@ -0,0 +1,393 @@
+/*
+ * Path quality analyzer
+ *
+ * Generates a large number of WindMouse paths on every core and reports
+ * what they look like, not how fast they are made. This is the check to
+ * run before and after touching the generator or its config.h ranges.
+ * Targets are drawn the way wind_move_begin() draws them. Each path is
+ * summarized as it streams by and then dropped:
+ *
+ *   points       points played (capped at MAX_PATH_POINTS)
+ *   duration     sum of the point delays
+ *   final_error  distance from where the cursor stops to the target
+ *   detour       distance travelled / straight-line distance to the target
+ *   mean_speed   distance travelled / duration
+ *   peak_speed   fastest single point
+ *   curvature    mean turn per pixel travelled
+ *   jerk_rms     RMS of the third derivative of position
+ *
+ * Each worker fills its own histograms (stats.h, 12.5% buckets). They are
+ * merged at the end. Work is shared through per-worker ranges of path
+ * indices. A worker takes small chunks from the front of its own range
+ * and, once that is empty, steals half of another worker's remainder.
+ * A capped path costs over twice an average one, so a static split
+ * leaves cores idle at the end. Path i always uses the same seed, so the
+ * report does not depend on the thread count.
+ *
+ *   gcc -O2 -fno-math-errno -fno-trapping-math -std=c11 -Wno-unused-function \
+ *       -Isrc bench/analyze_paths.c -lm -lpthread -o analyze_paths
+ *   ./analyze_paths [-n paths] [-j threads] [-s seed] [-g windmouse|candidates] [-c config]
+ *
+ * -g candidates analyzes the best-fit candidate, i.e. what the daemon
+ * plays. -c applies a config file (same format as the daemon's) before
+ * generating. One JSON line for the run, then one per metric.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <math.h>
+
+#include "config.h"
+#include "rng.h"
+#include "stats.h"
+#include "windmouse.h"
+#include "windmouse_multi.h"
+#include "bench_common.h"
+
+#define PATHS           1000000
+#define CHUNK           64          // paths taken from the own range at a time
+#define MAX_WORKERS     256
+#define TARGET_RANGE    400.0       // as wind_move_begin()
+
+typedef enum {
+    M_POINTS,
+    M_DURATION,
+    M_FINAL_ERROR,
+    M_DETOUR,
+    M_MEAN_SPEED,
+    M_PEAK_SPEED,
+    M_CURVATURE,
+    M_JERK_RMS,
+    METRIC_COUNT
+} Metric;
+
+/* histograms hold integers: values are recorded multiplied by scale */
+static const struct {
+    const char *name;
+    const char *unit;
+    double scale;
+} metrics[METRIC_COUNT] = {
+    { "points",      "points",  1 },
+    { "duration",    "s",       1000 },
+    { "final_error", "px",      100 },
+    { "detour",      "ratio",   1000 },
+    { "mean_speed",  "px/s",    10 },
+    { "peak_speed",  "px/s",    10 },
+    { "curvature",   "rad/px",  100000 },
+    { "jerk_rms",    "px/s^3",  1 },
+};
+
+typedef struct {
+    _Alignas(64) _Atomic uint64_t range;    /* next index | end << 32 */
+    Histogram hist[METRIC_COUNT];
+    unsigned long long paths, points, cap_hits, short_paths, steals;
+    WindCandidates *cand;
+    int id;
+} Worker;
+
+static Worker *workers;
+static int worker_count;
+static uint64_t base_seed;
+static int use_candidates;
+
+static inline uint64_t range_pack(uint32_t lo, uint32_t hi) {
+    return (uint64_t)hi << 32 | lo;
+}
+
+// ============================================================================
+// PER-PATH STATISTICS (one pass over the points, nothing kept)
+// ============================================================================
+
+typedef struct {
+    long   x, y;                /* cursor, relative to the start */
+    double length;              /* px travelled */
+    double duration_s;
+    double peak_speed;
+    double turn;                /* sum of |turn| (rad) */
+    double turn_length;         /* px over which turn was measured */
+    double jerk_sq;
+    long   jerk_n;
+    int    count;
+    int    pdx, pdy;            /* previous step */
+    double vx, vy, ax, ay;      /* previous velocity / acceleration */
+} PathAcc;
+
+static inline void acc_point(PathAcc *a, int dx, int dy, int delay_us) {
+    double step = hypot(dx, dy);
+    double dt = delay_us / 1e6;
+    double vx = dx / dt, vy = dy / dt;
+
+    if (step / dt > a->peak_speed)
+        a->peak_speed = step / dt;
+
+    if (a->count > 0) {
+        double cross = (double)a->pdx * dy - (double)a->pdy * dx;
+        double dot   = (double)a->pdx * dx + (double)a->pdy * dy;
+        a->turn += fabs(atan2(cross, dot));
+        a->turn_length += step;
+
+        double ax = (vx - a->vx) / dt, ay = (vy - a->vy) / dt;
+        if (a->count > 1) {
+            double jx = (ax - a->ax) / dt, jy = (ay - a->ay) / dt;
+            a->jerk_sq += jx * jx + jy * jy;
+            a->jerk_n++;
+        }
+        a->ax = ax;
+        a->ay = ay;
+    }
+
+    a->x += dx;
+    a->y += dy;
+    a->length += step;
+    a->duration_s += dt;
+    a->pdx = dx;
+    a->pdy = dy;
+    a->vx = vx;
+    a->vy = vy;
+    a->count++;
+}
+
+static inline void record(Worker *w, Metric m, double v) {
+    double s = v * metrics[m].scale + 0.5;
+    hist_add(&w->hist[m], s > 0 ? (uint64_t)s : 0);
+}
+
+static void acc_finish(Worker *w, const PathAcc *a, double tx, double ty) {
+    double error = hypot(tx - a->x, ty - a->y);
+    double want = hypot(tx, ty);
+
+    w->paths++;
+    w->points += (unsigned long long)a->count;
+    if (a->count >= MAX_PATH_POINTS)
+        w->cap_hits++;
+    /* generation stops within target_radius of the float position;
+     * rounding the steps adds at most another pixel */
+    if (error > settings_get()->target_radius_max + 1.0)
+        w->short_paths++;
+
+    record(w, M_POINTS, a->count);
+    record(w, M_DURATION, a->duration_s);
+    record(w, M_FINAL_ERROR, error);
+    record(w, M_DETOUR, a->length / (want > 1.0 ? want : 1.0));
+    record(w, M_MEAN_SPEED, a->duration_s > 0 ? a->length / a->duration_s : 0);
+    record(w, M_PEAK_SPEED, a->peak_speed);
+    record(w, M_CURVATURE, a->turn_length > 0 ? a->turn / a->turn_length : 0);
+    record(w, M_JERK_RMS, a->jerk_n ? sqrt(a->jerk_sq / a->jerk_n) : 0);
+}
+
+// ============================================================================
+// ONE PATH
+// ============================================================================
+
+static void analyze_path(Worker *w, uint32_t index) {
+    Rng r;
+    rng_seed(&r, base_seed ^ (uint64_t)index * 0x9e3779b97f4a7c15ull);
+    double tx = rng_range(&r, -TARGET_RANGE, TARGET_RANGE);
+    double ty = rng_range(&r, -TARGET_RANGE, TARGET_RANGE);
+    uint64_t seed = rng_next(&r);
+
+    PathAcc a;
+    memset(&a, 0, sizeof(a));
+
+    if (use_candidates) {
+        int best = wind_candidates_generate(w->cand, seed, tx, ty);
+        const PackedPoint *p = w->cand->points[best];
+        for (int i = 0; i < w->cand->lanes.count[best]; i++)
+            acc_point(&a, p[i].dx, p[i].dy, p[i].delay_us);
+    } else {
+        MousePath path = generate_wind_path(seed, tx, ty);
+        for (int i = 0; i < path.count; i++)
+            acc_point(&a, path.points[i].dx, path.points[i].dy, path.points[i].delay_us);
+    }
+    acc_finish(w, &a, tx, ty);
+}
+
+// ============================================================================
+// WORK-STEALING POOL
+// ============================================================================
+
+// Take up to CHUNK indices from the front of the own range
+static int take(Worker *w, uint32_t *lo, uint32_t *hi) {
+    uint64_t r = atomic_load_explicit(&w->range, memory_order_acquire);
+    for (;;) {
+        uint32_t a = (uint32_t)r, b = (uint32_t)(r >> 32);
+        if (a >= b)
+            return 0;
+        uint32_t n = b - a < CHUNK ? b - a : CHUNK;
+        if (atomic_compare_exchange_weak_explicit(&w->range, &r, range_pack(a + n, b),
+                                                  memory_order_acq_rel, memory_order_acquire)) {
+            *lo = a;
+            *hi = a + n;
+            return 1;
+        }
+    }
+}
+
+// Move the back half of some other worker's range into the own (empty)
+// one. Returns 0 once every range is empty.
+static int steal(Worker *w) {
+    for (int k = 1; k < worker_count; k++) {
+        Worker *v = &workers[(w->id + k) % worker_count];
+        uint64_t r = atomic_load_explicit(&v->range, memory_order_acquire);
+        for (;;) {
+            uint32_t a = (uint32_t)r, b = (uint32_t)(r >> 32);
+            if (a >= b)
+                break;
+            uint32_t mid = a + (b - a) / 2;
+            if (atomic_compare_exchange_weak_explicit(&v->range, &r, range_pack(a, mid),
+                                                      memory_order_acq_rel,
+                                                      memory_order_acquire)) {
+                /* nobody steals from an empty range, so a plain store is safe */
+                atomic_store_explicit(&w->range, range_pack(mid, b), memory_order_release);
+                w->steals++;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static void *worker_main(void *arg) {
+    Worker *w = arg;
+    uint32_t lo, hi;
+
+    for (;;) {
+        while (take(w, &lo, &hi))
+            for (uint32_t i = lo; i < hi; i++)
+                analyze_path(w, i);
+        if (!steal(w))
+            return NULL;
+    }
+}
+
+// ============================================================================
+// REPORT
+// ============================================================================
+
+static void report_metric(Metric m, const Histogram *hg) {
+    double s = metrics[m].scale;
+    printf("{\"bench\": \"analyze_paths\", \"metric\": \"%s\", \"unit\": \"%s\", "
+           "\"mean\": %.6g, \"p1\": %.6g, \"p10\": %.6g, \"p50\": %.6g, \"p90\": %.6g, "
+           "\"p99\": %.6g, \"max\": %.6g}\n",
+           metrics[m].name, metrics[m].unit,
+           hg->count ? (double)hg->sum / hg->count / s : 0.0,
+           hist_percentile(hg, 0.01) / s, hist_percentile(hg, 0.10) / s,
+           hist_percentile(hg, 0.50) / s, hist_percentile(hg, 0.90) / s,
+           hist_percentile(hg, 0.99) / s, hg->max / s);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-n paths] [-j threads] [-s seed] "
+                    "[-g windmouse|candidates] [-c config]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    long paths = PATHS;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    const char *config = NULL;
+    base_seed = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:j:s:g:c:")) != -1) {
+        switch (opt) {
+        case 'n': paths = atol(optarg); break;
+        case 'j': threads = atol(optarg); break;
+        case 's': base_seed = strtoull(optarg, NULL, 0); break;
+        case 'c': config = optarg; break;
+        case 'g':
+            if (strcmp(optarg, "candidates") == 0)
+                use_candidates = 1;
+            else if (strcmp(optarg, "windmouse") != 0) {
+                usage(argv[0]);
+                return 2;
+            }
+            break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (paths < 1 || paths > (long)UINT32_MAX || threads < 1 || optind < argc) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (threads > MAX_WORKERS)
+        threads = MAX_WORKERS;
+
+    if (config) {
+        /* the daemon treats a missing file as "no overrides"; here it is a typo */
+        char changed[1024];
+        if (access(config, R_OK) < 0) {
+            perror(config);
+            return 2;
+        }
+        if (settings_load(config, changed, sizeof(changed)) < 0) {
+            fprintf(stderr, "%s\n", changed);
+            return 2;
+        }
+    }
+
+    worker_count = (int)threads;
+    workers = aligned_alloc(64, sizeof(Worker) * (size_t)worker_count);
+    if (!workers)
+        return 1;
+    memset(workers, 0, sizeof(Worker) * (size_t)worker_count);
+
+    /* even split up front; stealing evens out the rest */
+    for (int i = 0; i < worker_count; i++) {
+        Worker *w = &workers[i];
+        w->id = i;
+        atomic_init(&w->range, range_pack((uint32_t)(paths * i / worker_count),
+                                          (uint32_t)(paths * (i + 1) / worker_count)));
+        if (use_candidates && !(w->cand = malloc(sizeof(*w->cand))))
+            return 1;
+    }
+
+    pthread_t tid[MAX_WORKERS];
+    long long t0 = bench_now_ns();
+    for (int i = 1; i < worker_count; i++) {
+        if (pthread_create(&tid[i], NULL, worker_main, &workers[i]) != 0) {
+            perror("pthread_create");
+            return 1;
+        }
+    }
+    worker_main(&workers[0]);
+    for (int i = 1; i < worker_count; i++)
+        pthread_join(tid[i], NULL);
+    long long wall = bench_now_ns() - t0;
+
+    static Histogram total[METRIC_COUNT];
+    unsigned long long points = 0, cap_hits = 0, short_paths = 0, steals = 0;
+    for (int i = 0; i < worker_count; i++) {
+        const Worker *w = &workers[i];
+        for (int m = 0; m < METRIC_COUNT; m++)
+            hist_merge(&total[m], &w->hist[m]);
+        points      += w->points;
+        cap_hits    += w->cap_hits;
+        short_paths += w->short_paths;
+        steals      += w->steals;
+    }
+
+    printf("{\"bench\": \"analyze_paths\", \"generator\": \"%s\", \"config\": \"%s\", "
+           "\"seed\": %llu, \"paths\": %ld, \"threads\": %d, \"steals\": %llu, "
+           "\"paths_per_sec\": %.0f, \"points\": %llu, \"cap_hits\": %llu, "
+           "\"cap_hit_pct\": %.3f, \"short\": %llu, \"short_pct\": %.3f}\n",
+           use_candidates ? "candidates" : "windmouse", config ? config : "defaults",
+           (unsigned long long)base_seed, paths, worker_count, steals,
+           paths * 1e9 / wall, points, cap_hits, 100.0 * cap_hits / paths,
+           short_paths, 100.0 * short_paths / paths);
+    for (int m = 0; m < METRIC_COUNT; m++)
+        report_metric((Metric)m, &total[m]);
+
+    for (int i = 0; i < worker_count; i++)
+        free(workers[i].cand);
+    free(workers);
+    settings_free();
+    return 0;
+}
@@ -0,0 +1,193 @@
+/*
+ * Frame coalescing benchmark + check
+ *
+ * Runs WindMouse paths (smooth delays and batch's fixed 5 ms) and 1 kHz
+ * mouse-like paths (what --replay plays) through the coalescer at 60, 120
+ * and 144 Hz. For each it reports the write reduction and checks what must
+ * not change:
+ *
+ *   displacement  - summed dx/dy of the output equals the input, per path
+ *   duration      - last output fires within one frame of the last input
+ *   trajectory    - cursor position, coalesced vs original, at every frame
+ *                   boundary (what a compositor in phase with us would
+ *                   show; expected 0) and at every original point (how far
+ *                   the coalesced cursor runs ahead inside a frame), in px
+ *
+ * Exits 1 if a displacement or duration check fails. One JSON line per
+ * source and rate:
+ *
+ *   gcc -O2 -fno-math-errno -fno-trapping-math -std=c11 -Wno-unused-function \
+ *       -Isrc bench/bench_coalesce.c -lm -o bench_coalesce
+ *   ./bench_coalesce [paths]
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "config.h"
+#include "rng.h"
+#include "windmouse.h"
+#include "coalesce.h"
+#include "bench_common.h"
+
+#define PATHS       500
+#define SYNTH_MAX   1500
+
+static const int rates[] = { 60, 120, 144 };
+#define RATE_COUNT (sizeof(rates) / sizeof(rates[0]))
+
+typedef enum { SRC_SMOOTH, SRC_BATCH, SRC_1KHZ } Source;
+static const char *const source_names[] = { "windmouse_smooth", "windmouse_batch", "mouse_1khz" };
+
+static PackedPoint in_pts[MAX_PATH_POINTS];
+static long long   in_t[MAX_PATH_POINTS];
+static long long   out_t[MAX_PATH_POINTS];
+static int         out_x[MAX_PATH_POINTS], out_y[MAX_PATH_POINTS];   /* after the output */
+
+// Input path as a finished point list (timestamps as the executor plans them)
+static int make_path(Source src, Rng *rng) {
+    int n = 0;
+
+    if (src == SRC_1KHZ) {
+        /* a hand move: speed rises and falls over 0.2-1.5 s at 1 ms per report */
+        int len = (int)rng_range(rng, 200, SYNTH_MAX);
+        double a = rng_range(rng, 0, 2 * M_PI), peak = rng_range(rng, 0.5, 3.0);
+        double fx = 0, fy = 0;
+        for (int i = 0; i < len && n < MAX_PATH_POINTS; i++) {
+            double v = peak * sin(M_PI * (i + 0.5) / len);
+            fx += v * cos(a);
+            fy += v * sin(a);
+            int ix = (int)lround(fx), iy = (int)lround(fy);
+            if (ix == 0 && iy == 0) {
+                if (n > 0) in_pts[n - 1].delay_us += 1000;
+                continue;
+            }
+            fx -= ix;
+            fy -= iy;
+            in_pts[n++] = (PackedPoint){ .dx = (int8_t)ix, .dy = (int8_t)iy, .delay_us = 1000 };
+            a += rng_range(rng, -0.02, 0.02);
+        }
+    } else {
+        WindState st;
+        wind_init(&st, rng_next(rng), rng_range(rng, -400, 400), rng_range(rng, -400, 400));
+        while (n < MAX_PATH_POINTS && wind_next(&st, &in_pts[n]))
+            n++;
+        if (src == SRC_BATCH)
+            for (int i = 0; i < n; i++)
+                in_pts[i].delay_us = 5000;
+    }
+
+    long long t = 0;
+    for (int i = 0; i < n; i++) {
+        in_t[i] = t;
+        t += in_pts[i].delay_us;
+    }
+    return n;
+}
+
+int main(int argc, char *argv[]) {
+    int paths = argc > 1 ? atoi(argv[1]) : PATHS;
+    if (paths < 1) paths = PATHS;
+
+    int failed = 0;
+    for (int s = SRC_SMOOTH; s <= SRC_1KHZ; s++) {
+        for (size_t r = 0; r < RATE_COUNT; r++) {
+            Rng rng;
+            rng_seed(&rng, 7);
+
+            long frame = coalesce_frame_us(rates[r]);
+            long long in_total = 0, out_total = 0, ns = 0;
+            int disp_bad = 0, dur_bad = 0;
+            double max_err = 0, sum_err = 0, max_vsync_err = 0;
+            long long err_n = 0, max_shift = 0;
+
+            for (int p = 0; p < paths; p++) {
+                int n = make_path((Source)s, &rng);
+                if (n == 0) continue;
+
+                PathStream ps;
+                stream_init_packed(&ps, in_pts, n);
+                Coalescer co;
+                coalesce_init(&co, &ps, rates[r], 0);
+
+                int ox = 0, oy = 0, m = 0;
+                long long t = 0;
+                PackedPoint o;
+                long long t0 = bench_now_ns();
+                while (m < MAX_PATH_POINTS && coalesce_pop(&co, &o)) {
+                    ox += o.dx;
+                    oy += o.dy;
+                    out_t[m] = t;
+                    out_x[m] = ox;
+                    out_y[m] = oy;
+                    m++;
+                    t += o.delay_us;
+                }
+                ns += bench_now_ns() - t0;
+                long long last_t = m ? out_t[m - 1] : 0;
+
+                /* both cursors right after each original point fired */
+                int ix = 0, iy = 0, j = 0;
+                for (int i = 0; i < n; i++) {
+                    ix += in_pts[i].dx;
+                    iy += in_pts[i].dy;
+                    while (j + 1 < m && out_t[j + 1] <= in_t[i])
+                        j++;
+                    double e = hypot(ix - out_x[j], iy - out_y[j]);
+                    if (e > max_err) max_err = e;
+                    sum_err += e;
+                    err_n++;
+                }
+
+                /* both cursors at each frame boundary */
+                int bx = 0, by = 0, cx = 0, cy = 0, bi = 0, bj = 0;
+                for (long long b = frame; b <= in_t[n - 1] + frame; b += frame) {
+                    for (; bi < n && in_t[bi] < b; bi++) {
+                        bx += in_pts[bi].dx;
+                        by += in_pts[bi].dy;
+                    }
+                    for (; bj < m && out_t[bj] < b; bj++) {
+                        cx = out_x[bj];
+                        cy = out_y[bj];
+                    }
+                    double e = hypot(bx - cx, by - cy);
+                    if (e > max_vsync_err) max_vsync_err = e;
+                }
+
+                int sx = 0, sy = 0;
+                for (int i = 0; i < n; i++) {
+                    sx += in_pts[i].dx;
+                    sy += in_pts[i].dy;
+                }
+                if (sx != ox || sy != oy)
+                    disp_bad++;
+
+                long long shift = in_t[n - 1] - last_t;
+                if (shift < 0) shift = -shift;
+                if (shift >= frame)
+                    dur_bad++;
+                if (shift > max_shift)
+                    max_shift = shift;
+
+                in_total += co.in;
+                out_total += co.out;
+            }
+
+            int ok = disp_bad == 0 && dur_bad == 0;
+            failed |= !ok;
+            printf("{\"bench\": \"coalesce\", \"source\": \"%s\", \"hz\": %d, \"paths\": %d, "
+                   "\"points_in\": %lld, \"points_out\": %lld, \"reduction\": %.2f, "
+                   "\"displacement_mismatches\": %d, \"max_end_shift_us\": %lld, "
+                   "\"vsync_err_px_max\": %.1f, \"lead_px_avg\": %.2f, \"lead_px_max\": %.1f, "
+                   "\"ns_per_point\": %.1f, \"ok\": %s}\n",
+                   source_names[s], rates[r], paths, in_total, out_total,
+                   out_total ? (double)in_total / out_total : 0.0,
+                   disp_bad, max_shift, max_vsync_err, err_n ? sum_err / err_n : 0.0, max_err,
+                   in_total ? (double)ns / in_total : 0.0, ok ? "true" : "false");
+        }
+    }
+    return failed;
+}
@@ -0,0 +1,34 @@
+/*
+ * Shared helpers for the benchmarks: monotonic time and percentiles.
+ */
+
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static long long bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ll + ts.tv_nsec;
+}
+
+static int bench_cmp_ll(const void *a, const void *b) {
+    long long x = *(const long long *)a, y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+// Sorts v in place; call once, then read as many percentiles as needed
+static void bench_sort(long long *v, int n) {
+    qsort(v, (size_t)n, sizeof(v[0]), bench_cmp_ll);
+}
+
+static long long bench_pct(const long long *sorted, int n, double q) {
+    if (n <= 0)
+        return 0;
+    return sorted[(int)((n - 1) * q + 0.5)];
+}
+
+#endif // BENCH_COMMON_H
@@ -0,0 +1,130 @@
+/*
+ * Motion corpus benchmark
+ *
+ * Grows a corpus of synthetic segments (log-uniform length, random
+ * direction) and, at every decade of size, measures:
+ *
+ *   open  - corpus_open(): map + header check (what --replay costs at startup)
+ *   pick  - corpus_pick(): class lookup, slot read, copy + orientation
+ *
+ * Both should stay flat as the corpus grows. Appends are timed as well.
+ * The corpus lives in a temporary directory. One JSON line per measurement:
+ *
+ *   gcc -O2 -std=c11 -Isrc bench/bench_corpus.c -lm -lpthread -o bench_corpus
+ *   ./bench_corpus [segments]
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "corpus.h"
+
+#include "bench_common.h"
+
+#define SEGMENTS    100000
+#define PICKS       2000
+#define OPENS       200
+
+static PackedPoint seg_buf[MAX_PATH_POINTS];
+static PackedPoint out_buf[MAX_PATH_POINTS];
+
+// A wobbly line: count points heading roughly along angle a
+static int synth_segment(Rng *r) {
+    int count = (int)exp(rng_range(r, log(CORPUS_MIN_POINTS), log(512)));
+    double a = rng_range(r, 0, 2 * M_PI);
+    double speed = rng_range(r, 1.0, 6.0);
+
+    for (int i = 0; i < count; i++) {
+        double v = speed * rng_range(r, 0.5, 1.5);
+        seg_buf[i].dx = (int8_t)lround(v * cos(a) + rng_range(r, -1, 1));
+        seg_buf[i].dy = (int8_t)lround(v * sin(a) + rng_range(r, -1, 1));
+        seg_buf[i].delay_us = (uint16_t)rng_range(r, 1000, 8000);
+        a += rng_range(r, -0.1, 0.1);
+    }
+    return count;
+}
+
+static void measure(const char *path, uint64_t segments, Rng *r, long long *ns) {
+    for (int i = 0; i < OPENS; i++) {
+        Corpus c;
+        long long t0 = bench_now_ns();
+        int ok = corpus_open(&c, path);
+        ns[i] = bench_now_ns() - t0;
+        if (ok == 0)
+            corpus_close(&c);
+    }
+    bench_sort(ns, OPENS);
+    printf("{\"bench\": \"corpus_open\", \"segments\": %llu, \"p50_us\": %.2f, \"p99_us\": %.2f}\n",
+           (unsigned long long)segments, bench_pct(ns, OPENS, 0.50) / 1000.0,
+           bench_pct(ns, OPENS, 0.99) / 1000.0);
+
+    Corpus c;
+    if (corpus_open(&c, path) != 0)
+        return;
+
+    long long points = 0;
+    for (int i = 0; i < PICKS; i++) {
+        double tx = rng_range(r, -400, 400), ty = rng_range(r, -400, 400);
+        long long t0 = bench_now_ns();
+        points += corpus_pick(&c, r, WIND_TARGET_POINTS, tx, ty, out_buf);
+        ns[i] = bench_now_ns() - t0;
+    }
+    corpus_close(&c);
+
+    bench_sort(ns, PICKS);
+    printf("{\"bench\": \"corpus_pick\", \"segments\": %llu, \"avg_points\": %.0f, "
+           "\"p50_us\": %.2f, \"p99_us\": %.2f}\n",
+           (unsigned long long)segments, (double)points / PICKS,
+           bench_pct(ns, PICKS, 0.50) / 1000.0, bench_pct(ns, PICKS, 0.99) / 1000.0);
+}
+
+int main(int argc, char *argv[]) {
+    long total = argc > 1 ? atol(argv[1]) : SEGMENTS;
+    if (total < 1) total = SEGMENTS;
+
+    char dir[] = "/tmp/jigglemil-bench-XXXXXX";
+    if (!mkdtemp(dir)) {
+        perror("bench_corpus: mkdtemp");
+        return 1;
+    }
+    char path[256];
+    snprintf(path, sizeof(path), "%s/corpus", dir);
+
+    CorpusWriter w;
+    if (corpus_writer_open(&w, path) != 0) {
+        perror("bench_corpus: open");
+        return 1;
+    }
+
+    Rng r;
+    rng_seed(&r, 42);
+    static long long ns[PICKS > OPENS ? PICKS : OPENS];
+
+    long long append_ns = 0, points = 0;
+    long next = 1000;
+    for (long n = 1; n <= total; n++) {
+        int count = synth_segment(&r);
+        long long t0 = bench_now_ns();
+        corpus_append(&w, seg_buf, count);
+        append_ns += bench_now_ns() - t0;
+        points += count;
+
+        if (n == next || n == total) {
+            measure(path, (uint64_t)n, &r, ns);
+            next *= 10;
+        }
+    }
+    corpus_writer_close(&w);
+
+    printf("{\"bench\": \"corpus_append\", \"segments\": %ld, \"points\": %lld, "
+           "\"segments_per_sec\": %.0f, \"file_mb\": %.1f}\n",
+           total, points, total / (append_ns / 1e9),
+           (sizeof(CorpusHeader) + total * sizeof(CorpusSegment) + points * sizeof(PackedPoint)) / 1048576.0);
+
+    unlink(path);
+    rmdir(dir);
+    return 0;
+}
@@ -0,0 +1,100 @@
+/*
+ * Evdev idle tracker benchmark
+ *
+ * Replays a synthetic 8 kHz mouse (REL_X + REL_Y + SYN per report) through
+ * a pipe into the evdev tracker and reports tracker CPU time per second.
+ * Like a real evdev node, the pipe drops events instead of blocking the
+ * "device" when the reader falls behind.
+ *
+ *   gcc -O2 -std=c11 -Wno-unused-function -Isrc bench/bench_evdev.c \
+ *       -ludev -lpthread -o bench_evdev
+ *   ./bench_evdev [seconds] [holdoff_ms]
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "config.h"
+#include "inject_common.h"
+#include "idle_detector_evdev.h"
+
+#define REPORT_HZ       8000
+#define TICK_US         1000
+#define REPORTS_PER_TICK (REPORT_HZ / (1000000 / TICK_US))
+
+static double thread_cpu_sec(pthread_t t) {
+    clockid_t cid;
+    struct timespec ts;
+    if (pthread_getcpuclockid(t, &cid) != 0 || clock_gettime(cid, &ts) != 0)
+        return 0;
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    int seconds = argc > 1 ? atoi(argv[1]) : 5;
+    if (argc > 2)
+        evdev_holdoff_ms = atol(argv[2]);
+
+    int p[2];
+    if (pipe2(p, O_NONBLOCK | O_CLOEXEC) < 0) {
+        perror("pipe2");
+        return 1;
+    }
+
+    if (evdev_idle_setup(-1, 0) < 0 || evdev_idle_add_fd(p[0], "pipe") < 0 ||
+        evdev_idle_start() < 0) {
+        fprintf(stderr, "bench_evdev: tracker setup failed\n");
+        return 1;
+    }
+
+    struct input_event tick[REPORTS_PER_TICK * 3];
+    long long written = 0, dropped = 0;
+
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    double cpu0 = thread_cpu_sec(evdev_thread);
+
+    for (long t = 0; t < (long)seconds * (1000000 / TICK_US); t++) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        int n = 0;
+        for (int r = 0; r < REPORTS_PER_TICK; r++) {
+            set_event(&tick[n], EV_REL, REL_X, 1);
+            set_event(&tick[n + 1], EV_REL, REL_Y, -1);
+            set_event(&tick[n + 2], EV_SYN, SYN_REPORT, 0);
+            for (int k = 0; k < 3; k++) {
+                tick[n + k].input_event_sec  = now.tv_sec;
+                tick[n + k].input_event_usec = now.tv_nsec / 1000;
+            }
+            n += 3;
+        }
+
+        ssize_t w = write(p[1], tick, sizeof(tick));
+        long ev = w > 0 ? (long)(w / sizeof(tick[0])) : 0;
+        written += ev;
+        dropped += n - ev;
+
+        next.tv_nsec += TICK_US * 1000l;
+        if (next.tv_nsec >= 1000000000l) {
+            next.tv_sec++;
+            next.tv_nsec -= 1000000000l;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+
+    double cpu = thread_cpu_sec(evdev_thread) - cpu0;
+
+    printf("{\"bench\": \"evdev_idle\", \"report_hz\": %d, \"seconds\": %d, "
+           "\"holdoff_ms\": %ld, \"events_offered\": %lld, \"events_dropped\": %lld, "
+           "\"tracker_cpu_ms_per_sec\": %.3f}\n",
+           REPORT_HZ, seconds, evdev_holdoff_ms,
+           written + dropped, dropped, cpu * 1000.0 / seconds);
+    return 0;
+}
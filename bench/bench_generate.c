@@ -0,0 +1,90 @@
+/*
+ * Path generator benchmark
+ *
+ * Times generate_wind_path() and the multi-candidate generator per path,
+ * bucketed by target distance (the WindMouse parameters themselves are
+ * drawn from their config.h ranges on every path). One JSON line per
+ * generator and distance: paths/s, points/s and p50/p99 per-path latency.
+ *
+ *   gcc -O2 -fno-math-errno -fno-trapping-math -std=c11 -Wno-unused-function \
+ *       -Isrc bench/bench_generate.c -lm -o bench_generate
+ *   ./bench_generate [paths_per_bucket]
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "config.h"
+#include "rng.h"
+#include "windmouse.h"
+#include "windmouse_multi.h"
+#include "bench_common.h"
+
+static const double distances[] = { 25, 100, 200, 400, 566 };
+#define DISTANCE_COUNT (sizeof(distances) / sizeof(distances[0]))
+
+static WindCandidates cand;
+
+static void report(const char *gen, double distance, long long *lat, int n,
+                   long long points, long long total_ns) {
+    bench_sort(lat, n);
+    printf("{\"bench\": \"generate\", \"generator\": \"%s\", \"distance_px\": %.0f, "
+           "\"paths\": %d, \"avg_points\": %.1f, \"paths_per_sec\": %.0f, "
+           "\"points_per_sec\": %.0f, \"p50_us\": %.2f, \"p99_us\": %.2f}\n",
+           gen, distance, n, (double)points / n,
+           n * 1e9 / total_ns, points * 1e9 / total_ns,
+           bench_pct(lat, n, 0.50) / 1000.0, bench_pct(lat, n, 0.99) / 1000.0);
+}
+
+int main(int argc, char *argv[]) {
+    int paths = argc > 1 ? atoi(argv[1]) : 2000;
+    if (paths < 1)
+        paths = 1;
+
+    long long *lat = malloc(sizeof(long long) * paths);
+    if (!lat)
+        return 1;
+
+    for (size_t d = 0; d < DISTANCE_COUNT; d++) {
+        Rng rng;
+
+        /* whole-path scalar generator */
+        rng_seed(&rng, 1);
+        long long points = 0, total = 0;
+        for (int i = 0; i < paths; i++) {
+            double a = rng_range(&rng, 0, 2 * M_PI);
+            uint64_t seed = rng_next(&rng);
+
+            long long t0 = bench_now_ns();
+            MousePath p = generate_wind_path(seed, distances[d] * cos(a), distances[d] * sin(a));
+            lat[i] = bench_now_ns() - t0;
+
+            total  += lat[i];
+            points += p.count;
+        }
+        report("windmouse", distances[d], lat, paths, points, total);
+
+        /* lockstep candidates, as wind_move_begin uses them */
+        rng_seed(&rng, 1);
+        points = total = 0;
+        for (int i = 0; i < paths; i++) {
+            double a = rng_range(&rng, 0, 2 * M_PI);
+            uint64_t seed = rng_next(&rng);
+
+            long long t0 = bench_now_ns();
+            int best = wind_candidates_generate(&cand, seed,
+                                                distances[d] * cos(a), distances[d] * sin(a));
+            lat[i] = bench_now_ns() - t0;
+
+            total  += lat[i];
+            points += cand.lanes.count[best];
+        }
+        report("candidates", distances[d], lat, paths, points, total);
+    }
+
+    free(lat);
+    return 0;
+}
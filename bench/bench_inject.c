@@ -0,0 +1,186 @@
+/*
+ * Injection benchmark
+ *
+ * Builds the daemon's own I/O layer (jigglemil.c, with main renamed) and
+ * measures per-point cost for each backend plus the playback executors:
+ *
+ *   ydotoold socket  - against a local mock ydotoold (bench/mock_ydotoold.h)
+ *   uinput           - writev() into a temporary file sink
+ *   CLI fallback     - fork/exec of ydotool (or of a missing binary)
+ *   batch / smooth   - play_path() on a synthetic path against the mock,
+ *                      woken by a seat's playback timer as in the daemon:
+ *                      deadline lateness and arrival drift per point
+ *
+ * One JSON line per measurement. Needs an idle backend to compile against:
+ *
+ *   gcc -O2 -fno-math-errno -fno-trapping-math -std=c11 -Wno-unused-function \
+ *       -Isrc -DHAVE_EVDEV_IDLE bench/bench_inject.c -lm -lpthread -ludev \
+ *       -o bench_inject
+ *   ./bench_inject [points]
+ */
+
+#define LOG_FILE   "/dev/null"
+#define STATE_FILE "/dev/null"
+#define PID_FILE   "/dev/null"
+
+#define main jigglemil_main
+#include "jigglemil.c"
+#undef main
+
+#include "bench_common.h"
+#include "mock_ydotoold.h"
+
+#define EXEC_POINTS     200     /* synthetic path length for the executors */
+#define EXEC_DELAY_US   2000    /* smooth-mode spacing of the synthetic path */
+#define CLI_CALLS       50
+
+/* the daemon's default seat: no device of its own, injects like the daemon */
+static Seat *bench_seat;
+static int bench_epfd = -1;
+
+static void report_calls(const char *backend, long long *ns, int n, int ok) {
+    bench_sort(ns, n);
+    printf("{\"bench\": \"inject\", \"backend\": \"%s\", \"calls\": %d, \"ok\": %d, "
+           "\"p50_us\": %.2f, \"p99_us\": %.2f, \"max_us\": %.2f}\n",
+           backend, n, ok, bench_pct(ns, n, 0.50) / 1000.0,
+           bench_pct(ns, n, 0.99) / 1000.0, ns[n - 1] / 1000.0);
+}
+
+static int time_calls(long long *ns, int n) {
+    int ok = 0;
+    for (int i = 0; i < n; i++) {
+        int d = (i & 1) ? -1 : 1;
+        long long t0 = bench_now_ns();
+        ok += inject_move(bench_seat, d, -d) == 0;
+        ns[i] = bench_now_ns() - t0;
+    }
+    return ok;
+}
+
+static int in_path(const char *name) {
+    const char *path = getenv("PATH");
+    char buf[512];
+    while (path && *path) {
+        const char *end = strchr(path, ':');
+        size_t len = end ? (size_t)(end - path) : strlen(path);
+        snprintf(buf, sizeof(buf), "%.*s/%s", (int)len, path, name);
+        if (access(buf, X_OK) == 0)
+            return 1;
+        path = end ? end + 1 : NULL;
+    }
+    return 0;
+}
+
+// ----------------------------
+// Executors: synthetic path through play_path, batch / smooth
+// ----------------------------
+static void bench_executor(const char *name, int smooth, PackedPoint *pts, int n,
+                           long long *scratch) {
+    SeatPlay *p = g_play[bench_seat->index];
+    stream_init_packed(&p->path, pts, n);
+
+    mock_ydotoold_reset();
+    g_smooth_mode = smooth;
+    play_path(bench_seat, p);
+    while (!play_path_tick(bench_seat, p)) {
+        struct epoll_event ev;
+        uint64_t val;
+        if (epoll_wait(bench_epfd, &ev, 1, -1) == 1 &&
+            read(bench_seat->play_fd, &val, sizeof(val)) < 0) { /* drained anyway */ }
+    }
+    play_path_end(bench_seat, p);
+    int got = mock_ydotoold_wait(n, 2000);
+    if (got > n)
+        got = n;
+
+    /* pacer wake-up lateness, straight from the executor */
+    for (int i = 0; i < n; i++)
+        scratch[i] = p->late_us[i] * 1000;
+    bench_sort(scratch, n);
+    double late_p50 = bench_pct(scratch, n, 0.50) / 1000.0;
+    double late_p99 = bench_pct(scratch, n, 0.99) / 1000.0;
+
+    /* arrival at the mock vs the planned offset from the first point */
+    long long planned = 0;
+    for (int i = 0; i < got; i++) {
+        long long drift = mock_recv_ns[i] - mock_recv_ns[0] - planned * 1000;
+        scratch[i] = drift < 0 ? -drift : drift;
+        planned += smooth ? pts[i].delay_us : 5000;
+    }
+    bench_sort(scratch, got);
+
+    printf("{\"bench\": \"executor\", \"executor\": \"%s\", \"points\": %d, \"received\": %d, "
+           "\"late_p50_us\": %.1f, \"late_p99_us\": %.1f, "
+           "\"drift_p50_us\": %.1f, \"drift_p99_us\": %.1f}\n",
+           name, n, got, late_p50, late_p99,
+           bench_pct(scratch, got, 0.50) / 1000.0, bench_pct(scratch, got, 0.99) / 1000.0);
+}
+
+int main(int argc, char *argv[]) {
+    int calls = argc > 1 ? atoi(argv[1]) : 20000;
+    if (calls < EXEC_POINTS)
+        calls = EXEC_POINTS;
+    if (calls > MOCK_MAX_POINTS)
+        calls = MOCK_MAX_POINTS;
+
+    long long *ns = malloc(sizeof(long long) * calls);
+    if (!ns)
+        return 1;
+
+    bench_epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (bench_epfd < 0 || !(bench_seat = seat_new(bench_epfd, "bench"))) {
+        fprintf(stderr, "bench_inject: seat setup failed\n");
+        return 1;
+    }
+
+    char sock[64], sink[64];
+    snprintf(sock, sizeof(sock), "/tmp/jigglemil-bench-%d.sock", (int)getpid());
+    snprintf(sink, sizeof(sink), "/tmp/jigglemil-bench-%d.ev", (int)getpid());
+
+    // --- ydotoold socket ---
+    if (mock_ydotoold_start(sock) != 0 || ydotool_connect(sock) != 0) {
+        fprintf(stderr, "bench_inject: mock ydotoold setup failed\n");
+        return 1;
+    }
+    long long send_ns0 = bench_now_ns();
+    int ok = time_calls(ns, calls);
+    int got = mock_ydotoold_wait(calls, 2000);
+    double wall_ms = (bench_now_ns() - send_ns0) / 1e6;
+    report_calls("ydotoold_socket", ns, calls, ok);
+    printf("{\"bench\": \"inject\", \"backend\": \"ydotoold_socket\", \"received\": %d, "
+           "\"events\": %ld, \"points_per_sec\": %.0f}\n",
+           got, atomic_load(&mock_events), got / (wall_ms / 1000.0));
+
+    // --- executors (socket backend) ---
+    PackedPoint pts[EXEC_POINTS];
+    for (int i = 0; i < EXEC_POINTS; i++) {
+        pts[i].dx = (i & 1) ? -1 : 1;
+        pts[i].dy = (i & 2) ? -1 : 1;
+        pts[i].delay_us = EXEC_DELAY_US;
+    }
+    bench_executor("batch", 0, pts, EXEC_POINTS, ns);
+    bench_executor("smooth", 1, pts, EXEC_POINTS, ns);
+
+    ydotool_disconnect();
+    mock_ydotoold_stop();
+
+    // --- uinput (file sink: same writev path, no device ioctls) ---
+    int fd = open(sink, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd >= 0)
+        close(fd);
+    if (uinput_open(sink) == 0) {
+        g_use_uinput = 1;
+        ok = time_calls(ns, calls);
+        report_calls("uinput_file", ns, calls, ok);
+        g_use_uinput = 0;
+        uinput_close();
+    }
+    unlink(sink);
+
+    // --- CLI fallback (no socket: every point forks) ---
+    ok = time_calls(ns, CLI_CALLS);
+    report_calls(in_path("ydotool") ? "cli_ydotool" : "cli_fork_only", ns, CLI_CALLS, ok);
+
+    free(ns);
+    return 0;
+}
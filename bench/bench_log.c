@@ -0,0 +1,180 @@
+/*
+ * Logging benchmark
+ *
+ * Compares the old synchronous log line (fopen/append/fclose per call)
+ * with the asynchronous ring logger (src/logger.h):
+ *
+ *   call      - cost of one log call as seen by the caller
+ *   playback  - pacer lateness over a paced synthetic path that logs one
+ *               line per point (none / sync / async), i.e. what logging
+ *               during playback does to the deadlines. Best of
+ *               PLAY_ROUNDS interleaved rounds per mode (scheduler noise
+ *               only ever adds lateness).
+ *
+ * Also a check: exits 1 if async logging adds more than PLAY_MARGIN_US to
+ * the playback p99, compared with the no-logging run of the same round,
+ * in every round. A cost of logging shows up in each round; a noisy
+ * machine does not make all of them fail. Logs go to a temporary
+ * directory. One JSON line per measurement:
+ *
+ *   gcc -O2 -std=c11 -Isrc bench/bench_log.c -lpthread -o bench_log
+ *   ./bench_log [points]
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "logger.h"
+#include "pacer.h"
+
+#include "bench_common.h"
+
+#define CALLS           20000
+#define PLAY_POINTS     500
+#define PLAY_DELAY_US   2000    /* smooth-mode spacing */
+#define PLAY_ROUNDS     5
+#define PLAY_MARGIN_US  500     /* async p99 may exceed the no-log p99 by this */
+
+typedef enum { MODE_NONE, MODE_SYNC, MODE_ASYNC } LogMode;
+
+static const char *const mode_names[] = { "none", "sync", "async" };
+
+static char sync_path[256];
+
+// The daemon's log_msg() before the logger thread existed
+static void log_sync(const char *fmt, int i, long late) {
+    time_t now = time(NULL);
+    struct tm tm;
+    char ts[16];
+    localtime_r(&now, &tm);
+    strftime(ts, sizeof(ts), "%H:%M:%S", &tm);
+
+    FILE *fp = fopen(sync_path, "a");
+    if (fp) {
+        fprintf(fp, "%s | ", ts);
+        fprintf(fp, fmt, i, late);
+        fputc('\n', fp);
+        fclose(fp);
+    }
+}
+
+static void log_line(LogMode mode, int i, long late) {
+    static const char fmt[] = "point %d: late %ld us";
+    if (mode == MODE_SYNC)
+        log_sync(fmt, i, late);
+    else if (mode == MODE_ASYNC)
+        log_write(LOG_INFO, fmt, i, late);
+}
+
+static void report(const char *bench, const char *mode, long long *ns, int n) {
+    bench_sort(ns, n);
+    printf("{\"bench\": \"%s\", \"mode\": \"%s\", \"n\": %d, "
+           "\"p50_us\": %.2f, \"p99_us\": %.2f, \"max_us\": %.2f}\n",
+           bench, mode, n, bench_pct(ns, n, 0.50) / 1000.0,
+           bench_pct(ns, n, 0.99) / 1000.0, ns[n - 1] / 1000.0);
+}
+
+static void bench_calls(LogMode mode, long long *ns) {
+    for (int i = 0; i < CALLS; i++) {
+        long long t0 = bench_now_ns();
+        log_line(mode, i, i & 127);
+        ns[i] = bench_now_ns() - t0;
+
+        /* stay within the ring, as the daemon does: drops are not a cost */
+        if (i % (LOG_RING_SLOTS / 2) == 0)
+            usleep(2000);
+    }
+    report("log_call", mode_names[mode], ns, CALLS);
+}
+
+// One round; returns its p99 lateness (ns), the samples are left sorted
+static long long play_round(LogMode mode, long long *ns, int points) {
+    Pacer pacer;
+    pacer_start(&pacer, NULL, 0);
+
+    for (int i = 0; i < points; i++) {
+        long late = pacer_wait(&pacer);
+        ns[i] = late * 1000ll;
+        log_line(mode, i, late);
+        pacer_advance(&pacer, PLAY_DELAY_US);
+    }
+    bench_sort(ns, points);
+    return bench_pct(ns, points, 0.99);
+}
+
+// Rounds of every mode in turn, so a noisy stretch hits them alike; reports
+// each mode's best round. Returns the smallest p99 excess (ns) of async
+// logging over no logging within one round.
+static long long bench_playback(long long *ns, long long *best, int points) {
+    long long best_p99[3] = { -1, -1, -1 };
+    long long min_excess = -1;
+
+    for (int r = 0; r < PLAY_ROUNDS; r++) {
+        long long p99[3];
+        for (LogMode m = MODE_NONE; m <= MODE_ASYNC; m++) {
+            p99[m] = play_round(m, ns, points);
+            if (best_p99[m] < 0 || p99[m] < best_p99[m]) {
+                best_p99[m] = p99[m];
+                memcpy(best + (size_t)m * points, ns, sizeof(long long) * points);
+            }
+        }
+        long long excess = p99[MODE_ASYNC] - p99[MODE_NONE];
+        if (r == 0 || excess < min_excess)
+            min_excess = excess;
+    }
+    for (LogMode m = MODE_NONE; m <= MODE_ASYNC; m++)
+        report("log_playback", mode_names[m], best + (size_t)m * points, points);
+    return min_excess;
+}
+
+int main(int argc, char *argv[]) {
+    int points = argc > 1 ? atoi(argv[1]) : PLAY_POINTS;
+    if (points < 1) points = PLAY_POINTS;
+
+    char dir[] = "/tmp/jigglemil-bench-XXXXXX";
+    if (!mkdtemp(dir)) {
+        perror("bench_log: mkdtemp");
+        return 1;
+    }
+    char async_path[256];
+    snprintf(sync_path, sizeof(sync_path), "%s/sync.log", dir);
+    snprintf(async_path, sizeof(async_path), "%s/async.log", dir);
+
+    long long *ns = malloc(sizeof(long long) * (CALLS > points ? CALLS : points));
+    long long *best = malloc(sizeof(long long) * 3 * points);
+    if (!ns || !best)
+        return 1;
+
+    if (logger_open(async_path, 1) != 0 || logger_start() != 0) {
+        perror("bench_log: logger");
+        return 1;
+    }
+
+    bench_calls(MODE_SYNC, ns);
+    bench_calls(MODE_ASYNC, ns);
+
+    long long excess = bench_playback(ns, best, points);
+
+    logger_stop();
+
+    int failed = excess > PLAY_MARGIN_US * 1000ll;
+    if (failed)
+        fprintf(stderr, "bench_log: async logging adds at least %.0f us to the playback "
+                        "p99 in every round (limit %d us)\n", excess / 1000.0, PLAY_MARGIN_US);
+
+    /* rotation may have produced async.log.1 .. .LOG_KEEP */
+    char path[300];
+    for (int i = 1; i <= LOG_KEEP; i++) {
+        snprintf(path, sizeof(path), "%s.%d", async_path, i);
+        unlink(path);
+    }
+    unlink(async_path);
+    unlink(sync_path);
+    rmdir(dir);
+    free(ns);
+    free(best);
+    return failed;
+}
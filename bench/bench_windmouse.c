@@ -0,0 +1,84 @@
+/*
+ * WindMouse generator benchmark
+ *
+ * Generates the same number of candidate paths with the scalar streaming
+ * generator (one WindState after another) and with the lockstep lanes of
+ * windmouse_multi.h, and reports paths per second for both.
+ *
+ *   gcc -O2 -fno-math-errno -fno-trapping-math -std=c11 -Wno-unused-function \
+ *       -Isrc bench/bench_windmouse.c -lm -o bench_windmouse
+ *   ./bench_windmouse [rounds]
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "config.h"
+#include "rng.h"
+#include "windmouse.h"
+#include "windmouse_multi.h"
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static WindCandidates cand;
+
+int main(int argc, char *argv[]) {
+    int rounds = argc > 1 ? atoi(argv[1]) : 2000;
+    Rng rng;
+    rng_seed(&rng, 1);
+
+    /* same targets for both runs */
+    double *tx = malloc(sizeof(double) * rounds);
+    double *ty = malloc(sizeof(double) * rounds);
+    if (!tx || !ty)
+        return 1;
+    for (int i = 0; i < rounds; i++) {
+        tx[i] = rng_range(&rng, -400, 400);
+        ty[i] = rng_range(&rng, -400, 400);
+    }
+
+    long long scalar_points = 0;
+    double t0 = now_sec();
+    for (int i = 0; i < rounds; i++) {
+        for (int l = 0; l < WIND_LANES; l++) {
+            WindState st;
+            PackedPoint p;
+            wind_init(&st, (uint64_t)i * WIND_LANES + l, tx[i], ty[i]);
+            while (wind_next(&st, &p))
+                ;
+            scalar_points += st.count;
+        }
+    }
+    double scalar_sec = now_sec() - t0;
+
+    long long lanes_points = 0;
+    int best_sum = 0;
+    t0 = now_sec();
+    for (int i = 0; i < rounds; i++) {
+        best_sum += wind_candidates_generate(&cand, (uint64_t)i, tx[i], ty[i]);
+        for (int l = 0; l < WIND_LANES; l++)
+            lanes_points += cand.lanes.count[l];
+    }
+    double lanes_sec = now_sec() - t0;
+
+    double paths = (double)rounds * WIND_LANES;
+    printf("{\"bench\": \"windmouse\", \"lanes\": %d, \"paths\": %.0f, "
+           "\"scalar_paths_per_sec\": %.0f, \"scalar_ns_per_point\": %.1f, "
+           "\"lanes_paths_per_sec\": %.0f, \"lanes_ns_per_point\": %.1f, "
+           "\"speedup\": %.2f, \"best_checksum\": %d}\n",
+           WIND_LANES, paths,
+           paths / scalar_sec, scalar_sec * 1e9 / scalar_points,
+           paths / lanes_sec, lanes_sec * 1e9 / lanes_points,
+           scalar_sec / lanes_sec, best_sum);
+
+    free(tx);
+    free(ty);
+    return 0;
+}
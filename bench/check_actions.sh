@@ -0,0 +1,175 @@
+#!/bin/bash
+
+# ============================================================================
+# JIGGLEMIL - Action choice check
+# Runs the daemon with FIFO seats and reads back what each one injected.
+# A "seen" seat's sink is a FIFO that tee copies into its own input and
+# into a file, so the seat notices its own actions; a "blind" seat's sink
+# is a plain file. Fails if:
+#
+#   - with --action auto, the seen seat does not settle on one key tap
+#     (MICRO_KEY press + release, no motion)
+#   - with --action auto, the blind seat does not try the key tap, then the
+#     jiggle, each missed, and fall back to the path
+#   - with --action jiggle, the seen seat's jiggle is not confirmed, or
+#     its moves do not sum to zero on both axes
+#
+# One JSON line (run.sh collects it).
+#
+#   bench/check_actions.sh
+#
+# Any idle backend will do, the seats bring their own inputs. CC, CFLAGS,
+# UDEV_LIBS and SYSTEMD_LIBS can be overridden from the environment.
+# ============================================================================
+
+set -e
+
+cd "$(dirname "$0")/.."
+
+CC="${CC:-gcc}"
+CFLAGS="${CFLAGS:--O2 -std=c11 -Wall -Wextra}"
+MICRO_KEY=185       # KEY_F15, config.h
+
+if [ -z "${UDEV_LIBS+x}" ] && pkg-config --exists libudev; then
+    UDEV_LIBS="$(pkg-config --cflags --libs libudev)"
+fi
+if [ -z "${SYSTEMD_LIBS+x}" ] && pkg-config --exists libsystemd; then
+    SYSTEMD_LIBS="$(pkg-config --cflags --libs libsystemd)"
+fi
+if [ -n "$UDEV_LIBS" ]; then
+    FLAGS="-DHAVE_EVDEV_IDLE $UDEV_LIBS"
+elif [ -n "$SYSTEMD_LIBS" ]; then
+    FLAGS="-DHAVE_GNOME_IDLE $SYSTEMD_LIBS"
+else
+    echo "check_actions: needs libudev or libsystemd" >&2
+    exit 77
+fi
+
+DIR="$(mktemp -d)"
+DAEMON_PID=""
+cleanup() {
+    [ -n "$DAEMON_PID" ] && kill "$DAEMON_PID" 2> /dev/null
+    rm -rf "$DIR"
+}
+trap cleanup EXIT
+
+echo "building jigglemil" >&2
+$CC $CFLAGS src/jigglemil.c -lm -lpthread $FLAGS -o "$DIR/jigglemil" >&2
+
+export XDG_RUNTIME_DIR="$DIR/run" XDG_CONFIG_HOME="$DIR/config"
+unset DBUS_SESSION_BUS_ADDRESS
+mkdir -p "$XDG_RUNTIME_DIR" "$XDG_CONFIG_HOME/jigglemil"
+chmod 700 "$XDG_RUNTIME_DIR"
+printf 'warning_limit_ms = 1000\nmin_action_ms = 2000\nmax_action_ms = 2500\n' \
+    > "$XDG_CONFIG_HOME/jigglemil/jigglemil.conf"
+LOG="$XDG_RUNTIME_DIR/jigglemil.log"
+
+fail() {
+    echo "check_actions: $*" >&2
+    exit 1
+}
+
+J="$DIR/jigglemil"
+
+# field SEAT NAME: one field of SEAT's status line
+field() {
+    "$J" --ctl "status $1" | sed -n "s/.*\"$2\": \"\{0,1\}\([^\",}]*\).*/\1/p"
+}
+
+# seen NAME: a seat whose injected events come back on its input, copied
+# to NAME.sink on the way (tee exits when the daemon closes the sink)
+seen() {
+    mkfifo "$DIR/$1.in" "$DIR/$1.out"
+    tee "$DIR/$1.sink" < "$DIR/$1.out" > "$DIR/$1.in" &
+    SEATS="$SEATS $1"
+    ARGS="$ARGS --seat $1:$DIR/$1.in:$DIR/$1.out"
+}
+
+# blind NAME: a seat whose injected events only land in NAME.sink
+blind() {
+    mkfifo "$DIR/$1.in"
+    : > "$DIR/$1.sink"
+    SEATS="$SEATS $1"
+    ARGS="$ARGS --seat $1:$DIR/$1.in:$DIR/$1.sink"
+}
+
+# run MODE: one daemon with the seats set up so far, until each has acted
+run() {
+    local mode="$1"
+    : > "$LOG"
+    # shellcheck disable=SC2086
+    "$J" --action "$mode" --seed 1 $ARGS > /dev/null 2>&1 &
+    DAEMON_PID=$!
+    local i s
+    for i in $(seq 50); do
+        "$J" --ctl ping > /dev/null 2>&1 && break
+        kill -0 "$DAEMON_PID" 2> /dev/null || fail "$mode: daemon did not start"
+        sleep 0.1
+    done
+    for s in $SEATS; do
+        for i in $(seq 150); do
+            [ "$(field "$s" actions)" -ge 1 ] && break
+            sleep 0.1
+        done
+        [ "$(field "$s" actions)" -ge 1 ] || fail "$mode: $s never acted"
+    done
+    "$J" --ctl stop > /dev/null
+    wait "$DAEMON_PID" || fail "$mode: daemon exited with $?"
+    DAEMON_PID=""
+    wait
+    SEATS=""
+    ARGS=""
+}
+
+# events NAME TYPE [CODE]: count and value sum of NAME's injected events
+# of that type (struct input_event, 64-bit time: type | code << 16, value)
+events() {
+    od -An -v -t d4 -w24 "$DIR/$1.sink" |
+        awk -v t="$2" -v c="${3:--1}" '
+            $5 % 65536 == t && (c < 0 || int($5 / 65536) == c) { n++; sum += $6 }
+            END { printf "%d %d\n", n, sum }'
+}
+
+# action SEAT TEXT: the seat logged its action as TEXT
+action() {
+    grep -q "\[$1\]     -> Action: $2" "$LOG" || fail "$1: no \"Action: $2\" in the log"
+}
+
+# --action auto: the key tap where it is noticed, the whole chain where not
+SEATS=""
+ARGS=""
+seen seen
+blind blind
+run auto
+action seen "key (idle reset in"
+! grep -q "\[seen\]     -> Action: .* did not reset idle" "$LOG" || fail "seen: a miss"
+# A press and a release per tap (it may tap again while the blind seat
+# works through its chain)
+read -r KEYS KEY_SUM <<< "$(events seen 1 "$MICRO_KEY")"
+[ "$KEYS" -gt 0 ] && [ "$KEYS" -eq $((2 * KEY_SUM)) ] ||
+    fail "seen: $KEYS key events, $KEY_SUM presses"
+read -r MOVES _ <<< "$(events seen 2)"
+[ "$MOVES" -eq 0 ] || fail "seen: $MOVES moves for a key tap"
+
+action blind "key did not reset idle"
+action blind "jiggle did not reset idle"
+action blind "path"
+read -r KEYS _ <<< "$(events blind 1 "$MICRO_KEY")"
+read -r MOVES _ <<< "$(events blind 2)"
+[ "$KEYS" -ge 2 ] && [ "$MOVES" -gt 0 ] || fail "blind: $KEYS key events, $MOVES moves"
+BLIND_MOVES=$MOVES
+
+# --action jiggle: out and back, confirmed
+rm -f "$DIR"/seen.*
+seen seen
+run jiggle
+action seen "jiggle (idle reset in"
+read -r KEYS _ <<< "$(events seen 1)"
+read -r X_MOVES X_SUM <<< "$(events seen 2 0)"
+read -r Y_MOVES Y_SUM <<< "$(events seen 2 1)"
+[ "$KEYS" -eq 0 ] || fail "jiggle: $KEYS key events"
+[ $((X_MOVES + Y_MOVES)) -gt 0 ] || fail "jiggle: no moves"
+[ "$X_SUM" -eq 0 ] && [ "$Y_SUM" -eq 0 ] || fail "jiggle: net move ($X_SUM, $Y_SUM)"
+
+printf '{"bench": "actions", "seen": "key", "blind": ["key", "jiggle", "path"], "blind_moves": %d, "jiggle_moves": %d, "jiggle_net": [%d, %d]}\n' \
+    "$BLIND_MOVES" $((X_MOVES + Y_MOVES)) "$X_SUM" "$Y_SUM"
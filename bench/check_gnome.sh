@@ -0,0 +1,186 @@
+#!/bin/bash
+
+# ============================================================================
+# JIGGLEMIL - GNOME idle backend check
+# Runs the daemon (--idle gnome, file sink for injection) against
+# bench/mock_mutter.c, a stub org.gnome.Mutter.IdleMonitor on a private
+# session bus. Fails if:
+#
+#   - the daemon does not pick the GNOME backend, or registers its idle
+#     watch at another interval than the warning threshold
+#   - GetIdletime does not reach --ctl status (red past the threshold,
+#     idle_ms restarting after activity)
+#   - the idle watch firing does not get a user-active watch registered
+#   - the user-active watch firing does not turn it green at once (the
+#     next deadline is seconds away, only WatchFired can do it)
+#   - a rejected AddUserActiveWatch is not retried on the next dispatch
+#   - a reload of warning_limit_ms does not replace the idle watch
+#
+# One JSON line (run.sh collects it).
+#
+#   bench/check_gnome.sh
+#
+# Needs dbus-daemon and libsystemd. CC, CFLAGS and SYSTEMD_LIBS can be
+# overridden from the environment.
+# ============================================================================
+
+set -e
+
+cd "$(dirname "$0")/.."
+
+CC="${CC:-gcc}"
+CFLAGS="${CFLAGS:--O2 -std=c11 -Wall -Wextra}"
+WARNING_MS=1000
+RELOAD_MS=2000
+
+if [ -z "${SYSTEMD_LIBS+x}" ] && pkg-config --exists libsystemd; then
+    SYSTEMD_LIBS="$(pkg-config --cflags --libs libsystemd)"
+fi
+if [ -z "$SYSTEMD_LIBS" ] || ! command -v dbus-daemon &> /dev/null; then
+    echo "check_gnome: needs libsystemd and dbus-daemon" >&2
+    exit 77
+fi
+
+DIR="$(mktemp -d)"
+BUS_PID=""
+MOCK_PID=""
+DAEMON_PID=""
+cleanup() {
+    [ -n "$DAEMON_PID" ] && kill "$DAEMON_PID" 2> /dev/null
+    [ -n "$MOCK_PID" ] && kill "$MOCK_PID" 2> /dev/null
+    [ -n "$BUS_PID" ] && kill "$BUS_PID" 2> /dev/null
+    rm -rf "$DIR"
+}
+trap cleanup EXIT
+
+echo "building jigglemil (GNOME) and mock_mutter" >&2
+$CC $CFLAGS -DHAVE_GNOME_IDLE src/jigglemil.c -lm -lpthread $SYSTEMD_LIBS -o "$DIR/jigglemil" >&2
+$CC $CFLAGS bench/mock_mutter.c $SYSTEMD_LIBS -o "$DIR/mock_mutter" >&2
+
+# The daemon under test: its own runtime / config dirs, a short warning
+# threshold and actions well after it
+export XDG_RUNTIME_DIR="$DIR/run" XDG_CONFIG_HOME="$DIR/config"
+unset WAYLAND_DISPLAY
+mkdir -p "$XDG_RUNTIME_DIR" "$XDG_CONFIG_HOME/jigglemil"
+chmod 700 "$XDG_RUNTIME_DIR"
+printf 'warning_limit_ms = %d\nmin_action_ms = 8000\nmax_action_ms = 9000\n' "$WARNING_MS" \
+    > "$XDG_CONFIG_HOME/jigglemil/jigglemil.conf"
+mkfifo "$DIR/commands"
+: > "$DIR/sink"
+
+fail() {
+    echo "check_gnome: $*" >&2
+    exit 1
+}
+
+J="$DIR/jigglemil"
+
+# field NAME: one field of the daemon's status line
+field() {
+    "$J" --ctl status | sed -n "s/.*\"$1\": \"\{0,1\}\([^\",}]*\).*/\1/p"
+}
+
+# wait_log PATTERN [TENTHS]: poll the mock's output, 2 s by default
+wait_log() {
+    local i
+    for i in $(seq "${2:-20}"); do
+        grep -q "$1" "$DIR/mock.log" && return 0
+        sleep 0.1
+    done
+    return 1
+}
+
+# wait_state EMOJI TENTHS: poll --ctl state
+wait_state() {
+    local i
+    for i in $(seq "$2"); do
+        [ "$("$J" --ctl state)" = "$1" ] && return 0
+        sleep 0.1
+    done
+    return 1
+}
+
+dbus-daemon --session --nofork --nopidfile --address="unix:path=$DIR/bus" &
+BUS_PID=$!
+export DBUS_SESSION_BUS_ADDRESS="unix:path=$DIR/bus"
+for i in $(seq 50); do
+    [ -S "$DIR/bus" ] && break
+    sleep 0.1
+done
+
+"$DIR/mock_mutter" < "$DIR/commands" > "$DIR/mock.log" &
+MOCK_PID=$!
+exec 3> "$DIR/commands"
+wait_log ready || fail "mock IdleMonitor did not start"
+
+"$J" --idle gnome --uinput --uinput-device "$DIR/sink" --action path > /dev/null 2>&1 &
+DAEMON_PID=$!
+for i in $(seq 50); do
+    "$J" --ctl ping > /dev/null 2>&1 && break
+    kill -0 "$DAEMON_PID" 2> /dev/null || fail "daemon did not start"
+    sleep 0.1
+done
+echo active >&3
+
+BACKEND="$(field idle_backend)"
+[ "$BACKEND" = "gnome" ] || fail "idle backend is '$BACKEND', expected gnome"
+wait_log "^idle-watch id=[0-9]* interval=$WARNING_MS$" || fail "no idle watch at $WARNING_MS ms"
+
+# round [reject]: idle past the threshold, then active again. With
+# "reject" the first AddUserActiveWatch fails and a status call (one
+# GetIdletime + dispatch) must retry it.
+ROUNDS=0
+WAKE_MS=0
+round() {
+    ROUNDS=$((ROUNDS + 1))
+    local fired_before active_before
+    fired_before="$(grep -c ' idle$' "$DIR/mock.log" || true)"
+    active_before="$(grep -c '^active-watch id=' "$DIR/mock.log" || true)"
+    [ "$1" = reject ] && echo "reject 1" >&3
+
+    wait_state 🔴 20 || fail "round $ROUNDS: not red past the threshold ($("$J" --ctl state))"
+    local idle
+    idle="$(field idle_ms)"
+    [ "$idle" -ge "$WARNING_MS" ] || fail "round $ROUNDS: idle_ms $idle while red"
+    for i in $(seq 20); do
+        [ "$(grep -c ' idle$' "$DIR/mock.log" || true)" -gt "$fired_before" ] && break
+        sleep 0.1
+    done
+    if [ "$1" = reject ]; then
+        wait_log "^active-watch rejected" || fail "round $ROUNDS: AddUserActiveWatch never tried"
+        field idle_ms > /dev/null
+    fi
+    for i in $(seq 20); do
+        [ "$(grep -c '^active-watch id=' "$DIR/mock.log" || true)" -gt "$active_before" ] && break
+        sleep 0.1
+    done
+    [ "$(grep -c '^active-watch id=' "$DIR/mock.log" || true)" -gt "$active_before" ] ||
+        fail "round $ROUNDS: no user-active watch registered after the idle watch fired"
+
+    local t0 t1
+    t0="$(date +%s%N)"
+    echo active >&3
+    wait_state 🟢 5 || fail "round $ROUNDS: WatchFired did not turn it green"
+    t1="$(date +%s%N)"
+    local ms=$(((t1 - t0) / 1000000))
+    [ "$ms" -gt "$WAKE_MS" ] && WAKE_MS=$ms
+    idle="$(field idle_ms)"
+    [ "$idle" -lt "$WARNING_MS" ] || fail "round $ROUNDS: idle_ms $idle after activity"
+}
+
+round
+round reject
+
+# Hot reload: the idle watch is removed and one at the new interval added
+IDLE_ID="$(sed -n "s/^idle-watch id=\([0-9]*\) interval=$WARNING_MS$/\1/p" "$DIR/mock.log" | head -n 1)"
+printf 'warning_limit_ms = %d\nmin_action_ms = 8000\nmax_action_ms = 9000\n' "$RELOAD_MS" \
+    > "$XDG_CONFIG_HOME/jigglemil/jigglemil.conf"
+wait_log "^idle-watch id=[0-9]* interval=$RELOAD_MS$" || fail "reload: no idle watch at $RELOAD_MS ms"
+grep -q "^remove id=$IDLE_ID$" "$DIR/mock.log" || fail "reload: idle watch $IDLE_ID kept"
+
+"$J" --ctl stop > /dev/null
+wait "$DAEMON_PID" || fail "daemon exited with $?"
+DAEMON_PID=""
+
+printf '{"bench": "gnome", "idle_watch_ms": %d, "rounds": %d, "rejected_retried": true, "max_wake_ms": %d, "reload_watch_ms": %d}\n' \
+    "$WARNING_MS" "$ROUNDS" "$WAKE_MS" "$RELOAD_MS"
@@ -0,0 +1,73 @@
+/*
+ * Generator golden check
+ *
+ * generate_wind_path() must turn a given seed and target into the same
+ * points, bit for bit, on every build and machine. --seed reproducibility
+ * and the recorded timelines of --simulate depend on it. Each case pins
+ * the point count and an FNV-1a hash over the packed points (dx, dy,
+ * delay_us little-endian), with the config.h defaults.
+ *
+ * A deliberate change to the generator, the PRNG or the default ranges
+ * updates the table in the same commit. Exits 1 on any mismatch. One JSON
+ * line per case:
+ *
+ *   gcc -O2 -fno-math-errno -fno-trapping-math -std=c11 -Wno-unused-function \
+ *       -Isrc bench/check_golden.c -lm -o check_golden
+ *   ./check_golden
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "windmouse.h"
+
+static const struct {
+    uint64_t seed;
+    double   target_x, target_y;
+    int      count;
+    uint64_t fnv1a;
+} cases[] = {
+    { 1,   100,  -50,  478, 0xd4739a060dfb5252ull },
+    { 42, -300,  250,  300, 0x5b6a6e67a9344af0ull },
+    { 9,   -20, -380, 1074, 0x4e64ea37312da93aull },
+    { 13, -250,  120, 1783, 0xd39f725339ec6215ull },    /* hits MAX_PATH_POINTS */
+    { 3,     5,    2,    0, 0x14650fb0739d0383ull },    /* starts inside the target radius */
+};
+
+#define CASE_COUNT (sizeof(cases) / sizeof(cases[0]))
+
+static uint64_t fnv1a_byte(uint64_t h, uint8_t b) {
+    return (h ^ b) * 1099511628211ull;
+}
+
+int main(void) {
+    int failed = 0;
+
+    for (size_t i = 0; i < CASE_COUNT; i++) {
+        MousePath p = generate_wind_path(cases[i].seed, cases[i].target_x, cases[i].target_y);
+
+        uint64_t h = 1469598103934665603ull;
+        for (int k = 0; k < p.count; k++) {
+            uint16_t delay = (uint16_t)p.points[k].delay_us;
+            h = fnv1a_byte(h, (uint8_t)(int8_t)p.points[k].dx);
+            h = fnv1a_byte(h, (uint8_t)(int8_t)p.points[k].dy);
+            h = fnv1a_byte(h, (uint8_t)(delay & 0xff));
+            h = fnv1a_byte(h, (uint8_t)(delay >> 8));
+        }
+
+        int ok = p.count == cases[i].count && h == cases[i].fnv1a;
+        printf("{\"bench\": \"golden\", \"seed\": %llu, \"target\": [%.0f, %.0f], "
+               "\"points\": %d, \"fnv1a\": \"%016llx\", \"ok\": %s}\n",
+               (unsigned long long)cases[i].seed, cases[i].target_x, cases[i].target_y,
+               p.count, (unsigned long long)h, ok ? "true" : "false");
+        if (!ok)
+            fprintf(stderr, "check_golden: seed %llu: expected %d points, %016llx\n",
+                    (unsigned long long)cases[i].seed, cases[i].count,
+                    (unsigned long long)cases[i].fnv1a);
+        failed |= !ok;
+    }
+    return failed;
+}
@@ -0,0 +1,164 @@
+#!/bin/bash
+
+# ============================================================================
+# JIGGLEMIL - logind parking check
+# Runs the daemon (HAVE_LOGIND, one FIFO seat) against bench/mock_logind.c
+# on a private dbus-daemon that stands in for the system bus
+# (DBUS_SYSTEM_BUS_ADDRESS). Drives the session through every park
+# reason and back. Fails if:
+#
+#   - PrepareForSleep(true), Lock, Active = false (PropertiesChanged with
+#     the value) or LockedHint = true (invalidated only) does not park it
+#     with that reason, or the matching signal does not resume it
+#   - a daemon started in an inactive session does not start parked
+#
+# "Parked" is read through --ctl: state ⏸ and the status line's reason.
+# One JSON line (run.sh collects it).
+#
+#   bench/check_logind.sh
+#
+# Needs dbus-daemon and libsystemd. CC, CFLAGS and SYSTEMD_LIBS can be
+# overridden from the environment.
+# ============================================================================
+
+set -e
+
+cd "$(dirname "$0")/.."
+
+CC="${CC:-gcc}"
+CFLAGS="${CFLAGS:--O2 -std=c11 -Wall -Wextra}"
+
+if [ -z "${SYSTEMD_LIBS+x}" ] && pkg-config --exists libsystemd; then
+    SYSTEMD_LIBS="$(pkg-config --cflags --libs libsystemd)"
+fi
+if [ -z "$SYSTEMD_LIBS" ] || ! command -v dbus-daemon &> /dev/null; then
+    echo "check_logind: needs libsystemd and dbus-daemon" >&2
+    exit 77
+fi
+
+DIR="$(mktemp -d)"
+BUS_PID=""
+MOCK_PID=""
+DAEMON_PID=""
+cleanup() {
+    [ -n "$DAEMON_PID" ] && kill "$DAEMON_PID" 2> /dev/null
+    [ -n "$MOCK_PID" ] && kill "$MOCK_PID" 2> /dev/null
+    [ -n "$BUS_PID" ] && kill "$BUS_PID" 2> /dev/null
+    rm -rf "$DIR"
+}
+trap cleanup EXIT
+
+# The GNOME backend only needs libsystemd; the seat brings its own input
+echo "building jigglemil (logind) and mock_logind" >&2
+$CC $CFLAGS -DHAVE_GNOME_IDLE -DHAVE_LOGIND src/jigglemil.c -lm -lpthread $SYSTEMD_LIBS \
+    -o "$DIR/jigglemil" >&2
+$CC $CFLAGS bench/mock_logind.c $SYSTEMD_LIBS -o "$DIR/mock_logind" >&2
+
+# The daemon under test: its own runtime / config dirs and one FIFO seat
+# nobody writes to; the warning limit is far away, so only logind moves it
+export XDG_RUNTIME_DIR="$DIR/run" XDG_CONFIG_HOME="$DIR/config"
+unset DBUS_SESSION_BUS_ADDRESS XDG_SESSION_ID
+mkdir -p "$XDG_RUNTIME_DIR" "$XDG_CONFIG_HOME"
+chmod 700 "$XDG_RUNTIME_DIR"
+mkfifo "$DIR/input" "$DIR/commands"
+: > "$DIR/sink"
+
+fail() {
+    echo "check_logind: $*" >&2
+    exit 1
+}
+
+J="$DIR/jigglemil"
+
+# field NAME: one field of the daemon's status line
+field() {
+    "$J" --ctl status | sed -n "s/.*\"$1\": \"\{0,1\}\([^\",}]*\).*/\1/p"
+}
+
+# wait_parked REASON|false: poll until the status line says so, 2 s at most
+wait_parked() {
+    local i
+    for i in $(seq 20); do
+        [ "$(field parked)" = "$1" ] && return 0
+        sleep 0.1
+    done
+    return 1
+}
+
+start_daemon() {
+    "$J" --seat check:"$DIR/input":"$DIR/sink" > /dev/null 2>&1 &
+    DAEMON_PID=$!
+    local i
+    for i in $(seq 50); do
+        "$J" --ctl ping > /dev/null 2>&1 && return 0
+        kill -0 "$DAEMON_PID" 2> /dev/null || fail "daemon did not start"
+        sleep 0.1
+    done
+    fail "daemon does not answer"
+}
+
+stop_daemon() {
+    "$J" --ctl stop > /dev/null
+    wait "$DAEMON_PID" || fail "daemon exited with $?"
+    DAEMON_PID=""
+}
+
+# The private "system" bus and logind on it
+dbus-daemon --session --nofork --nopidfile --address="unix:path=$DIR/bus" &
+BUS_PID=$!
+export DBUS_SYSTEM_BUS_ADDRESS="unix:path=$DIR/bus"
+for i in $(seq 50); do
+    [ -S "$DIR/bus" ] && break
+    sleep 0.1
+done
+
+"$DIR/mock_logind" < "$DIR/commands" > "$DIR/mock.log" &
+MOCK_PID=$!
+exec 3> "$DIR/commands"
+for i in $(seq 50); do
+    grep -q ready "$DIR/mock.log" && break
+    kill -0 "$MOCK_PID" 2> /dev/null || fail "mock logind did not start"
+    sleep 0.1
+done
+
+start_daemon
+for i in $(seq 20); do
+    grep -q "Session: /org/freedesktop/login1/session/c1" "$XDG_RUNTIME_DIR/jigglemil.log" && break
+    sleep 0.1
+done
+grep -q "Session: /org/freedesktop/login1/session/c1" "$XDG_RUNTIME_DIR/jigglemil.log" ||
+    fail "daemon did not find the stub session"
+wait_parked false || fail "parked at start: $(field parked)"
+
+# park COMMAND REASON UNDO: one park / resume round
+TRANSITIONS=0
+park() {
+    echo "$1" >&3
+    wait_parked "$2" || fail "$1: parked is '$(field parked)', expected $2"
+    [ "$("$J" --ctl state)" = "⏸" ] || fail "$1: state $("$J" --ctl state), expected ⏸"
+    echo "$3" >&3
+    wait_parked false || fail "$3: still parked ($(field parked))"
+    [ "$("$J" --ctl state)" != "⏸" ] || fail "$3: state still ⏸"
+    TRANSITIONS=$((TRANSITIONS + 2))
+}
+
+park "sleep 1"  sleep    "sleep 0"
+park "lock"     locked   "unlock"
+park "active 0" inactive "active 1"
+park "hint 1"   locked   "hint 0"
+stop_daemon
+
+# Started while another session is in front: parked from the first pass
+echo "active 0" >&3
+for i in $(seq 20); do
+    grep -q "^active 0 sent" "$DIR/mock.log" && break
+    sleep 0.1
+done
+start_daemon
+wait_parked inactive || fail "started inactive: parked is '$(field parked)'"
+echo "active 1" >&3
+wait_parked false || fail "started inactive: not resumed ($(field parked))"
+stop_daemon
+
+printf '{"bench": "logind", "transitions": %d, "reasons": ["sleep", "locked", "inactive"], "started_parked": true}\n' \
+    "$TRANSITIONS"
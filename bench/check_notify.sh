@@ -0,0 +1,172 @@
+#!/bin/bash
+
+# ============================================================================
+# JIGGLEMIL - Notification check
+# Starts and stops the daemon CYCLES times, pausing and resuming it
+# PAUSES times per run. Runs twice: over D-Bus, against bench/mock_notify.c
+# on a private session bus, and through the notify-send fallback, with a
+# stub notify-send on PATH. Fails if:
+#
+#   - a notification is lost
+#   - the daemon has a child left once its notifications are out
+#   - a notify-send child started with signals blocked
+#
+# One JSON line per mode (run.sh collects them).
+#
+#   bench/check_notify.sh [cycles] [pauses]
+#
+# Needs dbus-daemon and libsystemd. CC, CFLAGS and SYSTEMD_LIBS can be
+# overridden from the environment.
+# ============================================================================
+
+set -e
+
+cd "$(dirname "$0")/.."
+
+CYCLES="${1:-10}"
+PAUSES="${2:-5}"
+
+CC="${CC:-gcc}"
+CFLAGS="${CFLAGS:--O2 -std=c11 -Wall -Wextra}"
+
+if [ -z "${SYSTEMD_LIBS+x}" ] && pkg-config --exists libsystemd; then
+    SYSTEMD_LIBS="$(pkg-config --cflags --libs libsystemd)"
+fi
+if [ -z "$SYSTEMD_LIBS" ] || ! command -v dbus-daemon &> /dev/null; then
+    echo "check_notify: needs libsystemd and dbus-daemon" >&2
+    exit 77
+fi
+
+DIR="$(mktemp -d)"
+BUS_PID=""
+MOCK_PID=""
+cleanup() {
+    [ -n "$MOCK_PID" ] && kill "$MOCK_PID" 2> /dev/null
+    [ -n "$BUS_PID" ] && kill "$BUS_PID" 2> /dev/null
+    rm -rf "$DIR"
+}
+trap cleanup EXIT
+
+# The GNOME backend is there to need nothing beyond libsystemd; the seat
+# below brings its own input, so it is never used
+echo "building jigglemil (D-Bus and notify-send)" >&2
+$CC $CFLAGS -DHAVE_GNOME_IDLE -DHAVE_DBUS_NOTIFY src/jigglemil.c -lm -lpthread $SYSTEMD_LIBS \
+    -o "$DIR/jigglemil_dbus" >&2
+$CC $CFLAGS -DHAVE_GNOME_IDLE src/jigglemil.c -lm -lpthread $SYSTEMD_LIBS -o "$DIR/jigglemil_fork" >&2
+$CC $CFLAGS bench/mock_notify.c $SYSTEMD_LIBS -o "$DIR/mock_notify" >&2
+
+# The daemon under test: its own runtime / config dirs and one FIFO seat
+# that nobody writes to (it stays idle well below the warning limit)
+export XDG_RUNTIME_DIR="$DIR/run" XDG_CONFIG_HOME="$DIR/config"
+mkdir -p "$XDG_RUNTIME_DIR" "$XDG_CONFIG_HOME"
+chmod 700 "$XDG_RUNTIME_DIR"
+mkfifo "$DIR/input"
+: > "$DIR/sink"
+
+FAILED=0
+fail() {
+    echo "check_notify: $*" >&2
+    FAILED=1
+}
+
+# children PID: child processes of PID, zombies included
+children() {
+    ps --ppid "$1" -o pid= | wc -l
+}
+
+# cycle BINARY: one start / pause+resume x PAUSES / stop run
+cycle() {
+    local j="$1"
+    "$j" --seat check:"$DIR/input":"$DIR/sink" > /dev/null 2>&1 &
+    local pid=$!
+
+    local i
+    for i in $(seq 50); do
+        "$j" --ctl ping > /dev/null 2>&1 && break
+        kill -0 "$pid" 2> /dev/null || { echo "check_notify: daemon did not start" >&2; exit 1; }
+        sleep 0.1
+    done
+    for i in $(seq "$PAUSES"); do
+        "$j" --ctl pause > /dev/null
+        "$j" --ctl resume > /dev/null
+    done
+
+    # every helper exits at once; give the main loop time to reap them
+    for i in $(seq 20); do
+        [ "$(children "$pid")" -eq 0 ] && break
+        sleep 0.1
+    done
+    local left
+    left="$(children "$pid")"
+    LEFT=$((LEFT + left))
+
+    "$j" --ctl stop > /dev/null
+    wait "$pid" || fail "daemon exited with $?"
+}
+
+EXPECTED=$((CYCLES * (2 * PAUSES + 2)))     # Running, pause/resume pairs, Stopped
+
+# ----------------------------------------------------------------------------
+# D-Bus
+# ----------------------------------------------------------------------------
+dbus-daemon --session --nofork --nopidfile --address="unix:path=$DIR/bus" &
+BUS_PID=$!
+export DBUS_SESSION_BUS_ADDRESS="unix:path=$DIR/bus"
+for i in $(seq 50); do
+    [ -S "$DIR/bus" ] && break
+    sleep 0.1
+done
+
+"$DIR/mock_notify" > "$DIR/dbus.log" &
+MOCK_PID=$!
+for i in $(seq 50); do
+    grep -q ready "$DIR/dbus.log" && break
+    sleep 0.1
+done
+
+LEFT=0
+for c in $(seq "$CYCLES"); do
+    cycle "$DIR/jigglemil_dbus"
+done
+sleep 0.2
+
+CALLS="$(grep -c '^notify' "$DIR/dbus.log" || true)"
+NEW="$(grep -c '^notify replaces=0 ' "$DIR/dbus.log" || true)"
+[ "$CALLS" -eq "$EXPECTED" ] || fail "dbus: $CALLS notifications, expected $EXPECTED"
+[ "$LEFT" -eq 0 ] || fail "dbus: $LEFT children left"
+printf '{"bench": "notify", "mode": "dbus", "cycles": %d, "notifications": %d, "new_popups": %d, "children_left": %d}\n' \
+    "$CYCLES" "$CALLS" "$NEW" "$LEFT"
+
+kill "$MOCK_PID" "$BUS_PID"
+wait "$MOCK_PID" "$BUS_PID" 2> /dev/null || true
+MOCK_PID=""
+BUS_PID=""
+
+# ----------------------------------------------------------------------------
+# notify-send fallback (no session bus)
+# ----------------------------------------------------------------------------
+unset DBUS_SESSION_BUS_ADDRESS
+mkdir -p "$DIR/bin"
+cat > "$DIR/bin/notify-send" << EOF
+#!/bin/sh
+echo "\$(grep SigBlk /proc/\$\$/status | cut -f2) \$*" >> "$DIR/fork.log"
+EOF
+chmod +x "$DIR/bin/notify-send"
+: > "$DIR/fork.log"
+
+LEFT=0
+PATH="$DIR/bin:$PATH"
+for c in $(seq "$CYCLES"); do
+    cycle "$DIR/jigglemil_fork"
+done
+sleep 0.2
+
+CALLS="$(wc -l < "$DIR/fork.log")"
+BLOCKED="$(grep -vc '^0000000000000000 ' "$DIR/fork.log" || true)"
+[ "$CALLS" -eq "$EXPECTED" ] || fail "notify-send: $CALLS notifications, expected $EXPECTED"
+[ "$LEFT" -eq 0 ] || fail "notify-send: $LEFT children left"
+[ "$BLOCKED" -eq 0 ] || fail "notify-send: $BLOCKED children started with signals blocked"
+printf '{"bench": "notify", "mode": "notify-send", "cycles": %d, "notifications": %d, "blocked_signals": %d, "children_left": %d}\n' \
+    "$CYCLES" "$CALLS" "$BLOCKED" "$LEFT"
+
+exit $FAILED
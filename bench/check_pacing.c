@@ -0,0 +1,121 @@
+/*
+ * Path pacing check
+ *
+ * A played path must take as long as its delays say, whatever happens in
+ * between. Every point is due at start + the sum of the delays before it
+ * (pacer.h), so a late wakeup, a slow injection or a stall delays that one
+ * point and the next ones catch up. Sleeping "delay_us after the last
+ * point" instead would add every overshoot to the path's duration.
+ *
+ * Each path is synthetic: POINTS points with random delays, injected into
+ * a file sink through the uinput backend as the daemon does, with two
+ * STALL_US stalls in the middle. Exits 1 if a path:
+ *
+ *   - ends before its planned duration
+ *   - ends more than PACE_MARGIN_US after its last point was due
+ *     (drift from earlier points, stalls included)
+ *   - ends more than PACE_BOUND_US after its planned duration
+ *     (drift plus the lateness of the last wakeup)
+ *
+ * One JSON line:
+ *
+ *   gcc -O2 -std=c11 -Wno-unused-function -Isrc bench/check_pacing.c -lm -o check_pacing
+ *   ./check_pacing [paths]
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "rng.h"
+#include "windmouse.h"
+#include "pacer.h"
+#include "inject_uinput.h"
+
+#define PATHS           3
+#define POINTS          400
+#define MIN_STEP_US     1000
+#define MAX_STEP_US     5000
+#define STALL_US        20000       /* e.g. a log flush or a slow write */
+#define PACE_MARGIN_US  1000
+#define PACE_BOUND_US   30000
+
+static long late_us[POINTS];
+
+static long long now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts_us(&ts);
+}
+
+int main(int argc, char *argv[]) {
+    int paths = argc > 1 ? atoi(argv[1]) : PATHS;
+    if (paths < 1)
+        paths = PATHS;
+
+    char sink[] = "/tmp/check_pacing.XXXXXX";
+    int tmp = mkstemp(sink);
+    if (tmp < 0) {
+        perror("check_pacing: mkstemp");
+        return 1;
+    }
+    close(tmp);
+
+    int is_device;
+    int fd = uinput_create(sink, "check_pacing", &is_device);
+    unlink(sink);
+    if (fd < 0) {
+        perror("check_pacing: sink");
+        return 1;
+    }
+
+    Rng rng;
+    rng_seed(&rng, 3);
+    int failed = 0;
+    long worst_excess = 0, worst_drift = 0;
+
+    for (int i = 0; i < paths; i++) {
+        PackedPoint pts[POINTS];
+        long planned_us = 0;
+        for (int k = 0; k < POINTS; k++) {
+            pts[k].dx = (int8_t)rng_range(&rng, -5, 5);
+            pts[k].dy = (int8_t)rng_range(&rng, -5, 5);
+            pts[k].delay_us = (uint16_t)rng_range(&rng, MIN_STEP_US, MAX_STEP_US);
+            if (k < POINTS - 1)
+                planned_us += pts[k].delay_us;      /* the last delay is never waited */
+        }
+
+        long long t0 = now_us();
+        Pacer pacer;
+        pacer_start(&pacer, late_us, POINTS);
+        for (int k = 0; k < POINTS; k++) {
+            pacer_wait(&pacer);
+            if (uinput_move_to(fd, pts[k].dx, pts[k].dy) < 0) {
+                perror("check_pacing: write");
+                return 1;
+            }
+            if (k == POINTS / 3 || k == 2 * POINTS / 3)
+                usleep(STALL_US);
+            pacer_advance(&pacer, pts[k].delay_us);
+        }
+        long excess = (long)(now_us() - t0) - planned_us;
+        long drift  = excess - late_us[POINTS - 1];
+
+        if (excess < 0 || drift > PACE_MARGIN_US || excess > PACE_BOUND_US) {
+            fprintf(stderr, "check_pacing: path %d: planned %ld us, %ld us over "
+                    "(last point %ld us late)\n", i, planned_us, excess, late_us[POINTS - 1]);
+            failed = 1;
+        }
+        if (excess > worst_excess) worst_excess = excess;
+        if (drift > worst_drift)   worst_drift = drift;
+    }
+    uinput_destroy(fd, is_device);
+
+    printf("{\"bench\": \"pacing_check\", \"paths\": %d, \"points\": %d, \"stalls_us\": %d, "
+           "\"max_over_plan_us\": %ld, \"max_drift_us\": %ld, \"ok\": %s}\n",
+           paths, POINTS, 2 * STALL_US, worst_excess, worst_drift, failed ? "false" : "true");
+    return failed;
+}
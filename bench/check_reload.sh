@@ -0,0 +1,142 @@
+#!/bin/bash
+
+# ============================================================================
+# JIGGLEMIL - Config hot reload check
+# Runs the daemon with one FIFO seat whose sink is its own input (it sees
+# its own key taps) and rewrites the config file while the seat waits for
+# its deadline. min_action_ms and max_action_ms one apart pin each drawn
+# deadline. Fails if:
+#
+#   - the reload is not logged, or the pending deadline is redrawn from the
+#     new range (next_action_ms jumps instead of counting down, the action
+#     comes late)
+#   - the deadline drawn after that action is not from the new range
+#   - an invalid file (min_action_ms above max_action_ms) is not rejected
+#     with the current settings kept
+#
+# One JSON line (run.sh collects it).
+#
+#   bench/check_reload.sh
+#
+# Any idle backend will do, the seat brings its own input. CC, CFLAGS,
+# UDEV_LIBS and SYSTEMD_LIBS can be overridden from the environment.
+# ============================================================================
+
+set -e
+
+cd "$(dirname "$0")/.."
+
+CC="${CC:-gcc}"
+CFLAGS="${CFLAGS:--O2 -std=c11 -Wall -Wextra}"
+WARNING_MS=1000
+OLD_ACTION_MS=4000
+NEW_ACTION_MS=7000
+
+if [ -z "${UDEV_LIBS+x}" ] && pkg-config --exists libudev; then
+    UDEV_LIBS="$(pkg-config --cflags --libs libudev)"
+fi
+if [ -z "${SYSTEMD_LIBS+x}" ] && pkg-config --exists libsystemd; then
+    SYSTEMD_LIBS="$(pkg-config --cflags --libs libsystemd)"
+fi
+if [ -n "$UDEV_LIBS" ]; then
+    FLAGS="-DHAVE_EVDEV_IDLE $UDEV_LIBS"
+elif [ -n "$SYSTEMD_LIBS" ]; then
+    FLAGS="-DHAVE_GNOME_IDLE $SYSTEMD_LIBS"
+else
+    echo "check_reload: needs libudev or libsystemd" >&2
+    exit 77
+fi
+
+DIR="$(mktemp -d)"
+DAEMON_PID=""
+cleanup() {
+    [ -n "$DAEMON_PID" ] && kill "$DAEMON_PID" 2> /dev/null
+    rm -rf "$DIR"
+}
+trap cleanup EXIT
+
+echo "building jigglemil" >&2
+$CC $CFLAGS src/jigglemil.c -lm -lpthread $FLAGS -o "$DIR/jigglemil" >&2
+
+export XDG_RUNTIME_DIR="$DIR/run" XDG_CONFIG_HOME="$DIR/config"
+unset DBUS_SESSION_BUS_ADDRESS
+mkdir -p "$XDG_RUNTIME_DIR" "$XDG_CONFIG_HOME/jigglemil"
+chmod 700 "$XDG_RUNTIME_DIR"
+CONF="$XDG_CONFIG_HOME/jigglemil/jigglemil.conf"
+LOG="$XDG_RUNTIME_DIR/jigglemil.log"
+mkfifo "$DIR/input"
+
+# config MIN MAX: write the file in one rename, the way editors save
+config() {
+    printf 'warning_limit_ms = %d\nmin_action_ms = %d\nmax_action_ms = %d\n' \
+        "$WARNING_MS" "$1" "$2" > "$CONF.new"
+    mv "$CONF.new" "$CONF"
+}
+
+fail() {
+    echo "check_reload: $*" >&2
+    exit 1
+}
+
+J="$DIR/jigglemil"
+
+# field NAME: one field of the daemon's status line
+field() {
+    "$J" --ctl status | sed -n "s/.*\"$1\": \"\{0,1\}\([^\",}]*\).*/\1/p"
+}
+
+# wait_log PATTERN: poll the daemon's log (written by its logger thread)
+wait_log() {
+    local i
+    for i in $(seq 20); do
+        grep -q "$1" "$LOG" 2> /dev/null && return 0
+        sleep 0.1
+    done
+    return 1
+}
+
+config "$OLD_ACTION_MS" $((OLD_ACTION_MS + 1))
+"$J" --action key --seat check:"$DIR/input":"$DIR/input" > /dev/null 2>&1 &
+DAEMON_PID=$!
+for i in $(seq 50); do
+    "$J" --ctl ping > /dev/null 2>&1 && break
+    kill -0 "$DAEMON_PID" 2> /dev/null || fail "daemon did not start"
+    sleep 0.1
+done
+
+# Red, the old deadline pending: the new range must not touch it
+sleep 1.5
+BEFORE="$(field next_action_ms)"
+config "$NEW_ACTION_MS" $((NEW_ACTION_MS + 1))
+wait_log "Config: reloaded" || fail "reload not logged"
+AFTER="$(field next_action_ms)"
+[ "$AFTER" -le "$BEFORE" ] || fail "deadline redrawn: next_action_ms $BEFORE -> $AFTER"
+T0="$(date +%s%N)"
+
+# The action at the old deadline, its key tap seen on the seat's input
+for i in $(seq 60); do
+    [ "$(field actions)" -ge 1 ] && break
+    sleep 0.1
+done
+[ "$(field actions)" -ge 1 ] || fail "no action at the old deadline"
+LATE_MS=$((($(date +%s%N) - T0) / 1000000 - AFTER))
+[ "$LATE_MS" -lt 1000 ] || fail "action ${LATE_MS} ms past the old deadline"
+
+# The next deadline comes from the new range
+wait_log "Next trigger: $((NEW_ACTION_MS / 1000))s" || fail "next deadline not from the new range"
+NEXT="$(field next_action_ms)"
+[ "$NEXT" -gt "$OLD_ACTION_MS" ] || fail "next_action_ms $NEXT after the action"
+
+# An invalid file is rejected, the deadline stays
+config 9000 8000
+wait_log "keeping the current settings" || fail "invalid file not rejected"
+KEPT="$(field next_action_ms)"
+[ "$KEPT" -le "$NEXT" ] || fail "rejected file moved the deadline: $NEXT -> $KEPT"
+[ "$(field actions)" -eq 1 ] || fail "extra action after the rejected file"
+
+"$J" --ctl stop > /dev/null
+wait "$DAEMON_PID" || fail "daemon exited with $?"
+DAEMON_PID=""
+
+printf '{"bench": "reload", "next_action_ms_before": %d, "next_action_ms_after": %d, "late_ms": %d, "next_limit_ms": %d, "rejected_kept": true}\n' \
+    "$BEFORE" "$AFTER" "$LATE_MS" "$NEW_ACTION_MS"
@@ -0,0 +1,149 @@
+#!/bin/bash
+
+# ============================================================================
+# JIGGLEMIL - Multi-seat check
+# Runs one daemon with three FIFO seats (--seat NAME:FIFO:SINK, file sinks,
+# --status-page) and writes input_events into the first seat's FIFO only.
+# Short thresholds from a config file let the others go red and act within
+# seconds. Fails if:
+#
+#   - the fed seat is not green, or an idle one not red, per --ctl state
+#   - a seat has no state file or status page of its own in
+#     $XDG_RUNTIME_DIR, or --peek SEAT disagrees with the daemon
+#   - the fed seat acts, or an idle seat does not act on its own deadline
+#     (its own next_action_ms, its own sink, its own action count)
+#
+# One JSON line (run.sh collects it).
+#
+#   bench/check_seats.sh
+#
+# Any idle backend will do, the seats bring their own inputs. CC, CFLAGS,
+# UDEV_LIBS and SYSTEMD_LIBS can be overridden from the environment.
+# ============================================================================
+
+set -e
+
+cd "$(dirname "$0")/.."
+
+CC="${CC:-gcc}"
+CFLAGS="${CFLAGS:--O2 -std=c11 -Wall -Wextra}"
+WARNING_MS=1000
+MIN_ACTION_MS=3000
+MAX_ACTION_MS=4000
+
+if [ -z "${UDEV_LIBS+x}" ] && pkg-config --exists libudev; then
+    UDEV_LIBS="$(pkg-config --cflags --libs libudev)"
+fi
+if [ -z "${SYSTEMD_LIBS+x}" ] && pkg-config --exists libsystemd; then
+    SYSTEMD_LIBS="$(pkg-config --cflags --libs libsystemd)"
+fi
+if [ -n "$UDEV_LIBS" ]; then
+    FLAGS="-DHAVE_EVDEV_IDLE $UDEV_LIBS"
+elif [ -n "$SYSTEMD_LIBS" ]; then
+    FLAGS="-DHAVE_GNOME_IDLE $SYSTEMD_LIBS"
+else
+    echo "check_seats: needs libudev or libsystemd" >&2
+    exit 77
+fi
+
+DIR="$(mktemp -d)"
+DAEMON_PID=""
+FEED_PID=""
+cleanup() {
+    [ -n "$FEED_PID" ] && kill "$FEED_PID" 2> /dev/null
+    [ -n "$DAEMON_PID" ] && kill "$DAEMON_PID" 2> /dev/null
+    rm -rf "$DIR"
+}
+trap cleanup EXIT
+
+echo "building jigglemil" >&2
+$CC $CFLAGS src/jigglemil.c -lm -lpthread $FLAGS -o "$DIR/jigglemil" >&2
+
+export XDG_RUNTIME_DIR="$DIR/run" XDG_CONFIG_HOME="$DIR/config"
+unset DBUS_SESSION_BUS_ADDRESS
+mkdir -p "$XDG_RUNTIME_DIR" "$XDG_CONFIG_HOME/jigglemil"
+chmod 700 "$XDG_RUNTIME_DIR"
+printf 'warning_limit_ms = %d\nmin_action_ms = %d\nmax_action_ms = %d\n' \
+    "$WARNING_MS" "$MIN_ACTION_MS" "$MAX_ACTION_MS" > "$XDG_CONFIG_HOME/jigglemil/jigglemil.conf"
+
+SEATS="busy idle1 idle2"
+ARGS=""
+for s in $SEATS; do
+    mkfifo "$DIR/$s.in"
+    : > "$DIR/$s.out"
+    ARGS="$ARGS --seat $s:$DIR/$s.in:$DIR/$s.out"
+done
+
+fail() {
+    echo "check_seats: $*" >&2
+    exit 1
+}
+
+J="$DIR/jigglemil"
+
+# field SEAT NAME: one field of SEAT's status line
+field() {
+    "$J" --ctl "status $1" | sed -n "s/.*\"$2\": \"\{0,1\}\([^\",}]*\).*/\1/p"
+}
+
+# shellcheck disable=SC2086
+"$J" --action path --status-page --seed 1 $ARGS > /dev/null 2>&1 &
+DAEMON_PID=$!
+for i in $(seq 50); do
+    "$J" --ctl ping > /dev/null 2>&1 && break
+    kill -0 "$DAEMON_PID" 2> /dev/null || fail "daemon did not start"
+    sleep 0.1
+done
+
+# One REL_X event (struct input_event, 64-bit time) every 200 ms into the
+# busy seat's FIFO, from one writer kept open (EOF would drop the input)
+EVENT='\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x02\x00\x00\x00\x01\x00\x00\x00'
+exec 4> "$DIR/busy.in"
+while :; do printf "$EVENT"; sleep 0.2; done >&4 &
+FEED_PID=$!
+
+# Past the warning threshold (1 s), before any deadline (3-4 s)
+sleep 1.5
+[ "$("$J" --ctl "state busy")" = "🟢" ] || fail "busy: state $("$J" --ctl "state busy"), expected 🟢"
+BUSY_IDLE="$(field busy idle_ms)"
+[ "$BUSY_IDLE" -lt "$WARNING_MS" ] || fail "busy: idle_ms $BUSY_IDLE"
+NEXT=""
+for s in idle1 idle2; do
+    [ "$("$J" --ctl "state $s")" = "🔴" ] || fail "$s: state $("$J" --ctl "state $s"), expected 🔴"
+    next="$(field "$s" next_action_ms)"
+    [ "$next" -gt 0 ] && [ "$next" -lt "$MAX_ACTION_MS" ] || fail "$s: next_action_ms $next"
+    NEXT="$NEXT${NEXT:+, }$next"
+done
+
+# Every seat's own files, and --peek SEAT reading that seat's page
+for s in $SEATS; do
+    [ -f "$XDG_RUNTIME_DIR/jigglemil.$s.state" ] || fail "$s: no state file"
+    [ -f "$XDG_RUNTIME_DIR/jigglemil.$s.status" ] || fail "$s: no status page"
+    want="$("$J" --ctl "state $s")"
+    [ "$(cat "$XDG_RUNTIME_DIR/jigglemil.$s.state")" = "$want" ] || fail "$s: state file disagrees"
+    "$J" --peek "$s" | grep -q "^{\"seat\": \"$s\", \"state\": \"[a-z]*\", \"emoji\": \"$want\"" ||
+        fail "$s: --peek $s: $("$J" --peek "$s")"
+done
+[ "$("$J" --peek | wc -l)" -eq 3 ] || fail "--peek: not one line per seat"
+
+# Past every deadline and its path: the idle seats acted into their own
+# sinks, the busy one never did
+sleep 5
+[ "$(field busy actions)" -eq 0 ] || fail "busy: acted while fed"
+[ ! -s "$DIR/busy.out" ] || fail "busy: injected while fed"
+ACTIONS=""
+for s in idle1 idle2; do
+    n="$(field "$s" actions)"
+    [ "$n" -ge 1 ] || fail "$s: no action past its deadline"
+    [ -s "$DIR/$s.out" ] || fail "$s: nothing in its sink"
+    ACTIONS="$ACTIONS${ACTIONS:+, }$n"
+done
+
+kill "$FEED_PID"
+FEED_PID=""
+"$J" --ctl stop > /dev/null
+wait "$DAEMON_PID" || fail "daemon exited with $?"
+DAEMON_PID=""
+
+printf '{"bench": "seats", "seats": 3, "busy_idle_ms": %d, "idle_next_action_ms": [%s], "busy_actions": 0, "idle_actions": [%s]}\n' \
+    "$BUSY_IDLE" "$NEXT" "$ACTIONS"
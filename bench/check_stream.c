@@ -0,0 +1,90 @@
+/*
+ * Streaming generator check
+ *
+ * A path played through a PathStream must be the path generate_wind_path()
+ * returns for the same seed and target: same points, same order, same
+ * delays. This must hold however the ring is topped up. The daemon refills
+ * between injections, whenever it has time, so each path here is popped
+ * with a random refill pattern:
+ *
+ *   - stream_fill() after a random number of pops (0 = every pop)
+ *   - sometimes several fills in a row
+ *   - long stretches without any, where stream_pop() generates on demand
+ *
+ * Exits 1 on the first difference. One JSON line:
+ *
+ *   gcc -O2 -fno-math-errno -fno-trapping-math -std=c11 -Wno-unused-function \
+ *       -Isrc bench/check_stream.c -lm -o check_stream
+ *   ./check_stream [paths]
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "rng.h"
+#include "windmouse.h"
+
+#define PATHS   1000
+
+static MousePath whole;
+
+int main(int argc, char *argv[]) {
+    int paths = argc > 1 ? atoi(argv[1]) : PATHS;
+    if (paths < 1)
+        paths = PATHS;
+
+    Rng rng;
+    rng_seed(&rng, 1);
+    long long points = 0, fills = 0;
+
+    for (int i = 0; i < paths; i++) {
+        double tx = rng_range(&rng, -400, 400);
+        double ty = rng_range(&rng, -400, 400);
+        uint64_t seed = rng_next(&rng);
+
+        whole = generate_wind_path(seed, tx, ty);
+
+        PathStream s;
+        stream_init(&s, seed, tx, ty);
+
+        int n = 0, until_fill = 0;
+        PackedPoint p;
+        for (;;) {
+            if (until_fill-- == 0) {
+                int times = 1 + (int)(rng_next(&rng) % 3);
+                while (times--) {
+                    stream_fill(&s);
+                    fills++;
+                }
+                /* mostly short gaps, now and then one longer than the ring */
+                until_fill = rng_next(&rng) % 8 == 0
+                    ? (int)(rng_next(&rng) % (4 * PATH_RING_SIZE))
+                    : (int)(rng_next(&rng) % 8);
+            }
+            if (!stream_pop(&s, &p))
+                break;
+
+            if (n >= whole.count || p.dx != whole.points[n].dx || p.dy != whole.points[n].dy ||
+                p.delay_us != whole.points[n].delay_us) {
+                fprintf(stderr, "check_stream: path %d (seed %llu): point %d differs\n",
+                        i, (unsigned long long)seed, n);
+                return 1;
+            }
+            n++;
+        }
+
+        if (n != whole.count || stream_count(&s) != whole.count) {
+            fprintf(stderr, "check_stream: path %d (seed %llu): %d points streamed, %d whole\n",
+                    i, (unsigned long long)seed, n, whole.count);
+            return 1;
+        }
+        points += n;
+    }
+
+    printf("{\"bench\": \"stream_check\", \"paths\": %d, \"points\": %lld, \"fills\": %lld, "
+           "\"ok\": true}\n", paths, points, fills);
+    return 0;
+}
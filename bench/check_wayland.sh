@@ -0,0 +1,163 @@
+#!/bin/bash
+
+# ============================================================================
+# JIGGLEMIL - Wayland idle backend check
+# Generates the ext-idle-notify-v1 glue the way install.sh does, builds the
+# daemon with the Wayland backend and runs it (--idle wayland, file sink
+# for injection) against bench/mock_compositor.c. Fails if:
+#
+#   - the daemon does not pick the Wayland backend
+#   - it asks for a notification other than at the warning threshold
+#   - an idled event does not turn it red, or resumed back green
+#   - a reload of warning_limit_ms does not replace the notification
+#     with one at the new timeout
+#   - a triggered action does not reach the sink
+#
+# One JSON line (run.sh collects it).
+#
+#   bench/check_wayland.sh
+#
+# Needs wayland-scanner, wayland-protocols and the wayland-client /
+# wayland-server libraries. CC, CFLAGS, WAYLAND_SCANNER, WL_PROTOCOLS,
+# WAYLAND_CLIENT_LIBS and WAYLAND_SERVER_LIBS can be overridden from the
+# environment.
+# ============================================================================
+
+set -e
+
+cd "$(dirname "$0")/.."
+
+CC="${CC:-gcc}"
+CFLAGS="${CFLAGS:--O2 -std=c11 -Wall -Wextra}"
+WAYLAND_SCANNER="${WAYLAND_SCANNER:-wayland-scanner}"
+WARNING_MS=10000
+RELOAD_MS=5000
+
+if [ -z "${WL_PROTOCOLS+x}" ]; then
+    WL_PROTOCOLS="$(pkg-config --variable=pkgdatadir wayland-protocols 2> /dev/null || true)"
+fi
+if [ -z "${WAYLAND_CLIENT_LIBS+x}" ] && pkg-config --exists wayland-client; then
+    WAYLAND_CLIENT_LIBS="$(pkg-config --cflags --libs wayland-client)"
+fi
+if [ -z "${WAYLAND_SERVER_LIBS+x}" ] && pkg-config --exists wayland-server; then
+    WAYLAND_SERVER_LIBS="$(pkg-config --cflags --libs wayland-server)"
+fi
+EXT_IDLE_XML="$WL_PROTOCOLS/staging/ext-idle-notify/ext-idle-notify-v1.xml"
+if ! command -v "$WAYLAND_SCANNER" &> /dev/null || [ ! -f "$EXT_IDLE_XML" ] ||
+        [ -z "$WAYLAND_CLIENT_LIBS" ] || [ -z "$WAYLAND_SERVER_LIBS" ]; then
+    echo "check_wayland: needs wayland-scanner, wayland-protocols, wayland-client and wayland-server" >&2
+    exit 77
+fi
+
+DIR="$(mktemp -d)"
+MOCK_PID=""
+DAEMON_PID=""
+cleanup() {
+    [ -n "$DAEMON_PID" ] && kill "$DAEMON_PID" 2> /dev/null
+    [ -n "$MOCK_PID" ] && kill "$MOCK_PID" 2> /dev/null
+    rm -rf "$DIR"
+}
+trap cleanup EXIT
+
+echo "building jigglemil (Wayland) and mock_compositor" >&2
+"$WAYLAND_SCANNER" client-header "$EXT_IDLE_XML" "$DIR/ext-idle-notify-v1-client-protocol.h"
+"$WAYLAND_SCANNER" server-header "$EXT_IDLE_XML" "$DIR/ext-idle-notify-v1-server-protocol.h"
+"$WAYLAND_SCANNER" private-code  "$EXT_IDLE_XML" "$DIR/ext-idle-notify-v1-protocol.c"
+$CC $CFLAGS -DHAVE_WAYLAND_IDLE -I"$DIR" src/jigglemil.c "$DIR/ext-idle-notify-v1-protocol.c" \
+    -lm -lpthread $WAYLAND_CLIENT_LIBS -o "$DIR/jigglemil" >&2
+$CC $CFLAGS -I"$DIR" bench/mock_compositor.c "$DIR/ext-idle-notify-v1-protocol.c" \
+    $WAYLAND_SERVER_LIBS -o "$DIR/mock_compositor" >&2
+
+# The daemon under test: its own runtime / config dirs, a known warning
+# threshold and actions far enough away that only "trigger" causes one
+export XDG_RUNTIME_DIR="$DIR/run" XDG_CONFIG_HOME="$DIR/config" WAYLAND_DISPLAY=wayland-check
+unset DBUS_SESSION_BUS_ADDRESS
+mkdir -p "$XDG_RUNTIME_DIR" "$XDG_CONFIG_HOME/jigglemil"
+chmod 700 "$XDG_RUNTIME_DIR"
+printf 'warning_limit_ms = %d\n' "$WARNING_MS" > "$XDG_CONFIG_HOME/jigglemil/jigglemil.conf"
+: > "$DIR/sink"
+
+fail() {
+    echo "check_wayland: $*" >&2
+    exit 1
+}
+
+J="$DIR/jigglemil"
+
+# field NAME: one field of the daemon's status line
+field() {
+    "$J" --ctl status | sed -n "s/.*\"$1\": \"\{0,1\}\([^\",}]*\).*/\1/p"
+}
+
+# wait_state STATE: poll until the daemon reports STATE. 2 s at most, well
+# below the threshold: only an event can get it there, not idle time adding up
+wait_state() {
+    local i
+    for i in $(seq 20); do
+        [ "$(field state)" = "$1" ] && return 0
+        sleep 0.1
+    done
+    return 1
+}
+
+"$DIR/mock_compositor" "$WAYLAND_DISPLAY" > "$DIR/mock.log" &
+MOCK_PID=$!
+for i in $(seq 50); do
+    grep -q ready "$DIR/mock.log" && break
+    kill -0 "$MOCK_PID" 2> /dev/null || fail "mock compositor did not start"
+    sleep 0.1
+done
+
+"$J" --idle wayland --uinput --uinput-device "$DIR/sink" --action key > /dev/null 2>&1 &
+DAEMON_PID=$!
+for i in $(seq 50); do
+    "$J" --ctl ping > /dev/null 2>&1 && break
+    kill -0 "$DAEMON_PID" 2> /dev/null || fail "daemon did not start"
+    sleep 0.1
+done
+
+BACKEND="$(field idle_backend)"
+[ "$BACKEND" = "wayland" ] || fail "idle backend is '$BACKEND', expected wayland"
+
+TIMEOUT="$(sed -n 's/^notification timeout=//p' "$DIR/mock.log" | head -n 1)"
+[ "$TIMEOUT" = "$WARNING_MS" ] || fail "notification timeout '$TIMEOUT', expected $WARNING_MS"
+wait_state green || fail "not green at start"
+
+kill -USR1 "$MOCK_PID"
+wait_state red || fail "idled: still $(field state)"
+IDLE_MS="$(field idle_ms)"
+[ "$IDLE_MS" -ge "$WARNING_MS" ] || fail "idled: idle_ms $IDLE_MS, expected >= $WARNING_MS"
+
+kill -USR2 "$MOCK_PID"
+wait_state green || fail "resumed: still $(field state)"
+RESUMED_MS="$(field idle_ms)"
+[ "$RESUMED_MS" -lt "$WARNING_MS" ] || fail "resumed: idle_ms $RESUMED_MS"
+
+# Hot reload: the old notification goes, one at the new timeout replaces it
+printf 'warning_limit_ms = %d\n' "$RELOAD_MS" > "$XDG_CONFIG_HOME/jigglemil/jigglemil.conf"
+for i in $(seq 50); do
+    grep -q "^notification timeout=$RELOAD_MS$" "$DIR/mock.log" && break
+    sleep 0.1
+done
+grep -q "^notification timeout=$RELOAD_MS$" "$DIR/mock.log" || fail "reload: no notification at $RELOAD_MS ms"
+kill -USR1 "$MOCK_PID"
+wait_state red || fail "reload: idled: still $(field state)"
+TOLD="$(sed -n 's/^idled //p' "$DIR/mock.log" | tail -n 1)"
+[ "$TOLD" = 1 ] || fail "reload: $TOLD notifications told, the old one was kept"
+kill -USR2 "$MOCK_PID"
+wait_state green || fail "reload: resumed: still $(field state)"
+
+"$J" --ctl trigger > /dev/null
+for i in $(seq 50); do
+    [ -s "$DIR/sink" ] && break
+    sleep 0.1
+done
+SINK_BYTES="$(stat -c %s "$DIR/sink")"
+[ "$SINK_BYTES" -gt 0 ] || fail "trigger: nothing injected"
+
+"$J" --ctl stop > /dev/null
+wait "$DAEMON_PID" || fail "daemon exited with $?"
+DAEMON_PID=""
+
+printf '{"bench": "wayland", "notification_timeout_ms": %d, "idled_idle_ms": %d, "resumed_idle_ms": %d, "sink_bytes": %d, "reload_timeout_ms": %d}\n' \
+    "$TIMEOUT" "$IDLE_MS" "$RESUMED_MS" "$SINK_BYTES" "$RELOAD_MS"
@@ -0,0 +1,147 @@
+/*
+ * Mock Wayland compositor for bench/check_wayland.sh
+ *
+ * Listens on $XDG_RUNTIME_DIR/NAME and offers a wl_seat and
+ * ext_idle_notifier_v1, nothing else. There is no input, so idle is
+ * whatever the script says: SIGUSR1 sends idled and SIGUSR2 resumed to
+ * every notification object. Prints one line per event:
+ *
+ *   ready
+ *   notification timeout=MS
+ *   idled N / resumed N      (N = notifications told)
+ *
+ *   wayland-scanner server-header ext-idle-notify-v1.xml ext-idle-notify-v1-server-protocol.h
+ *   wayland-scanner private-code ext-idle-notify-v1.xml ext-idle-notify-v1-protocol.c
+ *   gcc -O2 -std=c11 -I. bench/mock_compositor.c ext-idle-notify-v1-protocol.c \
+ *       $(pkg-config --cflags --libs wayland-server) -o mock_compositor
+ *   ./mock_compositor [NAME]
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <signal.h>
+#include <wayland-server.h>
+
+#include "ext-idle-notify-v1-server-protocol.h"
+
+#define MAX_NOTIFICATIONS 16
+
+static struct wl_resource *notifications[MAX_NOTIFICATIONS];
+
+static void destroy_resource(struct wl_client *client, struct wl_resource *resource) {
+    (void)client;
+    wl_resource_destroy(resource);
+}
+
+// ----------------------------
+// ext_idle_notification_v1
+// ----------------------------
+static const struct ext_idle_notification_v1_interface notification_impl = {
+    .destroy = destroy_resource,
+};
+
+static void notification_gone(struct wl_resource *resource) {
+    for (int i = 0; i < MAX_NOTIFICATIONS; i++)
+        if (notifications[i] == resource)
+            notifications[i] = NULL;
+}
+
+static void get_idle_notification(struct wl_client *client, struct wl_resource *resource,
+                                  uint32_t id, uint32_t timeout, struct wl_resource *seat) {
+    (void)seat;
+
+    struct wl_resource *n = wl_resource_create(client, &ext_idle_notification_v1_interface,
+                                               wl_resource_get_version(resource), id);
+    if (!n) {
+        wl_client_post_no_memory(client);
+        return;
+    }
+    wl_resource_set_implementation(n, &notification_impl, NULL, notification_gone);
+
+    for (int i = 0; i < MAX_NOTIFICATIONS; i++) {
+        if (!notifications[i]) {
+            notifications[i] = n;
+            break;
+        }
+    }
+    printf("notification timeout=%u\n", timeout);
+    fflush(stdout);
+}
+
+// ----------------------------
+// ext_idle_notifier_v1 and wl_seat globals
+// ----------------------------
+static const struct ext_idle_notifier_v1_interface notifier_impl = {
+    .destroy               = destroy_resource,
+    .get_idle_notification = get_idle_notification,
+};
+
+static void bind_notifier(struct wl_client *client, void *data, uint32_t version, uint32_t id) {
+    (void)data;
+
+    struct wl_resource *r = wl_resource_create(client, &ext_idle_notifier_v1_interface,
+                                               (int)version, id);
+    if (!r) {
+        wl_client_post_no_memory(client);
+        return;
+    }
+    wl_resource_set_implementation(r, &notifier_impl, NULL, NULL);
+}
+
+/* the daemon only passes its seat along; no request of it is ever sent */
+static void bind_seat(struct wl_client *client, void *data, uint32_t version, uint32_t id) {
+    (void)data;
+
+    struct wl_resource *r = wl_resource_create(client, &wl_seat_interface, (int)version, id);
+    if (!r)
+        wl_client_post_no_memory(client);
+}
+
+// ----------------------------
+// SIGUSR1 / SIGUSR2: the seat went idle / came back
+// ----------------------------
+static int on_signal(int signal_number, void *data) {
+    (void)data;
+
+    int told = 0;
+    for (int i = 0; i < MAX_NOTIFICATIONS; i++) {
+        if (!notifications[i])
+            continue;
+        if (signal_number == SIGUSR1)
+            ext_idle_notification_v1_send_idled(notifications[i]);
+        else
+            ext_idle_notification_v1_send_resumed(notifications[i]);
+        told++;
+    }
+    printf("%s %d\n", signal_number == SIGUSR1 ? "idled" : "resumed", told);
+    fflush(stdout);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    const char *name = argc > 1 ? argv[1] : "wayland-check";
+
+    struct wl_display *display = wl_display_create();
+    if (!display || wl_display_add_socket(display, name) < 0) {
+        fprintf(stderr, "mock_compositor: cannot listen on %s\n", name);
+        return 1;
+    }
+
+    struct wl_event_loop *loop = wl_display_get_event_loop(display);
+    if (!wl_global_create(display, &wl_seat_interface, 1, NULL, bind_seat) ||
+        !wl_global_create(display, &ext_idle_notifier_v1_interface, 1, NULL, bind_notifier) ||
+        !wl_event_loop_add_signal(loop, SIGUSR1, on_signal, NULL) ||
+        !wl_event_loop_add_signal(loop, SIGUSR2, on_signal, NULL)) {
+        fprintf(stderr, "mock_compositor: setup failed\n");
+        return 1;
+    }
+
+    /* ready once the socket is up and the signals are ours */
+    printf("ready\n");
+    fflush(stdout);
+
+    wl_display_run(display);
+    wl_display_destroy(display);
+    return 0;
+}
@@ -0,0 +1,152 @@
+/*
+ * Stub logind for bench/check_logind.sh
+ *
+ * Owns org.freedesktop.login1 on the bus in DBUS_SYSTEM_BUS_ADDRESS (a
+ * private one in the check) with one session, c1, for every caller.
+ * Answers GetSession / GetSessionByPID and Properties.Get for
+ * PreparingForSleep, Active and LockedHint. Commands on stdin, one per
+ * line, change the state and emit what logind would:
+ *
+ *   sleep 1|0     PreparingForSleep property + PrepareForSleep(b) signal
+ *   lock|unlock   Lock / Unlock signal on the session
+ *   active 1|0    Active property + PropertiesChanged with the value
+ *   hint 1|0      LockedHint property + PropertiesChanged, invalidated only
+ *
+ * Prints "ready" once the name is ours, then one line per command.
+ *
+ *   gcc -O2 -std=c11 bench/mock_logind.c $(pkg-config --cflags --libs libsystemd) -o mock_logind
+ *   ./mock_logind < commands
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <string.h>
+#include <poll.h>
+#include <systemd/sd-bus.h>
+
+#define LOGIND_NAME     "org.freedesktop.login1"
+#define LOGIND_PATH     "/org/freedesktop/login1"
+#define LOGIND_MANAGER  "org.freedesktop.login1.Manager"
+#define LOGIND_SESSION  "org.freedesktop.login1.Session"
+#define SESSION_PATH    LOGIND_PATH "/session/c1"
+#define PROPERTIES      "org.freedesktop.DBus.Properties"
+
+static int sleeping = 0;
+static int active = 1;
+static int locked_hint = 0;
+
+/* Properties.Get(s interface, s name) for the flags we know, else an error */
+static int reply_property(sd_bus_message *m, const char *want_iface) {
+    const char *iface, *name;
+    if (sd_bus_message_read(m, "ss", &iface, &name) < 0 || strcmp(iface, want_iface) != 0)
+        return 0;
+
+    const int *flag = strcmp(name, "PreparingForSleep") == 0 ? &sleeping
+                    : strcmp(name, "Active") == 0            ? &active
+                    : strcmp(name, "LockedHint") == 0        ? &locked_hint : NULL;
+    if (!flag)
+        return 0;
+    return sd_bus_reply_method_return(m, "v", "b", *flag);
+}
+
+static int on_manager(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
+    (void)userdata;
+    (void)ret_error;
+
+    if (sd_bus_message_is_method_call(m, LOGIND_MANAGER, "GetSession") ||
+        sd_bus_message_is_method_call(m, LOGIND_MANAGER, "GetSessionByPID"))
+        return sd_bus_reply_method_return(m, "o", SESSION_PATH);
+    if (sd_bus_message_is_method_call(m, PROPERTIES, "Get"))
+        return reply_property(m, LOGIND_MANAGER);
+    return 0;
+}
+
+static int on_session(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
+    (void)userdata;
+    (void)ret_error;
+
+    if (sd_bus_message_is_method_call(m, PROPERTIES, "Get"))
+        return reply_property(m, LOGIND_SESSION);
+    return 0;
+}
+
+/* PropertiesChanged for one session flag, with its value or invalidated */
+static int emit_changed(sd_bus *bus, const char *name, int value, int with_value) {
+    sd_bus_message *m = NULL;
+    int r = sd_bus_message_new_signal(bus, &m, SESSION_PATH, PROPERTIES, "PropertiesChanged");
+    if (r >= 0) r = sd_bus_message_append(m, "s", LOGIND_SESSION);
+    if (r >= 0) r = sd_bus_message_open_container(m, 'a', "{sv}");
+    if (r >= 0 && with_value) r = sd_bus_message_append(m, "{sv}", name, "b", value);
+    if (r >= 0) r = sd_bus_message_close_container(m);
+    if (r >= 0) r = with_value ? sd_bus_message_append(m, "as", 0)
+                               : sd_bus_message_append(m, "as", 1, name);
+    if (r >= 0) r = sd_bus_send(bus, m, NULL);
+    sd_bus_message_unref(m);
+    return r;
+}
+
+static int command(sd_bus *bus, const char *line) {
+    int v = 0;
+    char word[16];
+    if (sscanf(line, "%15s %d", word, &v) < 1)
+        return 0;
+
+    if (strcmp(word, "sleep") == 0) {
+        sleeping = v;
+        return sd_bus_emit_signal(bus, LOGIND_PATH, LOGIND_MANAGER, "PrepareForSleep", "b", v);
+    }
+    if (strcmp(word, "lock") == 0 || strcmp(word, "unlock") == 0)
+        return sd_bus_emit_signal(bus, SESSION_PATH, LOGIND_SESSION,
+                                  word[0] == 'l' ? "Lock" : "Unlock", "");
+    if (strcmp(word, "active") == 0) {
+        active = v;
+        return emit_changed(bus, "Active", v, 1);
+    }
+    if (strcmp(word, "hint") == 0) {
+        locked_hint = v;
+        return emit_changed(bus, "LockedHint", v, 0);
+    }
+    return -1;
+}
+
+int main(void) {
+    sd_bus *bus;
+    if (sd_bus_open_system(&bus) < 0) {
+        fprintf(stderr, "mock_logind: no bus in DBUS_SYSTEM_BUS_ADDRESS\n");
+        return 1;
+    }
+    if (sd_bus_add_object(bus, NULL, LOGIND_PATH, on_manager, NULL) < 0 ||
+        sd_bus_add_object(bus, NULL, SESSION_PATH, on_session, NULL) < 0 ||
+        sd_bus_request_name(bus, LOGIND_NAME, 0) < 0) {
+        fprintf(stderr, "mock_logind: cannot own " LOGIND_NAME "\n");
+        return 1;
+    }
+
+    /* ready once the name is ours */
+    printf("ready\n");
+    fflush(stdout);
+
+    char line[64];
+    for (;;) {
+        while (sd_bus_process(bus, NULL) > 0)
+            ;
+        sd_bus_flush(bus);
+
+        struct pollfd fds[2] = {
+            { .fd = sd_bus_get_fd(bus), .events = (short)sd_bus_get_events(bus) },
+            { .fd = 0,                  .events = POLLIN },
+        };
+        if (poll(fds, 2, -1) < 0)
+            continue;
+        if (!(fds[1].revents & (POLLIN | POLLHUP)))
+            continue;
+
+        if (!fgets(line, sizeof(line), stdin))
+            return 0;
+        line[strcspn(line, "\n")] = '\0';
+        int r = command(bus, line);
+        printf("%s %s\n", line, r < 0 ? "failed" : "sent");
+        fflush(stdout);
+    }
+}
@@ -0,0 +1,194 @@
+/*
+ * Stub Mutter IdleMonitor for bench/check_gnome.sh
+ *
+ * Owns org.gnome.Mutter.IdleMonitor on the session bus and serves
+ * /org/gnome/Mutter/IdleMonitor/Core like Mutter does, minus the input:
+ * idle time counts from the last "active" command. GetIdletime returns
+ * it, an idle watch fires WatchFired once each time idle time crosses its
+ * interval, a user-active watch fires on the next "active" and is gone.
+ * Commands on stdin, one per line:
+ *
+ *   active        the user did something (idle time restarts at 0)
+ *   reject N      fail the next N AddUserActiveWatch calls
+ *
+ * Prints one line per event:
+ *
+ *   ready
+ *   idle-watch id=I interval=MS  /  active-watch id=I  /  active-watch rejected
+ *   remove id=I
+ *   fired id=I idle|active
+ *
+ *   gcc -O2 -std=c11 bench/mock_mutter.c $(pkg-config --cflags --libs libsystemd) -o mock_mutter
+ *   ./mock_mutter < commands
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <poll.h>
+#include <systemd/sd-bus.h>
+
+#define IDLE_NAME   "org.gnome.Mutter.IdleMonitor"
+#define IDLE_PATH   "/org/gnome/Mutter/IdleMonitor/Core"
+#define IDLE_IFACE  "org.gnome.Mutter.IdleMonitor"
+#define MAX_WATCHES 64
+
+typedef struct {
+    uint32_t id;        /* 0 = free slot */
+    uint64_t interval;  /* 0 = user-active watch */
+    int fired;          /* idle watch: fired in this idle period */
+} Watch;
+
+static Watch watches[MAX_WATCHES];
+static uint32_t next_id = 1;
+static uint64_t last_active_ms;
+static int reject = 0;
+
+static uint64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+static uint32_t add_watch(uint64_t interval) {
+    for (int i = 0; i < MAX_WATCHES; i++) {
+        if (!watches[i].id) {
+            watches[i] = (Watch){ .id = next_id++, .interval = interval };
+            return watches[i].id;
+        }
+    }
+    return 0;
+}
+
+static void fire(sd_bus *bus, Watch *w) {
+    printf("fired id=%u %s\n", w->id, w->interval ? "idle" : "active");
+    fflush(stdout);
+    sd_bus_emit_signal(bus, IDLE_PATH, IDLE_IFACE, "WatchFired", "u", w->id);
+}
+
+static int on_call(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
+    (void)userdata;
+    (void)ret_error;
+
+    if (sd_bus_message_is_method_call(m, IDLE_IFACE, "GetIdletime"))
+        return sd_bus_reply_method_return(m, "t", now_ms() - last_active_ms);
+
+    if (sd_bus_message_is_method_call(m, IDLE_IFACE, "AddIdleWatch")) {
+        uint64_t interval;
+        if (sd_bus_message_read(m, "t", &interval) < 0 || interval == 0)
+            return sd_bus_reply_method_errorf(m, "org.freedesktop.DBus.Error.InvalidArgs",
+                                              "interval must be > 0");
+        uint32_t id = add_watch(interval);
+        printf("idle-watch id=%u interval=%llu\n", id, (unsigned long long)interval);
+        fflush(stdout);
+        return sd_bus_reply_method_return(m, "u", id);
+    }
+
+    if (sd_bus_message_is_method_call(m, IDLE_IFACE, "AddUserActiveWatch")) {
+        if (reject > 0) {
+            reject--;
+            printf("active-watch rejected\n");
+            fflush(stdout);
+            return sd_bus_reply_method_errorf(m, "org.freedesktop.DBus.Error.Failed",
+                                              "rejected by the check");
+        }
+        uint32_t id = add_watch(0);
+        printf("active-watch id=%u\n", id);
+        fflush(stdout);
+        return sd_bus_reply_method_return(m, "u", id);
+    }
+
+    if (sd_bus_message_is_method_call(m, IDLE_IFACE, "RemoveWatch")) {
+        uint32_t id;
+        if (sd_bus_message_read(m, "u", &id) < 0)
+            return 0;
+        for (int i = 0; i < MAX_WATCHES; i++)
+            if (watches[i].id == id)
+                watches[i].id = 0;
+        printf("remove id=%u\n", id);
+        fflush(stdout);
+        return sd_bus_reply_method_return(m, "");
+    }
+    return 0;
+}
+
+/* idle watches due by now fire; returns ms until the next one, -1 if none */
+static int fire_idle_watches(sd_bus *bus) {
+    uint64_t idle = now_ms() - last_active_ms;
+    int64_t wait = -1;
+    for (int i = 0; i < MAX_WATCHES; i++) {
+        Watch *w = &watches[i];
+        if (!w->id || !w->interval || w->fired)
+            continue;
+        if (idle >= w->interval) {
+            w->fired = 1;
+            fire(bus, w);
+        } else if (wait < 0 || (int64_t)(w->interval - idle) < wait) {
+            wait = (int64_t)(w->interval - idle);
+        }
+    }
+    return (int)wait;
+}
+
+static void command(sd_bus *bus, const char *line) {
+    int n = 0;
+    if (strcmp(line, "active") == 0) {
+        last_active_ms = now_ms();
+        for (int i = 0; i < MAX_WATCHES; i++) {
+            Watch *w = &watches[i];
+            if (!w->id)
+                continue;
+            if (w->interval) {
+                w->fired = 0;
+            } else {
+                fire(bus, w);
+                w->id = 0;      /* one-shot */
+            }
+        }
+    } else if (sscanf(line, "reject %d", &n) == 1) {
+        reject = n;
+    }
+}
+
+int main(void) {
+    sd_bus *bus;
+    if (sd_bus_open_user(&bus) < 0) {
+        fprintf(stderr, "mock_mutter: no session bus\n");
+        return 1;
+    }
+    if (sd_bus_add_object(bus, NULL, IDLE_PATH, on_call, NULL) < 0 ||
+        sd_bus_request_name(bus, IDLE_NAME, 0) < 0) {
+        fprintf(stderr, "mock_mutter: cannot own " IDLE_NAME "\n");
+        return 1;
+    }
+    last_active_ms = now_ms();
+
+    /* ready once the name is ours */
+    printf("ready\n");
+    fflush(stdout);
+
+    char line[64];
+    for (;;) {
+        while (sd_bus_process(bus, NULL) > 0)
+            ;
+        int wait = fire_idle_watches(bus);
+        sd_bus_flush(bus);
+
+        struct pollfd fds[2] = {
+            { .fd = sd_bus_get_fd(bus), .events = (short)sd_bus_get_events(bus) },
+            { .fd = 0,                  .events = POLLIN },
+        };
+        if (poll(fds, 2, wait) <= 0)
+            continue;
+        if (!(fds[1].revents & (POLLIN | POLLHUP)))
+            continue;
+
+        if (!fgets(line, sizeof(line), stdin))
+            return 0;
+        line[strcspn(line, "\n")] = '\0';
+        command(bus, line);
+    }
+}
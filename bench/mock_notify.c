@@ -0,0 +1,60 @@
+/*
+ * Mock notification server for bench/check_notify.sh
+ *
+ * Owns org.freedesktop.Notifications on the session bus and answers
+ * Notify like a real server: a new id for replaces_id 0, otherwise the
+ * replaced one. Prints one line per call:
+ *
+ *   notify replaces=R id=I body=BODY
+ *
+ *   gcc -O2 -std=c11 bench/mock_notify.c $(pkg-config --cflags --libs libsystemd) -o mock_notify
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <string.h>
+#include <systemd/sd-bus.h>
+
+static uint32_t next_id = 1;
+
+static int on_call(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
+    (void)userdata;
+    (void)ret_error;
+
+    if (strcmp(sd_bus_message_get_member(m), "Notify") != 0)
+        return 0;
+
+    const char *app, *icon, *summary, *body;
+    uint32_t replaces;
+    if (sd_bus_message_read(m, "susss", &app, &replaces, &icon, &summary, &body) < 0)
+        return 0;
+
+    uint32_t id = replaces ? replaces : next_id++;
+    printf("notify replaces=%u id=%u body=%s\n", replaces, id, body);
+    fflush(stdout);
+    return sd_bus_reply_method_return(m, "u", id);
+}
+
+int main(void) {
+    sd_bus *bus;
+    if (sd_bus_open_user(&bus) < 0) {
+        fprintf(stderr, "mock_notify: no session bus\n");
+        return 1;
+    }
+    if (sd_bus_add_object(bus, NULL, "/org/freedesktop/Notifications", on_call, NULL) < 0 ||
+        sd_bus_request_name(bus, "org.freedesktop.Notifications", 0) < 0) {
+        fprintf(stderr, "mock_notify: cannot own org.freedesktop.Notifications\n");
+        return 1;
+    }
+
+    /* ready once the name is ours */
+    printf("ready\n");
+    fflush(stdout);
+
+    for (;;) {
+        while (sd_bus_process(bus, NULL) > 0)
+            ;
+        sd_bus_wait(bus, UINT64_MAX);
+    }
+}
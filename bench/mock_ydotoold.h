@@ -0,0 +1,125 @@
+/*
+ * Mock ydotoold for the injection benchmarks
+ *
+ * Binds a datagram socket the way ydotoold does, reads one input_event per
+ * datagram on its own thread and timestamps every SYN_REPORT (= one point)
+ * with CLOCK_MONOTONIC as it arrives. Nothing is injected anywhere.
+ */
+
+#ifndef MOCK_YDOTOOLD_H
+#define MOCK_YDOTOOLD_H
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <linux/input.h>
+
+#include "bench_common.h"
+
+#define MOCK_MAX_POINTS  65536
+#define MOCK_RECV_BATCH  64
+
+static int mock_fd = -1;
+static pthread_t mock_thread;
+static atomic_int mock_stop = 0;
+static char mock_path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+
+/* arrival time of each point, in order */
+static long long mock_recv_ns[MOCK_MAX_POINTS];
+static atomic_int mock_points = 0;
+static atomic_long mock_events = 0;
+
+static void* mock_main(void *arg) {
+    (void)arg;
+    struct input_event ev[MOCK_RECV_BATCH];
+    struct mmsghdr msgs[MOCK_RECV_BATCH];
+    struct iovec iov[MOCK_RECV_BATCH];
+
+    while (!atomic_load(&mock_stop)) {
+        memset(msgs, 0, sizeof(msgs));
+        for (int i = 0; i < MOCK_RECV_BATCH; i++) {
+            iov[i].iov_base = &ev[i];
+            iov[i].iov_len  = sizeof(ev[i]);
+            msgs[i].msg_hdr.msg_iov    = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        /* block for the first datagram, then take whatever is queued */
+        int n = recvmmsg(mock_fd, msgs, MOCK_RECV_BATCH, MSG_WAITFORONE, NULL);
+        if (n < 0)
+            continue;    /* EINTR or the receive timeout: re-check mock_stop */
+
+        long long now = bench_now_ns();
+        atomic_fetch_add(&mock_events, n);
+        for (int i = 0; i < n; i++) {
+            if (msgs[i].msg_len != sizeof(ev[i]) || ev[i].type != EV_SYN)
+                continue;
+            int idx = atomic_load_explicit(&mock_points, memory_order_relaxed);
+            if (idx < MOCK_MAX_POINTS)
+                mock_recv_ns[idx] = now;
+            atomic_store_explicit(&mock_points, idx + 1, memory_order_release);
+        }
+    }
+    return NULL;
+}
+
+static int mock_ydotoold_start(const char *path) {
+    snprintf(mock_path, sizeof(mock_path), "%s", path);
+    unlink(mock_path);
+
+    mock_fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (mock_fd < 0)
+        return -1;
+
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", mock_path);
+    if (bind(mock_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(mock_fd);
+        mock_fd = -1;
+        return -1;
+    }
+
+    struct timeval tv = { .tv_sec = 0, .tv_usec = 100000 };
+    setsockopt(mock_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    atomic_store(&mock_stop, 0);
+    if (pthread_create(&mock_thread, NULL, mock_main, NULL) != 0) {
+        close(mock_fd);
+        mock_fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+// Wait until n points arrived (or timeout); returns the number received
+static int mock_ydotoold_wait(int n, int timeout_ms) {
+    long long until = bench_now_ns() + timeout_ms * 1000000ll;
+    int got;
+    while ((got = atomic_load_explicit(&mock_points, memory_order_acquire)) < n &&
+           bench_now_ns() < until)
+        usleep(1000);
+    return got;
+}
+
+// Only call once the sender is done and mock_ydotoold_wait() returned
+static void mock_ydotoold_reset(void) {
+    atomic_store(&mock_points, 0);
+    atomic_store(&mock_events, 0);
+}
+
+static void mock_ydotoold_stop(void) {
+    if (mock_fd < 0)
+        return;
+    atomic_store(&mock_stop, 1);
+    pthread_join(mock_thread, NULL);
+    close(mock_fd);
+    mock_fd = -1;
+    unlink(mock_path);
+}
+
+#endif // MOCK_YDOTOOLD_H
@@ -0,0 +1,187 @@
+#!/bin/bash
+
+# ============================================================================
+# JIGGLEMIL - Benchmark runner
+# Builds every benchmark in bench/ and prints all results as one JSON array
+# (store it per release and diff to catch regressions).
+#
+#   bench/run.sh [output.json]
+#
+# CC, CFLAGS, UDEV_LIBS and SYSTEMD_LIBS can be overridden from the environment.
+# ============================================================================
+
+set -e
+
+cd "$(dirname "$0")/.."
+
+CC="${CC:-gcc}"
+CFLAGS="${CFLAGS:--O2 -fno-math-errno -fno-trapping-math -std=c11 -Wall -Wextra -Wno-unused-function}"
+CFLAGS="$CFLAGS -Isrc"
+
+if [ -z "${UDEV_LIBS+x}" ] && pkg-config --exists libudev; then
+    UDEV_LIBS="$(pkg-config --cflags --libs libudev)"
+fi
+if [ -z "${SYSTEMD_LIBS+x}" ] && pkg-config --exists libsystemd; then
+    SYSTEMD_LIBS="$(pkg-config --cflags --libs libsystemd)"
+fi
+
+BUILD_DIR="$(mktemp -d)"
+trap 'rm -rf "$BUILD_DIR"' EXIT
+
+RESULTS="$BUILD_DIR/results.jsonl"
+: > "$RESULTS"
+
+# build NAME EXTRA_FLAGS...  (compiler output goes to stderr)
+build() {
+    local name="$1"; shift
+    echo "building $name" >&2
+    $CC $CFLAGS "bench/$name.c" "$@" -o "$BUILD_DIR/$name" >&2
+}
+
+skip() {
+    echo "skipping $1: $2" >&2
+    echo "{\"bench\": \"$1\", \"skipped\": \"$2\"}" >> "$RESULTS"
+}
+
+# Also a check: exits non-zero if a pinned seed no longer gives the same path
+build check_golden -lm
+"$BUILD_DIR/check_golden" >> "$RESULTS"
+
+# Also a check: exits non-zero if a streamed path differs from the whole one
+build check_stream -lm
+"$BUILD_DIR/check_stream" >> "$RESULTS"
+
+# Also a check: exits non-zero if a played path takes longer than its delays
+build check_pacing -lm
+"$BUILD_DIR/check_pacing" >> "$RESULTS"
+
+build bench_generate -lm
+"$BUILD_DIR/bench_generate" >> "$RESULTS"
+
+build bench_windmouse -lm
+"$BUILD_DIR/bench_windmouse" >> "$RESULTS"
+
+# Also a check: exits non-zero if coalescing changed a path's displacement
+build bench_coalesce -lm
+"$BUILD_DIR/bench_coalesce" >> "$RESULTS"
+
+# Also a check: exits non-zero if async logging makes playback late
+build bench_log -lpthread
+"$BUILD_DIR/bench_log" >> "$RESULTS"
+
+build bench_corpus -lm -lpthread
+"$BUILD_DIR/bench_corpus" >> "$RESULTS"
+
+# Path quality (point counts, cap hits, final error, speed, jerk), not speed;
+# run it with millions of paths before changing the WindMouse ranges
+build analyze_paths -lm -lpthread
+"$BUILD_DIR/analyze_paths" -n 20000 >> "$RESULTS"
+"$BUILD_DIR/analyze_paths" -n 10000 -g candidates >> "$RESULTS"
+
+# The injection and evdev benchmarks link the evdev idle backend
+if [ -n "$UDEV_LIBS" ]; then
+    build bench_inject -DHAVE_EVDEV_IDLE -lm -lpthread $UDEV_LIBS
+    "$BUILD_DIR/bench_inject" >> "$RESULTS"
+
+    build bench_evdev -lpthread $UDEV_LIBS
+    "$BUILD_DIR/bench_evdev" 3 >> "$RESULTS"
+else
+    skip bench_inject "libudev not found"
+    skip bench_evdev "libudev not found"
+fi
+
+# Also a check: the scheduler replays a week from each trace in bench/sim/
+# on a virtual clock (--simulate) and exits non-zero if an action ran late.
+# Any idle backend will do, none of them is used.
+SIM_FLAGS=""
+if [ -n "$UDEV_LIBS" ]; then
+    SIM_FLAGS="-DHAVE_EVDEV_IDLE $UDEV_LIBS"
+elif [ -n "$SYSTEMD_LIBS" ]; then
+    SIM_FLAGS="-DHAVE_GNOME_IDLE $SYSTEMD_LIBS"
+fi
+if [ -n "$SIM_FLAGS" ]; then
+    echo "building jigglemil" >&2
+    $CC $CFLAGS src/jigglemil.c -lm -lpthread $SIM_FLAGS -o "$BUILD_DIR/jigglemil" >&2
+    for trace in bench/sim/*.trace; do
+        "$BUILD_DIR/jigglemil" --simulate "$trace" --seed 42 > "$BUILD_DIR/sim.jsonl"
+        tail -n 1 "$BUILD_DIR/sim.jsonl" |
+            sed "s|^{|{\"bench\": \"simulate\", \"trace\": \"$(basename "$trace" .trace)\", |" >> "$RESULTS"
+    done
+else
+    skip simulate "libudev or libsystemd not found"
+fi
+
+# Also a check: three FIFO seats in one daemon, input into one of them;
+# fails unless each keeps its own state, status page and deadline
+if [ -n "$SIM_FLAGS" ]; then
+    CC="$CC" UDEV_LIBS="$UDEV_LIBS" SYSTEMD_LIBS="$SYSTEMD_LIBS" bench/check_seats.sh >> "$RESULTS"
+else
+    skip check_seats "libudev or libsystemd not found"
+fi
+
+# Also a check: the config file rewritten while a seat waits for its
+# deadline; fails if the reload redraws the pending deadline, the next one
+# is not from the new range or an invalid file is taken
+if [ -n "$SIM_FLAGS" ]; then
+    CC="$CC" UDEV_LIBS="$UDEV_LIBS" SYSTEMD_LIBS="$SYSTEMD_LIBS" bench/check_reload.sh >> "$RESULTS"
+else
+    skip check_reload "libudev or libsystemd not found"
+fi
+
+# Also a check: FIFO seats that do and do not see their own injection;
+# fails unless the key tap settles it where it is noticed, the chain falls
+# through to the path where not, and a jiggle nets zero
+if [ -n "$SIM_FLAGS" ]; then
+    CC="$CC" UDEV_LIBS="$UDEV_LIBS" SYSTEMD_LIBS="$SYSTEMD_LIBS" bench/check_actions.sh >> "$RESULTS"
+else
+    skip check_actions "libudev or libsystemd not found"
+fi
+
+# Also a check: daemon start / pause / resume / stop cycles against a mock
+# notification server and the notify-send fallback; fails on a lost
+# notification or a child left behind
+if [ -n "$SYSTEMD_LIBS" ] && command -v dbus-daemon &> /dev/null; then
+    CC="$CC" SYSTEMD_LIBS="$SYSTEMD_LIBS" bench/check_notify.sh >> "$RESULTS"
+else
+    skip check_notify "libsystemd or dbus-daemon not found"
+fi
+
+# Also a check: the GNOME idle backend against a stub Mutter IdleMonitor;
+# fails if GetIdletime or a WatchFired (idle or user-active) is lost
+if [ -n "$SYSTEMD_LIBS" ] && command -v dbus-daemon &> /dev/null; then
+    CC="$CC" SYSTEMD_LIBS="$SYSTEMD_LIBS" bench/check_gnome.sh >> "$RESULTS"
+else
+    skip check_gnome "libsystemd or dbus-daemon not found"
+fi
+
+# Also a check: park / resume on every logind reason, against a stub
+# logind on a private bus standing in for the system bus
+if [ -n "$SYSTEMD_LIBS" ] && command -v dbus-daemon &> /dev/null; then
+    CC="$CC" SYSTEMD_LIBS="$SYSTEMD_LIBS" bench/check_logind.sh >> "$RESULTS"
+else
+    skip check_logind "libsystemd or dbus-daemon not found"
+fi
+
+# Also a check: the Wayland idle backend against a mock compositor
+# (ext-idle-notify-v1); fails if idled / resumed do not reach the daemon
+if command -v wayland-scanner &> /dev/null &&
+        pkg-config --exists wayland-client wayland-server wayland-protocols; then
+    CC="$CC" bench/check_wayland.sh >> "$RESULTS"
+else
+    skip check_wayland "wayland-scanner, wayland-protocols or libwayland not found"
+fi
+
+# JSON lines -> one array, tagged with the commit it was measured on
+{
+    printf '{"commit": "%s", "date": "%s", "results": [\n' \
+        "$(git rev-parse --short HEAD 2>/dev/null || echo unknown)" "$(date -Iseconds)"
+    sed '$!s/$/,/' "$RESULTS" | sed 's/^/  /'
+    printf ']}\n'
+} > "$BUILD_DIR/report.json"
+
+if [ -n "$1" ]; then
+    cp "$BUILD_DIR/report.json" "$1"
+    echo "results written to $1" >&2
+else
+    cat "$BUILD_DIR/report.json"
+fi
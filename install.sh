@@ -135,20 +135,58 @@ if [ ! -f "src/jigglemil.c" ]; then
     exit 1
 fi
 
-USE_GNOME_IDLE_FLAG=""
-
-# Check if libinput is available
-if pkg-config --exists libinput; then
-    echo -e "  ${GREEN}✓${NC} libinput detected - using libinput idle method"
+# Idle backends: every one whose dependencies are present is compiled in,
+# the daemon picks one at runtime (--idle auto|wayland|gnome|evdev|libinput)
+IDLE_FLAGS=""
+IDLE_SRCS=""
+BUILD_DIR="$(mktemp -d)"
+trap 'rm -rf "$BUILD_DIR"' EXIT
+
+if pkg-config --exists libinput libudev; then
+    echo -e "  ${GREEN}✓${NC} libinput detected - libinput idle backend"
+    IDLE_FLAGS="$IDLE_FLAGS -DHAVE_LIBINPUT $(pkg-config --cflags --libs libinput libudev)"
 elif [ -e /dev/input/event0 ]; then
-    echo -e "  ${GREEN}✓${NC} /dev/input devices found - using libinput idle method"
-else
-    # fallback to GNOME idle detection
-    echo -e "  ${YELLOW}⚠ libinput not found - using GNOME idle method${NC}"
-    USE_GNOME_IDLE_FLAG="-DUSE_GNOME_IDLE"
+    echo -e "  ${GREEN}✓${NC} /dev/input devices found - libinput idle backend"
+    IDLE_FLAGS="$IDLE_FLAGS -DHAVE_LIBINPUT -linput -ludev"
+fi
+
+if pkg-config --exists libudev; then
+    echo -e "  ${GREEN}✓${NC} libudev detected - raw evdev idle backend"
+    IDLE_FLAGS="$IDLE_FLAGS -DHAVE_EVDEV_IDLE $(pkg-config --cflags --libs libudev)"
+fi
+
+if pkg-config --exists libsystemd; then
+    echo -e "  ${GREEN}✓${NC} sd-bus detected - GNOME idle backend, logind parking, D-Bus notifications"
+    IDLE_FLAGS="$IDLE_FLAGS -DHAVE_GNOME_IDLE -DHAVE_LOGIND -DHAVE_DBUS_NOTIFY $(pkg-config --cflags --libs libsystemd)"
+fi
+
+# ext-idle-notify-v1 (wayland-protocols) + optional KDE idle (plasma-wayland-protocols)
+WL_PROTOCOLS="$(pkg-config --variable=pkgdatadir wayland-protocols 2>/dev/null)"
+EXT_IDLE_XML="$WL_PROTOCOLS/staging/ext-idle-notify/ext-idle-notify-v1.xml"
+if pkg-config --exists wayland-client && command -v wayland-scanner &> /dev/null \
+        && [ -f "$EXT_IDLE_XML" ]; then
+    echo -e "  ${GREEN}✓${NC} wayland-protocols detected - Wayland idle backend"
+    wayland-scanner client-header "$EXT_IDLE_XML" "$BUILD_DIR/ext-idle-notify-v1-client-protocol.h"
+    wayland-scanner private-code  "$EXT_IDLE_XML" "$BUILD_DIR/ext-idle-notify-v1-protocol.c"
+    IDLE_SRCS="$IDLE_SRCS $BUILD_DIR/ext-idle-notify-v1-protocol.c"
+    IDLE_FLAGS="$IDLE_FLAGS -DHAVE_WAYLAND_IDLE -I$BUILD_DIR $(pkg-config --cflags --libs wayland-client)"
+
+    KDE_IDLE_XML="$(pkg-config --variable=pkgdatadir plasma-wayland-protocols 2>/dev/null)/idle.xml"
+    if [ -f "$KDE_IDLE_XML" ]; then
+        echo -e "  ${GREEN}✓${NC} plasma-wayland-protocols detected - KDE idle fallback"
+        wayland-scanner client-header "$KDE_IDLE_XML" "$BUILD_DIR/kde-idle-client-protocol.h"
+        wayland-scanner private-code  "$KDE_IDLE_XML" "$BUILD_DIR/kde-idle-protocol.c"
+        IDLE_SRCS="$IDLE_SRCS $BUILD_DIR/kde-idle-protocol.c"
+        IDLE_FLAGS="$IDLE_FLAGS -DHAVE_KDE_IDLE"
+    fi
+fi
+
+if [ -z "$IDLE_FLAGS" ]; then
+    echo -e "  ${RED}✗${NC} No idle backend available (need libinput, libsystemd or wayland-client)"
+    exit 1
 fi
 
-gcc -Wall -Wextra -O2 -std=c11 src/jigglemil.c -lm -linput -ludev $USE_GNOME_IDLE_FLAG -o jigglemil
+gcc -Wall -Wextra -O2 -fno-math-errno -fno-trapping-math -std=c11 src/jigglemil.c $IDLE_SRCS -lm -lpthread $IDLE_FLAGS -o jigglemil
 echo -e "  ${GREEN}✓${NC} Compilation successful"
 
 # ============================================================================
@@ -247,8 +285,8 @@ echo -e "  ${GREEN}✓${NC} User service installed: ~/.config/systemd/user/jiggl
 # STEP 6: Ensure user is in 'input' group for libinput method
 # ============================================================================
 
-if [ -f "src/idle_detector_libinput.h" ]; then
-    echo -e "${YELLOW}[!]${NC} Libinput method detected, checking 'input' group..."
+if [[ "$IDLE_FLAGS" == *HAVE_LIBINPUT* || "$IDLE_FLAGS" == *HAVE_EVDEV_IDLE* ]]; then
+    echo -e "${YELLOW}[!]${NC} Raw input backend compiled in, checking 'input' group..."
     if id -nG "$ACTUAL_USER" | grep -qw "input"; then
         echo -e "  ${GREEN}✓${NC} User '$ACTUAL_USER' is already in 'input' group"
     else
@@ -282,5 +320,5 @@ if [[ "$XDG_CURRENT_DESKTOP" =~ GNOME ]]; then
     echo
 fi
 echo "Monitor:"
-echo -e "  ${YELLOW}tail -f /tmp/jigglemil.log${NC}           # Live logs"
+echo -e "  ${YELLOW}tail -f \$XDG_RUNTIME_DIR/jigglemil.log${NC}  # Live logs"
 echo
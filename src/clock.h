@@ -0,0 +1,29 @@
+// Shared time helpers for Jigglemil
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <time.h>
+
+// ----------------------------
+// Idle-time clock in ms. CLOCK_BOOTTIME keeps counting through suspend,
+// so the idle time after a resume includes the time spent asleep (the
+// monotonic clocks stop while suspended).
+// ----------------------------
+static inline unsigned long now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    return (unsigned long)ts.tv_sec * 1000ul +
+           (unsigned long)ts.tv_nsec / 1000000ul;
+}
+
+// ----------------------------
+// Precise monotonic time in ns (for measurements)
+// ----------------------------
+static inline long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000ll + ts.tv_nsec;
+}
+
+#endif // CLOCK_H
@@ -0,0 +1,113 @@
+// Frame coalescing for Jigglemil path playback
+// The compositor samples the cursor once per frame, so deltas injected
+// within a single frame interval are indistinguishable from their sum.
+// The coalescer sits between a PathStream and the executors. It bins the
+// stream's points by planned time into frames of 1/hz seconds and emits one
+// packed point per non-empty frame: the summed delta, fired when the first
+// point of that frame would have fired.
+//
+// Nothing is rounded. Deltas are whole pixels; the generator and the
+// recorder keep their own sub-pixel remainders. A frame whose sum does not
+// fit a packed point (|d| > 127) puts the excess in the carry, which goes
+// out in the next frame. The summed displacement is therefore exact, and
+// the timing profile moves by less than one frame.
+
+#ifndef COALESCE_H
+#define COALESCE_H
+
+#include <stdint.h>
+
+#include "windmouse.h"
+
+typedef struct {
+    PathStream *src;
+    long        frame_us;   /* 0 = pass points through */
+    long        fixed_us;   /* > 0: treat every input delay as this (batch) */
+
+    PackedPoint next;       /* look-ahead input point */
+    int         have_next;
+    long long   next_t;     /* its planned time (us from path start) */
+    long long   t;          /* planned time of the point being built */
+    int         carry_x, carry_y;
+
+    int         in;         /* input points consumed */
+    int         out;        /* points emitted */
+} Coalescer;
+
+static inline long coalesce_frame_us(int hz) {
+    return hz > 0 ? (1000000l + hz / 2) / hz : 0;
+}
+
+static void coalesce_init(Coalescer *c, PathStream *src, int hz, long fixed_us) {
+    c->src       = src;
+    c->frame_us  = coalesce_frame_us(hz);
+    c->fixed_us  = fixed_us;
+    c->have_next = 0;
+    c->next_t    = 0;
+    c->t         = 0;
+    c->carry_x   = c->carry_y = 0;
+    c->in        = 0;
+    c->out       = 0;
+}
+
+static int coalesce_fetch(Coalescer *c) {
+    c->have_next = stream_pop(c->src, &c->next);
+    return c->have_next;
+}
+
+static inline int8_t coalesce_take(int *v) {
+    int d = *v > INT8_MAX ? INT8_MAX : *v < -INT8_MAX ? -INT8_MAX : *v;
+    *v -= d;
+    return (int8_t)d;
+}
+
+// ----------------------------
+// Public: next point to play (delay_us = time to the point after it)
+// ----------------------------
+static int coalesce_pop(Coalescer *c, PackedPoint *out) {
+    if (c->frame_us <= 0) {
+        if (!stream_pop(c->src, out))
+            return 0;
+        c->in++;
+        c->out++;
+        return 1;
+    }
+
+    if (!c->have_next && c->in == 0)
+        coalesce_fetch(c);
+    if (!c->have_next && c->carry_x == 0 && c->carry_y == 0)
+        return 0;
+
+    int sx = c->carry_x, sy = c->carry_y;
+    long long start = c->t;
+
+    if (c->have_next) {
+        /* everything planned inside this point's frame */
+        start = c->next_t;
+        long long frame = start / c->frame_us;
+        do {
+            sx += c->next.dx;
+            sy += c->next.dy;
+            c->next_t += c->fixed_us > 0 ? c->fixed_us : c->next.delay_us;
+            c->in++;
+        } while (coalesce_fetch(c) && c->next_t / c->frame_us == frame);
+    }
+
+    c->carry_x = sx;
+    c->carry_y = sy;
+    out->dx = coalesce_take(&c->carry_x);
+    out->dy = coalesce_take(&c->carry_y);
+
+    /* fire the next frame when its first point was due; a carry goes
+     * out one frame later */
+    long long next = c->have_next ? c->next_t
+                   : (c->carry_x || c->carry_y) ? start + c->frame_us : start;
+    long long gap = next - start;
+    out->delay_us = (uint16_t)(gap < UINT16_MAX ? gap : UINT16_MAX);
+
+    c->t = next;
+    c->out++;
+    return 1;
+}
+
+#endif // COALESCE_H
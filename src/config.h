@@ -4,17 +4,96 @@
 // ============================================================================
 // FILE PATHS
 // ============================================================================
-#define STATE_FILE      "/tmp/jigglemil.state"
-#define LOG_FILE        "/tmp/jigglemil.log"
-#define PID_FILE        "/tmp/jigglemil.pid"
+// Names in the runtime directory: $XDG_RUNTIME_DIR, else a private
+// RUNTIME_DIR_FALLBACK (runtime_dir.h). The first three can be overridden
+// with -D; an absolute path is taken as is (benchmarks use /dev/null).
+#define RUNTIME_DIR_FALLBACK "/tmp/jigglemil-%u"     // %u = uid, created 0700
+#ifndef STATE_FILE
+#define STATE_FILE      "jigglemil.state"
+#endif
+#ifndef LOG_FILE
+#define LOG_FILE        "jigglemil.log"
+#endif
+#ifndef PID_FILE
+#define PID_FILE        "jigglemil.pid"
+#endif
+#define STATS_FILE      "jigglemil.stats"     // JSON, refreshed per action and on SIGUSR1
+#define CONTROL_SOCKET_NAME "jigglemil.sock"
+#define STATUS_PAGE_NAME    "jigglemil.status"        // --status-page
+#define YDOTOOL_SOCKET_PATH "/tmp/.ydotool_socket"
+#define CONFIG_FILE_NAME    "jigglemil/jigglemil.conf" // in $XDG_CONFIG_HOME (~/.config), --config overrides
+
+// ============================================================================
+// LOGGING
+// ============================================================================
+#define LOG_MAX_BYTES       (1024 * 1024)   // rotate the log past this size
+#define LOG_KEEP            3               // rotated logs kept (.1 .. .3)
+#define LOG_RING_SLOTS      256             // lines buffered ahead of the writer
+#define LOG_FLUSH_MS        250             // writer thread flush interval
+
+// ============================================================================
+// MOTION CORPUS (--record / --replay, libinput idle backend)
+// ============================================================================
+#define CORPUS_GAP_MS       60          // motion pause that ends a segment
+#define CORPUS_MIN_POINTS   8           // shorter segments are not kept
+#define CORPUS_MIN_DIST     16.0        // nor ones that barely move (px)
+
+// ============================================================================
+// UINPUT BACKEND (--uinput)
+// ============================================================================
+#define UINPUT_PATH         "/dev/uinput"
+#define UINPUT_DEVICE_NAME  "Jigglemil Virtual Pointer"
+#define UINPUT_VENDOR_ID    0x1209
+#define UINPUT_PRODUCT_ID   0x4a47
 
 // ============================================================================
 // TIMERS (in milliseconds)
 // ============================================================================
+// These, the action timings and the WindMouse ranges below are defaults:
+// the config file overrides them at runtime, reloaded on save (settings.h)
 #define WARNING_LIMIT_MS    30000       // 30s  - red warning starts
 #define MIN_ACTION_MS       87000       // 87s  - minimum idle before action
 #define MAX_ACTION_MS       180000      // 180s - maximum idle before action
-#define CHECK_INTERVAL_SEC  1           // how often to check idle time
+#define CHECK_INTERVAL_SEC  1           // watch mode: re-sample idle time (daemon itself sleeps until the next transition)
+#define WATCH_REFRESH_MS    100         // watch mode: dashboard redraw interval (only changed cells are sent)
+
+// ============================================================================
+// IDLE DETECTION
+// ============================================================================
+#define EVDEV_HOLDOFF_MS    200         // evdev: after activity, skip reads this long
+
+// ============================================================================
+// SEATS (--seat; one daemon, several seats on one event loop)
+// ============================================================================
+#define SEAT_DEFAULT        "seat0"     // seat without $XDG_SEAT or ID_SEAT
+#define SEAT_MAX            16          // seats per daemon
+#define SEAT_MAX_INPUTS     32          // input nodes per seat
+#define SEAT_STATE_FILE     "jigglemil.%s.state"    // per seat, %s = seat name
+#define SEAT_STATUS_PAGE    "jigglemil.%s.status"   // per seat (--status-page)
+
+// ============================================================================
+// SIMULATION (--simulate; virtual clock, scripted activity)
+// ============================================================================
+#define SIM_MAX_LATE_MS     1000        // an action this far past its threshold fails the run
+
+// ============================================================================
+// PLAYBACK PACING
+// ============================================================================
+#define PLAYBACK_TIMERSLACK_NS  1000    // timer slack while a path plays
+#define PLAYBACK_RT_PRIORITY    10      // SCHED_FIFO priority with --rt
+#define COALESCE_HZ             60      // one injection per frame at this refresh rate (--fps; 0 = off)
+
+// ============================================================================
+// ACTIONS (--action; cheapest first: key, jiggle, path)
+// ============================================================================
+#define ACTION_MODE         "auto"      // auto = cheapest action that still resets the idle time
+#define MICRO_KEY           KEY_F15     // key action: tapped key, unbound on most desktops (linux/input-event-codes.h)
+#define MICRO_KEY_HOLD_MS   40          // key action: press -> release
+#define JIGGLE_STEPS        3           // jiggle action: moves out, then the same moves back (net zero)
+#define JIGGLE_RADIUS_PX    6           // jiggle action: furthest point from the start
+#define MICRO_VERIFY_MS     500         // wait this long for the idle time to drop after an action
+#define MICRO_IDLE_SLACK_MS 100         // idle time may lag the action by this much and still count
+#define MICRO_RETRY_ACTIONS 10          // after a miss, skip that action for this many actions
 
 // ============================================================================
 // WINDMOUSE PARAMETERS (randomized for human-like variance)
@@ -32,3 +111,7 @@
 #define MAX_PATH_POINTS     1783
 #define MIN_DELAY_US        5000
 #define MAX_DELAY_US        15000
+#define PATH_RING_SIZE      64          // points generated ahead of playback
+#define WIND_CANDIDATES     8           // paths generated per move, best fit is played (1 = off)
+#define WIND_TARGET_POINTS  400         // preferred path length in points
+#define WIND_TARGET_DURATION_MS 4000    // preferred path duration
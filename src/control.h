@@ -0,0 +1,168 @@
+// Control socket for Jigglemil
+// A SOCK_SEQPACKET Unix socket: the client sends one command, the daemon
+// answers with one message and closes. Status bars and the jiggler wrapper
+// use this instead of pgrep / cat / pkill, so a poll is a single connect
+// round-trip and nothing goes stale when the daemon dies.
+//
+// The socket lives in the runtime directory (runtime_dir.h: per-user,
+// 0700); only the owning user (or root) is answered.
+
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "runtime_dir.h"
+
+#define CTL_MSG_MAX 4096
+
+/* returns reply length; the request is NUL-terminated, trailing newline cut */
+typedef int (*CtlHandler)(const char *req, char *reply, size_t size);
+
+static int ctl_listen_fd = -1;
+static char ctl_path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+
+// ----------------------------
+// Socket location: jigglemil.sock in the runtime directory (empty without one)
+// ----------------------------
+static void control_socket_path(char *buf, size_t size) {
+    runtime_path(buf, size, CONTROL_SOCKET_NAME);
+}
+
+static int ctl_connect(const char *path) {
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return -1;
+
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// ----------------------------
+// Public (daemon): bind the socket; -1 with EADDRINUSE if a daemon answers
+// ----------------------------
+static int ctl_open(const char *path) {
+    snprintf(ctl_path, sizeof(ctl_path), "%s", path);
+
+    /* a live daemon owns it; a dead one left a stale node behind */
+    int probe = ctl_connect(ctl_path);
+    if (probe >= 0) {
+        close(probe);
+        errno = EADDRINUSE;
+        return -1;
+    }
+    unlink(ctl_path);
+
+    ctl_listen_fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (ctl_listen_fd < 0)
+        return -1;
+
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", ctl_path);
+
+    mode_t old = umask(0077);
+    int r = bind(ctl_listen_fd, (struct sockaddr *)&addr, sizeof(addr));
+    umask(old);
+
+    if (r != 0 || listen(ctl_listen_fd, 16) != 0) {
+        close(ctl_listen_fd);
+        ctl_listen_fd = -1;
+        return -1;
+    }
+    return ctl_listen_fd;
+}
+
+static void ctl_close(void) {
+    if (ctl_listen_fd < 0)
+        return;
+    close(ctl_listen_fd);
+    ctl_listen_fd = -1;
+    unlink(ctl_path);
+}
+
+// ----------------------------
+// Public (daemon): answer one client. Returns 1 if the request had not
+// arrived yet (fd stays open, call again when readable), 0 when done.
+// ----------------------------
+static int ctl_serve(int fd, CtlHandler handler) {
+    char req[256];
+    static char reply[CTL_MSG_MAX];
+
+    ssize_t n = recv(fd, req, sizeof(req) - 1, MSG_DONTWAIT);
+    if (n < 0 && (errno == EAGAIN || errno == EINTR))
+        return 1;
+
+    if (n > 0) {
+        req[n] = '\0';
+        req[strcspn(req, "\r\n")] = '\0';
+
+        int len = handler(req, reply, sizeof(reply));
+        if (len > 0)
+            send(fd, reply, (size_t)len, MSG_NOSIGNAL | MSG_DONTWAIT);
+    }
+    close(fd);
+    return 0;
+}
+
+// ----------------------------
+// Public (daemon): accept one pending client (-1 when none is waiting)
+// ----------------------------
+static int ctl_accept(void) {
+    if (ctl_listen_fd < 0)
+        return -1;
+
+    for (;;) {
+        int fd = accept4(ctl_listen_fd, NULL, NULL, SOCK_CLOEXEC | SOCK_NONBLOCK);
+        if (fd < 0)
+            return -1;
+
+        struct ucred cred;
+        socklen_t len = sizeof(cred);
+        if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) == 0 &&
+            (cred.uid == getuid() || cred.uid == 0))
+            return fd;
+
+        close(fd);    /* someone else's process */
+    }
+}
+
+// ----------------------------
+// Public (client): one request, one reply. Returns reply length, -1 if no
+// daemon is listening.
+// ----------------------------
+static int ctl_request(const char *cmd, char *reply, size_t size) {
+    char path[sizeof(ctl_path)];
+    control_socket_path(path, sizeof(path));
+
+    int fd = ctl_connect(path);
+    if (fd < 0)
+        return -1;
+
+    /* the loop answers between two points of a path; don't hang on a wedged daemon */
+    struct timeval tv = { .tv_sec = 5, .tv_usec = 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    ssize_t n = -1;
+    if (send(fd, cmd, strlen(cmd), MSG_NOSIGNAL) >= 0)
+        n = recv(fd, reply, size - 1, 0);
+    close(fd);
+
+    if (n < 0)
+        return -1;
+    reply[n] = '\0';
+    return (int)n;
+}
+
+#endif // CONTROL_H
@@ -0,0 +1,416 @@
+// Motion corpus for Jigglemil (--record / --replay)
+// The recorder cuts the user's own pointer motion into segments: runs of
+// motion with no gap longer than CORPUS_GAP_MS and no click or key press.
+// Each segment is appended to a binary corpus file as packed points (the
+// same 4-byte form the player uses).
+//
+// The file starts with a fixed index header. Segments are classed by
+// log2(points) x log2(net displacement). Every class keeps a reservoir of
+// CORPUS_RESERVOIR segment offsets, maintained by reservoir sampling, so
+// each slot is a uniform draw from everything ever recorded in that
+// class. The player mmaps the file and reads one header slot. Picking a
+// segment is O(1) whether the corpus holds a hundred segments or ten
+// million, and unused segments are never paged in.
+//
+// Append order is data first, then the header fields. A crash leaves at
+// worst an unindexed tail, which the next append overwrites.
+
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "clock.h"
+#include "rng.h"
+#include "windmouse.h"
+
+#define CORPUS_MAGIC        0x434c474au     /* "JGLC" */
+#define CORPUS_VERSION      1
+#define CORPUS_SEG_MAGIC    0x4a53          /* "SJ", start of every segment */
+#define CORPUS_LEN_CLASSES  12              /* log2(points): up to 4095 */
+#define CORPUS_DIST_CLASSES 12              /* log2(|net| px): up to 4095 */
+#define CORPUS_RESERVOIR    32
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t segments;
+    uint64_t end;           /* append offset */
+    uint64_t count[CORPUS_LEN_CLASSES][CORPUS_DIST_CLASSES];
+    uint64_t slot[CORPUS_LEN_CLASSES][CORPUS_DIST_CLASSES][CORPUS_RESERVOIR];
+} CorpusHeader;
+
+typedef struct {
+    uint16_t magic;
+    uint16_t count;
+    int16_t  net_dx;
+    int16_t  net_dy;
+    /* PackedPoint points[count] */
+} CorpusSegment;
+
+_Static_assert(sizeof(CorpusSegment) % sizeof(PackedPoint) == 0, "points stay aligned");
+_Static_assert(MAX_PATH_POINTS < (1 << CORPUS_LEN_CLASSES), "length classes cover every path");
+
+static inline int corpus_class(double v, int classes) {
+    int c = v >= 1 ? 63 - __builtin_clzll((uint64_t)v) : 0;
+    return c < classes ? c : classes - 1;
+}
+
+// ============================================================================
+// WRITER
+// ============================================================================
+
+typedef struct {
+    int          fd;
+    CorpusHeader hdr;
+    Rng          rng;       /* reservoir replacement */
+} CorpusWriter;
+
+static int corpus_writer_open(CorpusWriter *w, const char *path) {
+    w->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (w->fd < 0)
+        return -1;
+
+    ssize_t n = pread(w->fd, &w->hdr, sizeof(w->hdr), 0);
+    if (n == 0) {
+        memset(&w->hdr, 0, sizeof(w->hdr));
+        w->hdr.magic   = CORPUS_MAGIC;
+        w->hdr.version = CORPUS_VERSION;
+        w->hdr.end     = sizeof(CorpusHeader);
+        if (pwrite(w->fd, &w->hdr, sizeof(w->hdr), 0) != (ssize_t)sizeof(w->hdr))
+            goto fail;
+    } else if (n != (ssize_t)sizeof(w->hdr) || w->hdr.magic != CORPUS_MAGIC ||
+               w->hdr.version != CORPUS_VERSION) {
+        goto fail;      /* not ours: never overwrite it */
+    }
+
+    rng_seed(&w->rng, (uint64_t)now_ns() ^ (uint64_t)getpid());
+    return 0;
+
+fail:
+    close(w->fd);
+    w->fd = -1;
+    return -1;
+}
+
+static void corpus_writer_close(CorpusWriter *w) {
+    if (w->fd >= 0)
+        close(w->fd);
+    w->fd = -1;
+}
+
+static int corpus_put(int fd, const void *buf, size_t len, uint64_t off) {
+    return pwrite(fd, buf, len, (off_t)off) == (ssize_t)len ? 0 : -1;
+}
+
+// Append one segment and index it
+static int corpus_append(CorpusWriter *w, const PackedPoint *pts, int count) {
+    if (count <= 0 || count > MAX_PATH_POINTS)
+        return -1;
+
+    CorpusSegment seg = { .magic = CORPUS_SEG_MAGIC, .count = (uint16_t)count };
+    int sx = 0, sy = 0;
+    for (int i = 0; i < count; i++) {
+        sx += pts[i].dx;
+        sy += pts[i].dy;
+    }
+    if (sx < INT16_MIN || sx > INT16_MAX || sy < INT16_MIN || sy > INT16_MAX)
+        return -1;
+    seg.net_dx = (int16_t)sx;
+    seg.net_dy = (int16_t)sy;
+
+    uint64_t off = w->hdr.end;
+    if (corpus_put(w->fd, &seg, sizeof(seg), off) != 0 ||
+        corpus_put(w->fd, pts, sizeof(PackedPoint) * (size_t)count, off + sizeof(seg)) != 0)
+        return -1;
+
+    int lc = corpus_class(count, CORPUS_LEN_CLASSES);
+    int dc = corpus_class(hypot(sx, sy), CORPUS_DIST_CLASSES);
+    uint64_t seen = w->hdr.count[lc][dc]++;
+    int slot = -1;
+    if (seen < CORPUS_RESERVOIR) {
+        slot = (int)seen;
+    } else {
+        uint64_t j = rng_next(&w->rng) % (seen + 1);
+        if (j < CORPUS_RESERVOIR)
+            slot = (int)j;
+    }
+
+    w->hdr.segments++;
+    w->hdr.end = off + sizeof(seg) + sizeof(PackedPoint) * (size_t)count;
+
+    /* index the data only once it is on disk */
+    const uint8_t *base = (const uint8_t *)&w->hdr;
+    if (slot >= 0) {
+        w->hdr.slot[lc][dc][slot] = off;
+        if (corpus_put(w->fd, &w->hdr.slot[lc][dc][slot], sizeof(uint64_t),
+                       (uint64_t)((const uint8_t *)&w->hdr.slot[lc][dc][slot] - base)) != 0)
+            return -1;
+    }
+    corpus_put(w->fd, &w->hdr.count[lc][dc], sizeof(uint64_t),
+               (uint64_t)((const uint8_t *)&w->hdr.count[lc][dc] - base));
+    corpus_put(w->fd, &w->hdr.segments, sizeof(uint64_t), offsetof(CorpusHeader, segments));
+    return corpus_put(w->fd, &w->hdr.end, sizeof(uint64_t), offsetof(CorpusHeader, end));
+}
+
+// ============================================================================
+// RECORDER (fed from the input thread)
+// ============================================================================
+
+typedef struct {
+    CorpusWriter w;
+    PackedPoint  pts[MAX_PATH_POINTS];
+    int          count;
+    double       fx, fy;        /* sub-pixel remainder */
+    uint64_t     last_us;       /* previous motion event */
+    uint64_t     point_us;      /* previous emitted point */
+} CorpusRecorder;
+
+static CorpusRecorder corpus_rec = { .w = { .fd = -1 } };
+static atomic_int corpus_recording = 0;
+/* input thread vs. shutdown; never contended while recording */
+static pthread_mutex_t corpus_rec_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int corpus_record_open(const char *path) {
+    if (corpus_writer_open(&corpus_rec.w, path) != 0)
+        return -1;
+    atomic_store(&corpus_recording, 1);
+    return 0;
+}
+
+// Close the segment in progress; keep it if it is long enough to be useful
+static void corpus_record_flush(void) {
+    CorpusRecorder *r = &corpus_rec;
+
+    if (r->count >= CORPUS_MIN_POINTS) {
+        int sx = 0, sy = 0;
+        for (int i = 0; i < r->count; i++) {
+            sx += r->pts[i].dx;
+            sy += r->pts[i].dy;
+        }
+        if (hypot(sx, sy) >= CORPUS_MIN_DIST) {
+            r->pts[r->count - 1].delay_us = 0;
+            corpus_append(&r->w, r->pts, r->count);
+        }
+    }
+    r->count = 0;
+    r->fx = r->fy = 0;
+    r->last_us = 0;
+}
+
+// Public (input thread): a click, key or scroll ends the segment
+static inline void corpus_record_break(void) {
+    if (!atomic_load_explicit(&corpus_recording, memory_order_relaxed))
+        return;
+    pthread_mutex_lock(&corpus_rec_lock);
+    if (corpus_rec.w.fd >= 0)
+        corpus_record_flush();
+    pthread_mutex_unlock(&corpus_rec_lock);
+}
+
+static void corpus_record_point(double dx, double dy, uint64_t time_us) {
+    CorpusRecorder *r = &corpus_rec;
+
+    if (r->last_us && time_us - r->last_us > CORPUS_GAP_MS * 1000ull)
+        corpus_record_flush();
+    if (!r->last_us)
+        r->point_us = time_us;
+    r->last_us = time_us;
+
+    r->fx += dx;
+    r->fy += dy;
+    int ix = (int)lround(r->fx), iy = (int)lround(r->fy);
+    if (ix == 0 && iy == 0)
+        return;     /* sub-pixel: carry it into the next event */
+
+    if (abs(ix) > INT8_MAX || abs(iy) > INT8_MAX) {
+        r->count = 0;   /* a jump no packed point can hold: drop the segment */
+        corpus_record_flush();
+        return;
+    }
+    r->fx -= ix;
+    r->fy -= iy;
+
+    if (r->count > 0) {
+        uint64_t gap = time_us - r->point_us;
+        r->pts[r->count - 1].delay_us = (uint16_t)(gap < UINT16_MAX ? gap : UINT16_MAX);
+    }
+    r->point_us = time_us;
+    r->pts[r->count++] = (PackedPoint){ .dx = (int8_t)ix, .dy = (int8_t)iy, .delay_us = 0 };
+
+    if (r->count == MAX_PATH_POINTS)
+        corpus_record_flush();
+}
+
+// Public (input thread): one relative motion event (device units, unaccelerated)
+static inline void corpus_record_motion(double dx, double dy, uint64_t time_us) {
+    if (!atomic_load_explicit(&corpus_recording, memory_order_relaxed))
+        return;
+    pthread_mutex_lock(&corpus_rec_lock);
+    if (corpus_rec.w.fd >= 0)
+        corpus_record_point(dx, dy, time_us);
+    pthread_mutex_unlock(&corpus_rec_lock);
+}
+
+// Public: keep the segment in progress and stop recording
+static void corpus_record_close(void) {
+    if (!atomic_exchange(&corpus_recording, 0))
+        return;
+    pthread_mutex_lock(&corpus_rec_lock);
+    corpus_record_flush();
+    corpus_writer_close(&corpus_rec.w);
+    pthread_mutex_unlock(&corpus_rec_lock);
+}
+
+// ============================================================================
+// PLAYER (mmap, O(1) pick)
+// ============================================================================
+
+typedef struct {
+    int            fd;
+    const uint8_t *map;
+    size_t         size;
+} Corpus;
+
+static int corpus_map(Corpus *c) {
+    struct stat st;
+    if (fstat(c->fd, &st) != 0 || st.st_size < (off_t)sizeof(CorpusHeader))
+        return -1;
+    if (c->map && (size_t)st.st_size == c->size)
+        return 0;
+
+    if (c->map)
+        munmap((void *)c->map, c->size);
+    c->map = NULL;
+
+    void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, c->fd, 0);
+    if (p == MAP_FAILED)
+        return -1;
+    c->map  = p;
+    c->size = (size_t)st.st_size;
+    return 0;
+}
+
+static int corpus_open(Corpus *c, const char *path) {
+    c->map  = NULL;
+    c->size = 0;
+    c->fd   = open(path, O_RDONLY | O_CLOEXEC);
+    if (c->fd < 0)
+        return -1;
+
+    const CorpusHeader *h;
+    if (corpus_map(c) != 0 ||
+        (h = (const CorpusHeader *)c->map)->magic != CORPUS_MAGIC ||
+        h->version != CORPUS_VERSION) {
+        if (c->map)
+            munmap((void *)c->map, c->size);
+        close(c->fd);
+        c->fd = -1;
+        c->map = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+static void corpus_close(Corpus *c) {
+    if (c->map)
+        munmap((void *)c->map, c->size);
+    if (c->fd >= 0)
+        close(c->fd);
+    c->map = NULL;
+    c->fd  = -1;
+}
+
+static uint64_t corpus_segments(const Corpus *c) {
+    return c->map ? ((const CorpusHeader *)c->map)->segments : 0;
+}
+
+// Segment at off, or NULL if the offset does not hold a whole segment
+static const CorpusSegment *corpus_segment(const Corpus *c, uint64_t off) {
+    if (off < sizeof(CorpusHeader) || off + sizeof(CorpusSegment) > c->size ||
+        off % sizeof(PackedPoint) != 0)
+        return NULL;
+
+    const CorpusSegment *s = (const CorpusSegment *)(c->map + off);
+    if (s->magic != CORPUS_SEG_MAGIC || s->count == 0 || s->count > MAX_PATH_POINTS ||
+        off + sizeof(*s) + sizeof(PackedPoint) * s->count > c->size)
+        return NULL;
+    return s;
+}
+
+// ----------------------------
+// Public: copy a recorded segment close to want_points long whose net
+// displacement is close to (tx, ty) into out. The segment is mirrored /
+// transposed (8 symmetries) to head the right way. Classes are searched
+// outward from the wanted one: at most a fixed number of slot reads.
+// Returns the point count, 0 if the corpus is empty.
+// ----------------------------
+static int corpus_pick(Corpus *c, Rng *rng, int want_points, double tx, double ty,
+                       PackedPoint *out) {
+    if (corpus_map(c) != 0)     /* the recorder may have grown the file */
+        return 0;
+
+    const CorpusHeader *h = (const CorpusHeader *)c->map;
+    int lc = corpus_class(want_points, CORPUS_LEN_CLASSES);
+    int dc = corpus_class(hypot(tx, ty), CORPUS_DIST_CLASSES);
+
+    const CorpusSegment *seg = NULL;
+    for (int ring = 0; !seg && ring < CORPUS_LEN_CLASSES + CORPUS_DIST_CLASSES; ring++) {
+        /* prefer the right distance over the right length */
+        for (int dd = -ring; !seg && dd <= ring; dd++) {
+            int dl = ring - abs(dd);
+            for (int sign = -1; !seg && sign <= 1; sign += 2) {
+                int l = lc + sign * dl, d = dc + dd;
+                if (l < 0 || l >= CORPUS_LEN_CLASSES || d < 0 || d >= CORPUS_DIST_CLASSES)
+                    continue;
+
+                uint64_t n = h->count[l][d];
+                if (n > CORPUS_RESERVOIR) n = CORPUS_RESERVOIR;
+                if (n > 0)
+                    seg = corpus_segment(c, h->slot[l][d][rng_next(rng) % n]);
+                if (dl == 0)
+                    break;
+            }
+        }
+    }
+    if (!seg)
+        return 0;
+
+    /* symmetry whose net vector points closest to the target */
+    int best = 0;
+    double best_dot = -1e300;
+    for (int t = 0; t < 8; t++) {
+        double x = (t & 4) ? seg->net_dy : seg->net_dx;
+        double y = (t & 4) ? seg->net_dx : seg->net_dy;
+        if (t & 1) x = -x;
+        if (t & 2) y = -y;
+        double dot = x * tx + y * ty;
+        if (dot > best_dot) {
+            best_dot = dot;
+            best = t;
+        }
+    }
+
+    const PackedPoint *src = (const PackedPoint *)(seg + 1);
+    for (int i = 0; i < seg->count; i++) {
+        int8_t x = (best & 4) ? src[i].dy : src[i].dx;
+        int8_t y = (best & 4) ? src[i].dx : src[i].dy;
+        out[i].dx       = (best & 1) ? (int8_t)-x : x;
+        out[i].dy       = (best & 2) ? (int8_t)-y : y;
+        out[i].delay_us = src[i].delay_us;
+    }
+    return seg->count;
+}
+
+#endif // CORPUS_H
@@ -0,0 +1,124 @@
+// Idle detector selection for Jigglemil
+// Every compiled-in backend registers here; the daemon picks one at runtime
+// (--idle NAME), or tries them in order of least privilege needed.
+//
+// Backends are compiled in with HAVE_LIBINPUT / HAVE_EVDEV_IDLE /
+// HAVE_GNOME_IDLE / HAVE_WAYLAND_IDLE (install.sh sets them from pkg-config).
+
+#ifndef IDLE_DETECTOR_H
+#define IDLE_DETECTOR_H
+
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(HAVE_LIBINPUT) && !defined(HAVE_EVDEV_IDLE) && \
+    !defined(HAVE_GNOME_IDLE) && !defined(HAVE_WAYLAND_IDLE)
+#define HAVE_LIBINPUT
+#endif
+
+#ifdef HAVE_WAYLAND_IDLE
+#include "idle_detector_wayland.h"
+#endif
+#ifdef HAVE_GNOME_IDLE
+#include "idle_detector_gnome.h"
+#endif
+#ifdef HAVE_EVDEV_IDLE
+#include "idle_detector_evdev.h"
+#endif
+#ifdef HAVE_LIBINPUT
+#include "idle_detector_libinput.h"
+#endif
+
+typedef struct {
+    const char *name;
+    int  (*init)(int wake_fd, long wake_after_idle_ms);  // 0 ok, -1 unavailable
+    long (*get_idle_time)(void);                         // idle time in ms
+    int  (*fd)(void);                                    // pollable source or -1
+    void (*dispatch)(void);                              // call when fd is readable
+    void (*park)(int parked);                            // stop / resume watching input
+    void (*rearm)(long wake_after_idle_ms);              // new threshold (config reload)
+} IdleDetector;
+
+/* auto-selection order: compositor-driven first, raw input last */
+static const IdleDetector idle_detectors[] = {
+#ifdef HAVE_WAYLAND_IDLE
+    { "wayland",  wayland_idle_init,  wayland_idle_get,  wayland_idle_fd,  wayland_idle_dispatch,  wayland_idle_park,  wayland_idle_rearm },
+#endif
+#ifdef HAVE_GNOME_IDLE
+    { "gnome",    gnome_idle_init,    gnome_idle_get,    gnome_idle_fd,    gnome_idle_dispatch,    gnome_idle_park,    gnome_idle_rearm },
+#endif
+#ifdef HAVE_EVDEV_IDLE
+    { "evdev",    evdev_idle_init,    evdev_idle_get,    evdev_idle_fd,    evdev_idle_dispatch,    evdev_idle_park,    evdev_idle_rearm },
+#endif
+#ifdef HAVE_LIBINPUT
+    { "libinput", libinput_idle_init, libinput_idle_get, libinput_idle_fd, libinput_idle_dispatch, libinput_idle_park, libinput_idle_rearm },
+#endif
+};
+
+#define IDLE_DETECTOR_COUNT (sizeof(idle_detectors) / sizeof(idle_detectors[0]))
+
+static const IdleDetector *idle_detector = NULL;
+
+// ----------------------------
+// Public: initialize the named backend, or the first that works ("auto")
+// ----------------------------
+static int init_idle_detector(const char *name, int wake_fd, long wake_after_idle_ms) {
+    int any = !name || strcmp(name, "auto") == 0;
+
+    for (size_t i = 0; i < IDLE_DETECTOR_COUNT; i++) {
+        if (!any && strcmp(name, idle_detectors[i].name) != 0)
+            continue;
+
+        if (idle_detectors[i].init(wake_fd, wake_after_idle_ms) == 0) {
+            idle_detector = &idle_detectors[i];
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static const char *idle_detector_name(void) {
+    return idle_detector ? idle_detector->name : "none";
+}
+
+// Lists compiled-in backends, e.g. for --help
+static void idle_detector_list(char *buf, size_t size) {
+    buf[0] = '\0';
+    for (size_t i = 0; i < IDLE_DETECTOR_COUNT; i++) {
+        size_t len = strlen(buf);
+        snprintf(buf + len, size - len, "%s%s", i ? "|" : "", idle_detectors[i].name);
+    }
+}
+
+// ----------------------------
+// Public: idle time in milliseconds
+// ----------------------------
+static long get_idle_time(void) {
+    return idle_detector ? idle_detector->get_idle_time() : 0;
+}
+
+static int idle_detector_fd(void) {
+    return idle_detector ? idle_detector->fd() : -1;
+}
+
+static void idle_detector_dispatch(void) {
+    if (idle_detector)
+        idle_detector->dispatch();
+}
+
+// While parked, backends that read input themselves stop doing so; the
+// compositor-driven ones keep their state and the main loop stops
+// dispatching their fd
+static void idle_detector_park(int parked) {
+    if (idle_detector)
+        idle_detector->park(parked);
+}
+
+// The warning threshold changed (config reload): compositor watches are
+// registered again with it, raw-input backends only compare against it
+static void idle_detector_rearm(long wake_after_idle_ms) {
+    if (idle_detector)
+        idle_detector->rearm(wake_after_idle_ms);
+}
+
+#endif // IDLE_DETECTOR_H
@@ -0,0 +1,387 @@
+// Raw evdev idle tracker for Jigglemil
+// Epolls /dev/input/event* directly and drains each node with large batched
+// read()s, keeping only the newest kernel timestamp. After any activity the
+// thread holds off for a moment and lets the kernel buffer fill up (evdev
+// keeps the newest packets on overflow), so a 4-8 kHz mouse costs a few
+// wakeups per second instead of one libinput dispatch per report.
+// Hotplug is handled through a udev monitor. Parking takes every device
+// out of the epoll set (the fds stay open); on resume the events queued
+// meanwhile are drained with their own timestamps.
+
+#ifndef IDLE_DETECTOR_EVDEV_H
+#define IDLE_DETECTOR_EVDEV_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <linux/input.h>
+
+#include <libudev.h>
+
+#include "clock.h"
+#include "stats.h"
+
+#define EVDEV_MAX_DEVICES   64
+#define EVDEV_READ_BATCH    256             /* events per read() */
+#define EVDEV_UDEV_TAG      UINT64_MAX      /* epoll tag of the udev monitor */
+#define EVDEV_PARK_TAG      (UINT64_MAX - 1) /* epoll tag of the park eventfd */
+
+typedef struct {
+    int  fd;                 /* -1 = free slot */
+    int  kernel_ts;          /* event timestamps are on our clock */
+    char path[64];
+} EvdevDevice;
+
+static EvdevDevice evdev_devices[EVDEV_MAX_DEVICES];
+static int evdev_epfd = -1;
+
+static struct udev *evdev_udev = NULL;
+static struct udev_monitor *evdev_monitor = NULL;
+
+static pthread_t evdev_thread;
+static long evdev_holdoff_ms = EVDEV_HOLDOFF_MS;
+
+/* newest activity, now_ms() milliseconds */
+static atomic_ulong evdev_last_ms = 0;
+
+static int evdev_wake_fd = -1;
+static atomic_ulong evdev_wake_after_ms = 0;   /* config reload moves it */
+
+static int evdev_park_fd = -1;
+static atomic_int evdev_want_parked = 0;
+static int evdev_parked = 0;        /* devices out of the epoll set (thread side) */
+
+// ----------------------------
+// Record activity (called once per drained batch, not per event)
+// ----------------------------
+static void evdev_touch(unsigned long ts) {
+    unsigned long prev = atomic_load_explicit(&evdev_last_ms, memory_order_relaxed);
+    if (ts <= prev)
+        return;
+
+    atomic_store_explicit(&evdev_last_ms, ts, memory_order_relaxed);
+
+    /* only wake the main loop when this ends a warning */
+    if (evdev_wake_fd >= 0 &&
+        ts - prev >= atomic_load_explicit(&evdev_wake_after_ms, memory_order_relaxed))
+        eventfd_write(evdev_wake_fd, 1);
+}
+
+// ----------------------------
+// Device table
+// ----------------------------
+static int evdev_find(const char *path) {
+    for (int i = 0; i < EVDEV_MAX_DEVICES; i++) {
+        if (evdev_devices[i].fd >= 0 && strcmp(evdev_devices[i].path, path) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static void evdev_remove(int idx) {
+    EvdevDevice *dev = &evdev_devices[idx];
+    if (dev->fd < 0)
+        return;
+
+    epoll_ctl(evdev_epfd, EPOLL_CTL_DEL, dev->fd, NULL);
+    close(dev->fd);
+    dev->fd = -1;
+}
+
+// Public: track an already open fd (real device, or a pipe for testing)
+static int evdev_idle_add_fd(int fd, const char *path) {
+    for (int i = 0; i < EVDEV_MAX_DEVICES; i++) {
+        EvdevDevice *dev = &evdev_devices[i];
+        if (dev->fd >= 0)
+            continue;
+
+        int clk = CLOCK_BOOTTIME;
+        dev->fd        = fd;
+        dev->kernel_ts = (ioctl(fd, EVIOCSCLOCKID, &clk) == 0);
+        snprintf(dev->path, sizeof(dev->path), "%s", path);
+
+        struct epoll_event ev = { .events = EPOLLIN, .data.u64 = (uint64_t)i };
+        if (!evdev_parked && epoll_ctl(evdev_epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            dev->fd = -1;
+            return -1;
+        }
+        return 0;
+    }
+    return -1;
+}
+
+static void evdev_open(const char *path) {
+    if (strncmp(path, "/dev/input/event", 16) != 0 ||
+        strlen(path) >= sizeof(evdev_devices[0].path) || evdev_find(path) >= 0)
+        return;
+
+    int fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+        return;
+
+    if (evdev_idle_add_fd(fd, path) < 0)
+        close(fd);
+}
+
+static void evdev_scan(void) {
+    DIR *dir = opendir("/dev/input");
+    if (!dir)
+        return;
+
+    struct dirent *de;
+    char path[64];
+    while ((de = readdir(dir)) != NULL) {
+        if (strncmp(de->d_name, "event", 5) != 0)
+            continue;
+        /* event nodes are short; anything longer is not one of ours */
+        if (snprintf(path, sizeof(path), "/dev/input/%s", de->d_name) >= (int)sizeof(path))
+            continue;
+        evdev_open(path);
+    }
+    closedir(dir);
+}
+
+// ----------------------------
+// Park: devices leave the epoll set, so nothing wakes the thread
+// ----------------------------
+static void evdev_set_parked(int parked) {
+    if (parked == evdev_parked)
+        return;
+    evdev_parked = parked;
+
+    for (int i = 0; i < EVDEV_MAX_DEVICES; i++) {
+        EvdevDevice *dev = &evdev_devices[i];
+        if (dev->fd < 0)
+            continue;
+
+        struct epoll_event ev = { .events = EPOLLIN, .data.u64 = (uint64_t)i };
+        epoll_ctl(evdev_epfd, parked ? EPOLL_CTL_DEL : EPOLL_CTL_ADD, dev->fd, &ev);
+    }
+}
+
+// ----------------------------
+// Hotplug
+// ----------------------------
+static void evdev_hotplug(void) {
+    struct udev_device *d;
+    while ((d = udev_monitor_receive_device(evdev_monitor)) != NULL) {
+        const char *node   = udev_device_get_devnode(d);
+        const char *action = udev_device_get_action(d);
+
+        if (node && action) {
+            if (strcmp(action, "add") == 0) {
+                evdev_open(node);
+            } else if (strcmp(action, "remove") == 0) {
+                int idx = evdev_find(node);
+                if (idx >= 0)
+                    evdev_remove(idx);
+            }
+        }
+        udev_device_unref(d);
+    }
+}
+
+// ----------------------------
+// Drain one device: returns 1 if any input was seen
+// ----------------------------
+static int evdev_drain(int idx) {
+    EvdevDevice *dev = &evdev_devices[idx];
+    struct input_event buf[EVDEV_READ_BATCH];
+    const struct input_event *newest = NULL;
+
+    for (;;) {
+        ssize_t r = read(dev->fd, buf, sizeof(buf));
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN)
+                evdev_remove(idx);    /* ENODEV: unplugged */
+            break;
+        }
+        if (r < (ssize_t)sizeof(buf[0])) {
+            if (r == 0)
+                evdev_remove(idx);    /* writer side of a pipe closed */
+            break;
+        }
+
+        newest = &buf[r / sizeof(buf[0]) - 1];
+        stats_count(STAT_IDLE_EVENTS, (unsigned long long)(r / sizeof(buf[0])));
+        if (r < (ssize_t)sizeof(buf))
+            break;                    /* short read: buffer is empty */
+    }
+
+    if (!newest)
+        return 0;
+
+    if (dev->kernel_ts) {
+        evdev_touch((unsigned long)newest->input_event_sec * 1000ul +
+                    (unsigned long)newest->input_event_usec / 1000ul);
+    } else {
+        evdev_touch(now_ms());
+    }
+    return 1;
+}
+
+// ----------------------------
+// Tracker thread
+// ----------------------------
+static void* evdev_thread_main(void *arg) {
+    (void)arg;
+    struct epoll_event evs[16];
+
+    for (;;) {
+        int n = epoll_wait(evdev_epfd, evs, 16, -1);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            perror("idle_detector: epoll_wait");
+            break;
+        }
+
+        int active = 0;
+        for (int i = 0; i < n; i++) {
+            if (evs[i].data.u64 == EVDEV_UDEV_TAG) {
+                evdev_hotplug();
+            } else if (evs[i].data.u64 == EVDEV_PARK_TAG) {
+                uint64_t val;
+                if (read(evdev_park_fd, &val, sizeof(val)) < 0) { /* drained anyway */ }
+                evdev_set_parked(atomic_load(&evdev_want_parked));
+            } else if (!evdev_parked) {
+                active |= evdev_drain((int)evs[i].data.u64);
+            }
+        }
+
+        /* recently active: let the storm pile up in the kernel buffer */
+        if (active && evdev_holdoff_ms > 0) {
+            struct timespec ts = {
+                .tv_sec  = evdev_holdoff_ms / 1000,
+                .tv_nsec = (evdev_holdoff_ms % 1000) * 1000000l
+            };
+            while (nanosleep(&ts, &ts) < 0 && errno == EINTR)
+                ;
+        }
+    }
+    return NULL;
+}
+
+// ----------------------------
+// Public: set up tracker without devices (used by benchmarks)
+// ----------------------------
+static int evdev_idle_setup(int wake_fd, long wake_after_idle_ms) {
+    evdev_wake_fd       = wake_fd;
+    atomic_store_explicit(&evdev_wake_after_ms, (unsigned long)wake_after_idle_ms,
+                          memory_order_relaxed);
+
+    for (int i = 0; i < EVDEV_MAX_DEVICES; i++)
+        evdev_devices[i].fd = -1;
+
+    evdev_epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (evdev_epfd < 0)
+        return -1;
+
+    evdev_park_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (evdev_park_fd >= 0) {
+        struct epoll_event ev = { .events = EPOLLIN, .data.u64 = EVDEV_PARK_TAG };
+        epoll_ctl(evdev_epfd, EPOLL_CTL_ADD, evdev_park_fd, &ev);
+    }
+
+    atomic_store_explicit(&evdev_last_ms, now_ms(), memory_order_relaxed);
+    return 0;
+}
+
+static int evdev_idle_start(void) {
+    if (pthread_create(&evdev_thread, NULL, evdev_thread_main, NULL) != 0)
+        return -1;
+    pthread_detach(evdev_thread);
+    return 0;
+}
+
+// ----------------------------
+// Public: initialize idle detector (-1 if no input node is readable)
+// ----------------------------
+static int evdev_idle_init(int wake_fd, long wake_after_idle_ms) {
+    if (evdev_idle_setup(wake_fd, wake_after_idle_ms) < 0)
+        return -1;
+
+    evdev_udev = udev_new();
+    if (evdev_udev) {
+        evdev_monitor = udev_monitor_new_from_netlink(evdev_udev, "udev");
+    }
+    if (evdev_monitor) {
+        udev_monitor_filter_add_match_subsystem_devtype(evdev_monitor, "input", NULL);
+        udev_monitor_enable_receiving(evdev_monitor);
+
+        struct epoll_event ev = { .events = EPOLLIN, .data.u64 = EVDEV_UDEV_TAG };
+        epoll_ctl(evdev_epfd, EPOLL_CTL_ADD, udev_monitor_get_fd(evdev_monitor), &ev);
+    }
+
+    evdev_scan();
+
+    int opened = 0;
+    for (int i = 0; i < EVDEV_MAX_DEVICES; i++)
+        opened += evdev_devices[i].fd >= 0;
+
+    if (!opened) {
+        /* no permission for /dev/input: let another backend try */
+        if (evdev_monitor) udev_monitor_unref(evdev_monitor);
+        if (evdev_udev)    udev_unref(evdev_udev);
+        evdev_monitor = NULL;
+        evdev_udev    = NULL;
+        close(evdev_park_fd);
+        close(evdev_epfd);
+        evdev_park_fd = -1;
+        evdev_epfd    = -1;
+        return -1;
+    }
+
+    return evdev_idle_start();
+}
+
+// ----------------------------
+// Public: no pollable source, the thread pokes the wake fd itself
+// ----------------------------
+static int evdev_idle_fd(void) {
+    return -1;
+}
+
+static void evdev_idle_dispatch(void) {
+}
+
+// ----------------------------
+// Public: park / resume (handed to the thread)
+// ----------------------------
+static void evdev_idle_park(int parked) {
+    if (evdev_park_fd < 0)
+        return;
+    atomic_store(&evdev_want_parked, parked);
+    eventfd_write(evdev_park_fd, 1);
+}
+
+// The thread reads the threshold on its next batch
+static void evdev_idle_rearm(long wake_after_idle_ms) {
+    atomic_store_explicit(&evdev_wake_after_ms, (unsigned long)wake_after_idle_ms,
+                          memory_order_relaxed);
+}
+
+// ----------------------------
+// Public: get idle time in milliseconds
+// ----------------------------
+static long evdev_idle_get(void) {
+    unsigned long now  = now_ms();
+    unsigned long last = atomic_load_explicit(&evdev_last_ms, memory_order_relaxed);
+
+    /* kernel timestamps can be a hair ahead of now_ms() */
+    return now > last ? (long)(now - last) : 0;
+}
+
+#endif // IDLE_DETECTOR_EVDEV_H
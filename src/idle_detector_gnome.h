@@ -1,39 +1,199 @@
-// // Idle detection using GNOME/Mutter D-Bus
+// Idle detection using GNOME/Mutter D-Bus
+// One persistent session-bus connection (sd-bus). Idle time is still read
+// with GetIdletime on demand, but the main loop is woken by Mutter's own
+// watches: an IdleWatch at the warning threshold arms a one-shot
+// UserActiveWatch, whose WatchFired signal is forwarded to the wake fd.
 
 #ifndef IDLE_DETECTOR_GNOME_H
 #define IDLE_DETECTOR_GNOME_H
 
 #include <stdio.h>
-#include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <unistd.h>
+#include <sys/eventfd.h>
+
+#include <systemd/sd-bus.h>
+
+#include "stats.h"
+
+#define MUTTER_IDLE_DEST    "org.gnome.Mutter.IdleMonitor"
+#define MUTTER_IDLE_PATH    "/org/gnome/Mutter/IdleMonitor/Core"
+#define MUTTER_IDLE_IFACE   "org.gnome.Mutter.IdleMonitor"
+
+static sd_bus *gnome_bus = NULL;
+static sd_bus_slot *gnome_watch_slot = NULL;
+
+static int gnome_wake_fd = -1;
+static uint64_t gnome_wake_after_ms = 0;
+
+/* watch ids handed out by Mutter, 0 = not registered */
+static uint32_t gnome_idle_watch = 0;
+static uint32_t gnome_active_watch = 0;
+static int gnome_want_active_watch = 0;
+
+// ----------------------------
+// Register watches (return 0 on failure, watch id otherwise)
+// ----------------------------
+static uint32_t gnome_add_watch(const char *method, const char *sig, uint64_t arg) {
+    sd_bus_error err = SD_BUS_ERROR_NULL;
+    sd_bus_message *reply = NULL;
+    uint32_t id = 0;
+
+    int r = sig
+        ? sd_bus_call_method(gnome_bus, MUTTER_IDLE_DEST, MUTTER_IDLE_PATH,
+                             MUTTER_IDLE_IFACE, method, &err, &reply, sig, arg)
+        : sd_bus_call_method(gnome_bus, MUTTER_IDLE_DEST, MUTTER_IDLE_PATH,
+                             MUTTER_IDLE_IFACE, method, &err, &reply, "");
+
+    if (r >= 0 && sd_bus_message_read(reply, "u", &id) < 0)
+        id = 0;
+
+    sd_bus_message_unref(reply);
+    sd_bus_error_free(&err);
+    return id;
+}
+
+static void gnome_register_idle_watch(void) {
+    if (!gnome_idle_watch)
+        gnome_idle_watch = gnome_add_watch("AddIdleWatch", "t", gnome_wake_after_ms);
+}
+
+static void gnome_remove_watch(uint32_t id) {
+    sd_bus_error err = SD_BUS_ERROR_NULL;
+    sd_bus_call_method(gnome_bus, MUTTER_IDLE_DEST, MUTTER_IDLE_PATH,
+                       MUTTER_IDLE_IFACE, "RemoveWatch", &err, NULL, "u", id);
+    sd_bus_error_free(&err);
+}
+
+// ----------------------------
+// WatchFired(u id) signal handler
+// ----------------------------
+static int gnome_on_watch_fired(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
+    (void)userdata;
+    (void)ret_error;
+
+    uint32_t id;
+    if (sd_bus_message_read(m, "u", &id) < 0)
+        return 0;
+
+    stats_count(STAT_IDLE_EVENTS, 1);
+
+    if (id && id == gnome_idle_watch) {
+        /* user just went idle: get told the moment they come back
+         * (registered from dispatch, not from inside the callback) */
+        gnome_want_active_watch = 1;
+    } else if (id && id == gnome_active_watch) {
+        /* user-active watches are one-shot */
+        gnome_active_watch = 0;
+        if (gnome_wake_fd >= 0)
+            eventfd_write(gnome_wake_fd, 1);
+    }
+    return 0;
+}
+
+// ----------------------------
+// Public: drain queued bus traffic (signals may already sit in the
+// read queue after a synchronous call, so never wait without this)
+// ----------------------------
+static void gnome_idle_dispatch(void) {
+    if (!gnome_bus)
+        return;
+
+    do {
+        while (sd_bus_process(gnome_bus, NULL) > 0)
+            ;
+
+        /* a failed call keeps the request, so the next dispatch retries */
+        if (gnome_want_active_watch && !gnome_active_watch)
+            gnome_active_watch = gnome_add_watch("AddUserActiveWatch", NULL, 0);
+        if (gnome_active_watch)
+            gnome_want_active_watch = 0;
+    } while (sd_bus_process(gnome_bus, NULL) > 0);
+}
+
+static int gnome_idle_fd(void) {
+    return gnome_bus ? sd_bus_get_fd(gnome_bus) : -1;
+}
+
+// Mutter keeps counting while we are parked; nothing to stop
+static void gnome_idle_park(int parked) {
+    (void)parked;
+}
+
+// ----------------------------
+// Public: initialize idle detector (-1 without Mutter on the session bus)
+// ----------------------------
+static int gnome_idle_init(int wake_fd, long wake_after_idle_ms) {
+    gnome_wake_fd       = wake_fd;
+    gnome_wake_after_ms = (uint64_t)wake_after_idle_ms;
+
+    if (sd_bus_open_user(&gnome_bus) < 0) {
+        gnome_bus = NULL;
+        return -1;
+    }
+
+    if (sd_bus_match_signal(gnome_bus, &gnome_watch_slot, MUTTER_IDLE_DEST,
+                            MUTTER_IDLE_PATH, MUTTER_IDLE_IFACE, "WatchFired",
+                            gnome_on_watch_fired, NULL) < 0) {
+        fprintf(stderr, "idle_detector: cannot subscribe to WatchFired\n");
+    }
+
+    gnome_register_idle_watch();
+    if (!gnome_idle_watch) {
+        /* no IdleMonitor service: not a GNOME session */
+        sd_bus_slot_unref(gnome_watch_slot);
+        gnome_watch_slot = NULL;
+        gnome_bus = sd_bus_flush_close_unref(gnome_bus);
+        return -1;
+    }
+
+    gnome_idle_dispatch();
+    return 0;
+}
+
+// ----------------------------
+// Public: new threshold. An idle watch's interval is fixed, so it is
+// replaced; the user-active watch does not depend on it and stays.
+// ----------------------------
+static void gnome_idle_rearm(long wake_after_idle_ms) {
+    gnome_wake_after_ms = (uint64_t)wake_after_idle_ms;
+    if (!gnome_bus)
+        return;
+
+    if (gnome_idle_watch)
+        gnome_remove_watch(gnome_idle_watch);
+    gnome_idle_watch = 0;
+    gnome_register_idle_watch();
+    gnome_idle_dispatch();
+}
 
 // Returns idle time in milliseconds
-static long get_idle_time(void) {
-    FILE *fp = popen(
-        "gdbus call --session "
-        "--dest org.gnome.Mutter.IdleMonitor "
-        "--object-path /org/gnome/Mutter/IdleMonitor/Core "
-        "--method org.gnome.Mutter.IdleMonitor.GetIdletime 2>/dev/null",
-        "r"
-    );
-
-    if (!fp) return 0;
-
-    char buf[128];
-    long idle = 0;
-
-    if (fgets(buf, sizeof(buf), fp)) {
-        // Parse "(uint64 12345,)" format
-        char *p = strstr(buf, " ");
-        if (p) {
-            p++; // skip space
-            idle = strtol(p, NULL, 10);
-        }
+static long gnome_idle_get(void) {
+    if (!gnome_bus)
+        return 0;
+
+    sd_bus_error err = SD_BUS_ERROR_NULL;
+    sd_bus_message *reply = NULL;
+    uint64_t idle = 0;
+
+    int r = sd_bus_call_method(gnome_bus, MUTTER_IDLE_DEST, MUTTER_IDLE_PATH,
+                               MUTTER_IDLE_IFACE, "GetIdletime",
+                               &err, &reply, "");
+    if (r < 0 || sd_bus_message_read(reply, "t", &idle) < 0) {
+        /* Mutter went away: its watches went with it */
+        gnome_idle_watch   = 0;
+        gnome_active_watch = 0;
+        idle = 0;
+    } else {
+        gnome_register_idle_watch();
     }
 
-    pclose(fp);
-    return idle;
+    sd_bus_message_unref(reply);
+    sd_bus_error_free(&err);
+
+    gnome_idle_dispatch();
+    return (long)idle;
 }
 
 #endif // IDLE_DETECTOR_GNOME_H
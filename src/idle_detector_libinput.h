@@ -1,8 +1,8 @@
 // libinput implementation for Jigglemil get_idle_time()
 // Tracks mouse + keyboard activity via libinput and returns idle time in ms
 
-#ifndef IDLE_DETECTOR_H
-#define IDLE_DETECTOR_H
+#ifndef IDLE_DETECTOR_LIBINPUT_H
+#define IDLE_DETECTOR_LIBINPUT_H
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -14,13 +14,28 @@
 #include <time.h>
 #include <pthread.h>
 #include <stdatomic.h>
+#include <sys/eventfd.h>
 
 #include <libinput.h>
 #include <libudev.h>
 
-/* last activity timestamp in monotonic milliseconds */
+#include "clock.h"
+#include "stats.h"
+#include "corpus.h"
+
+/* last activity timestamp in now_ms() milliseconds */
 static atomic_ulong last_activity_ms = 0;
 
+/* eventfd poked when activity follows at least wake_after_ms of idle */
+static int idle_wake_fd = -1;
+static atomic_ulong idle_wake_after_ms = 0;    /* config reload moves it */
+
+static struct udev *libinput_udev_ctx = NULL;
+
+/* park requests for the thread, which owns the libinput context */
+static int libinput_park_fd = -1;
+static atomic_int libinput_want_parked = 0;
+
 // ----------------------------
 // Helper: open / close restricted for libinput
 // ----------------------------
@@ -34,20 +49,12 @@ static void close_restricted(int fd, void *userdata) {
     close(fd);
 }
 
-// ----------------------------
-// Fast monotonic time in ms
-// ----------------------------
-static inline unsigned long now_ms(void) {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
-    return (unsigned long)ts.tv_sec * 1000ul +
-           (unsigned long)ts.tv_nsec / 1000000ul;
-}
-
 // ----------------------------
 // Update idle timer (debounced)
 // ----------------------------
 static inline void update_last_activity(void) {
+    stats_count(STAT_IDLE_EVENTS, 1);
+
     unsigned long now = now_ms();
     unsigned long prev = atomic_load_explicit(
         &last_activity_ms, memory_order_relaxed);
@@ -56,51 +63,39 @@ static inline void update_last_activity(void) {
     if (now != prev) {
         atomic_store_explicit(
             &last_activity_ms, now, memory_order_relaxed);
+
+        /* only wake the main loop when this ends a warning; while the
+         * user stays active its deadline timer re-checks on its own */
+        if (idle_wake_fd >= 0 &&
+            now - prev >= atomic_load_explicit(&idle_wake_after_ms, memory_order_relaxed))
+            eventfd_write(idle_wake_fd, 1);
     }
 }
 
+// ----------------------------
+// Our own injected motion (uinput, per-seat uinput or ydotoold) must not
+// be recorded
+// ----------------------------
+static int is_own_device(struct libinput_device *dev) {
+    const char *name = libinput_device_get_name(dev);
+    return name && (strncmp(name, UINPUT_DEVICE_NAME, strlen(UINPUT_DEVICE_NAME)) == 0 ||
+                    strstr(name, "ydotoold") != NULL);
+}
+
 // ----------------------------
 // Input monitoring thread
 // ----------------------------
 static void* input_monitor_thread(void *arg) {
-    (void)arg;
+    struct libinput *li = arg;
 
-    struct libinput_interface iface = {
-        .open_restricted  = open_restricted,
-        .close_restricted = close_restricted
-    };
-
-    struct udev *udev_ctx = udev_new();
-    if (!udev_ctx) {
-        fprintf(stderr, "idle_detector: udev_new failed\n");
-        return NULL;
-    }
-
-    struct libinput *li =
-        libinput_udev_create_context(&iface, NULL, udev_ctx);
-    if (!li) {
-        fprintf(stderr,
-                "idle_detector: libinput_udev_create_context failed\n");
-        udev_unref(udev_ctx);
-        return NULL;
-    }
-
-    if (libinput_udev_assign_seat(li, "seat0") != 0) {
-        fprintf(stderr,
-                "idle_detector: libinput_udev_assign_seat failed\n");
-        libinput_unref(li);
-        udev_unref(udev_ctx);
-        return NULL;
-    }
-
-    int fd = libinput_get_fd(li);
-    struct pollfd fds = {
-        .fd     = fd,
-        .events = POLLIN
+    struct pollfd fds[2] = {
+        { .fd = libinput_get_fd(li), .events = POLLIN },
+        { .fd = libinput_park_fd,    .events = POLLIN }
     };
+    int parked = 0;
 
     for (;;) {
-        if (poll(&fds, 1, -1) < 0) {
+        if (poll(fds, 2, -1) < 0) {
             if (errno == EINTR)
                 continue;
 
@@ -108,17 +103,43 @@ static void* input_monitor_thread(void *arg) {
             break;
         }
 
+        if (fds[1].revents & POLLIN) {
+            uint64_t val;
+            if (read(libinput_park_fd, &val, sizeof(val)) < 0) { /* drained anyway */ }
+
+            int want = atomic_load(&libinput_want_parked);
+            if (want && !parked) {
+                /* closes every device: no input is read until resume */
+                corpus_record_break();
+                libinput_suspend(li);
+            } else if (!want && parked) {
+                libinput_resume(li);
+                /* unlocking / waking the machine took input we never saw */
+                atomic_store_explicit(&last_activity_ms, now_ms(), memory_order_relaxed);
+            }
+            parked = want;
+        }
+
         libinput_dispatch(li);
 
         struct libinput_event *ev;
         while ((ev = libinput_get_event(li)) != NULL) {
             switch (libinput_event_get_type(ev)) {
-                case LIBINPUT_EVENT_KEYBOARD_KEY:
                 case LIBINPUT_EVENT_POINTER_MOTION:
+                    update_last_activity();
+                    if (!is_own_device(libinput_event_get_device(ev))) {
+                        struct libinput_event_pointer *p = libinput_event_get_pointer_event(ev);
+                        corpus_record_motion(libinput_event_pointer_get_dx_unaccelerated(p),
+                                             libinput_event_pointer_get_dy_unaccelerated(p),
+                                             libinput_event_pointer_get_time_usec(p));
+                    }
+                    break;
+                case LIBINPUT_EVENT_KEYBOARD_KEY:
                 case LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE:
                 case LIBINPUT_EVENT_POINTER_BUTTON:
                 case LIBINPUT_EVENT_POINTER_AXIS:
                     update_last_activity();
+                    corpus_record_break();
                     break;
                 default:
                     break;
@@ -128,26 +149,93 @@ static void* input_monitor_thread(void *arg) {
     }
 
     libinput_unref(li);
-    udev_unref(udev_ctx);
+    udev_unref(libinput_udev_ctx);
     return NULL;
 }
 
 // ----------------------------
-// Public: initialize idle detector
+// Public: initialize idle detector (-1 if libinput is unusable)
 // ----------------------------
-static void init_idle_detector(void) {
+static int libinput_idle_init(int wake_fd, long wake_after_idle_ms) {
+    idle_wake_fd       = wake_fd;
+    atomic_store_explicit(&idle_wake_after_ms, (unsigned long)wake_after_idle_ms,
+                          memory_order_relaxed);
+
+    static const struct libinput_interface iface = {
+        .open_restricted  = open_restricted,
+        .close_restricted = close_restricted
+    };
+
+    libinput_udev_ctx = udev_new();
+    if (!libinput_udev_ctx) {
+        fprintf(stderr, "idle_detector: udev_new failed\n");
+        return -1;
+    }
+
+    struct libinput *li =
+        libinput_udev_create_context(&iface, NULL, libinput_udev_ctx);
+    if (!li) {
+        fprintf(stderr,
+                "idle_detector: libinput_udev_create_context failed\n");
+        udev_unref(libinput_udev_ctx);
+        return -1;
+    }
+
+    /* the session's seat, like the compositor */
+    const char *seat = getenv("XDG_SEAT");
+    if (libinput_udev_assign_seat(li, seat && *seat ? seat : SEAT_DEFAULT) != 0) {
+        fprintf(stderr,
+                "idle_detector: libinput_udev_assign_seat failed\n");
+        libinput_unref(li);
+        udev_unref(libinput_udev_ctx);
+        return -1;
+    }
+
     atomic_store_explicit(
         &last_activity_ms, now_ms(), memory_order_relaxed);
 
+    libinput_park_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
     pthread_t tid;
-    pthread_create(&tid, NULL, input_monitor_thread, NULL);
+    if (pthread_create(&tid, NULL, input_monitor_thread, li) != 0) {
+        libinput_unref(li);
+        udev_unref(libinput_udev_ctx);
+        return -1;
+    }
     pthread_detach(tid);
+    return 0;
+}
+
+// ----------------------------
+// Public: no pollable source, the thread pokes the wake fd itself
+// ----------------------------
+static int libinput_idle_fd(void) {
+    return -1;
+}
+
+static void libinput_idle_dispatch(void) {
+}
+
+// ----------------------------
+// Public: park / resume (handed to the thread)
+// ----------------------------
+static void libinput_idle_park(int parked) {
+    if (libinput_park_fd < 0)
+        return;
+    atomic_store(&libinput_want_parked, parked);
+    eventfd_write(libinput_park_fd, 1);
+}
+
+// The thread reads the threshold on its next event
+static void libinput_idle_rearm(long wake_after_idle_ms) {
+    atomic_store_explicit(&idle_wake_after_ms, (unsigned long)wake_after_idle_ms,
+                          memory_order_relaxed);
 }
 
 // ----------------------------
 // Public: get idle time in milliseconds
 // ----------------------------
-static long get_idle_time(void) {
+static long libinput_idle_get(void) {
     unsigned long now  = now_ms();
     unsigned long last =
         atomic_load_explicit(&last_activity_ms, memory_order_relaxed);
@@ -155,4 +243,4 @@ static long get_idle_time(void) {
     return (long)(now - last);
 }
 
-#endif // IDLE_DETECTOR_H
+#endif // IDLE_DETECTOR_LIBINPUT_H
@@ -0,0 +1,258 @@
+// Idle detection using the Wayland ext-idle-notify-v1 protocol
+// (with the KDE org_kde_kwin_idle protocol as fallback).
+// The compositor tells us when the seat has been idle for our threshold and
+// when it resumes, so nothing is polled, no raw input is seen and no root /
+// input-group access is needed.
+
+#ifndef IDLE_DETECTOR_WAYLAND_H
+#define IDLE_DETECTOR_WAYLAND_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/eventfd.h>
+
+#include <wayland-client.h>
+#include "ext-idle-notify-v1-client-protocol.h"
+#ifdef HAVE_KDE_IDLE
+#include "kde-idle-client-protocol.h"
+#endif
+
+#include "clock.h"
+#include "stats.h"
+
+static struct wl_display  *wl_idle_display  = NULL;
+static struct wl_registry *wl_idle_registry = NULL;
+static struct wl_seat     *wl_idle_seat     = NULL;
+
+static struct ext_idle_notifier_v1     *wl_idle_notifier     = NULL;
+static struct ext_idle_notification_v1 *wl_idle_notification = NULL;
+#ifdef HAVE_KDE_IDLE
+static struct org_kde_kwin_idle         *wl_kde_idle    = NULL;
+static struct org_kde_kwin_idle_timeout *wl_kde_timeout = NULL;
+#endif
+
+static int wl_idle_wake_fd = -1;
+static uint32_t wl_idle_timeout_ms = 0;
+
+/* compositor state: idled = no input for wl_idle_timeout_ms */
+static int wl_idle_idled = 0;
+static unsigned long wl_idle_last_ms = 0;
+
+// ----------------------------
+// Idle / resume transitions (shared by both protocols)
+// ----------------------------
+static void wl_idle_on_idled(void) {
+    stats_count(STAT_IDLE_EVENTS, 1);
+    wl_idle_idled   = 1;
+    wl_idle_last_ms = now_ms() - wl_idle_timeout_ms;
+    if (wl_idle_wake_fd >= 0)
+        eventfd_write(wl_idle_wake_fd, 1);
+}
+
+static void wl_idle_on_resumed(void) {
+    stats_count(STAT_IDLE_EVENTS, 1);
+    wl_idle_idled   = 0;
+    wl_idle_last_ms = now_ms();
+    if (wl_idle_wake_fd >= 0)
+        eventfd_write(wl_idle_wake_fd, 1);
+}
+
+static void ext_idle_idled(void *data, struct ext_idle_notification_v1 *n) {
+    (void)data; (void)n;
+    wl_idle_on_idled();
+}
+
+static void ext_idle_resumed(void *data, struct ext_idle_notification_v1 *n) {
+    (void)data; (void)n;
+    wl_idle_on_resumed();
+}
+
+static const struct ext_idle_notification_v1_listener ext_idle_listener = {
+    .idled   = ext_idle_idled,
+    .resumed = ext_idle_resumed,
+};
+
+#ifdef HAVE_KDE_IDLE
+static void kde_idle_idle(void *data, struct org_kde_kwin_idle_timeout *t) {
+    (void)data; (void)t;
+    wl_idle_on_idled();
+}
+
+static void kde_idle_resumed(void *data, struct org_kde_kwin_idle_timeout *t) {
+    (void)data; (void)t;
+    wl_idle_on_resumed();
+}
+
+static const struct org_kde_kwin_idle_timeout_listener kde_idle_listener = {
+    .idle    = kde_idle_idle,
+    .resumed = kde_idle_resumed,
+};
+#endif
+
+// ----------------------------
+// Registry: pick up seat + idle notifier globals
+// ----------------------------
+static void wl_idle_global(void *data, struct wl_registry *reg, uint32_t name,
+                           const char *interface, uint32_t version) {
+    (void)data; (void)version;
+
+    if (!wl_idle_seat && strcmp(interface, wl_seat_interface.name) == 0) {
+        wl_idle_seat = wl_registry_bind(reg, name, &wl_seat_interface, 1);
+    } else if (strcmp(interface, ext_idle_notifier_v1_interface.name) == 0) {
+        wl_idle_notifier =
+            wl_registry_bind(reg, name, &ext_idle_notifier_v1_interface, 1);
+    }
+#ifdef HAVE_KDE_IDLE
+    else if (strcmp(interface, org_kde_kwin_idle_interface.name) == 0) {
+        wl_kde_idle = wl_registry_bind(reg, name, &org_kde_kwin_idle_interface, 1);
+    }
+#endif
+}
+
+static void wl_idle_global_remove(void *data, struct wl_registry *reg, uint32_t name) {
+    (void)data; (void)reg; (void)name;
+}
+
+static const struct wl_registry_listener wl_idle_registry_listener = {
+    .global        = wl_idle_global,
+    .global_remove = wl_idle_global_remove,
+};
+
+static void wl_idle_disconnect(void) {
+    if (wl_idle_display)
+        wl_display_disconnect(wl_idle_display);
+
+    wl_idle_display  = NULL;
+    wl_idle_registry = NULL;
+    wl_idle_seat     = NULL;
+    wl_idle_notifier = NULL;
+    wl_idle_notification = NULL;
+#ifdef HAVE_KDE_IDLE
+    wl_kde_idle    = NULL;
+    wl_kde_timeout = NULL;
+#endif
+}
+
+// ----------------------------
+// Ask for idled / resumed at wl_idle_timeout_ms (-1 without a notifier)
+// ----------------------------
+static int wl_idle_watch(void) {
+    if (wl_idle_notifier) {
+        wl_idle_notification = ext_idle_notifier_v1_get_idle_notification(
+            wl_idle_notifier, wl_idle_timeout_ms, wl_idle_seat);
+        ext_idle_notification_v1_add_listener(
+            wl_idle_notification, &ext_idle_listener, NULL);
+        return 0;
+    }
+#ifdef HAVE_KDE_IDLE
+    if (wl_kde_idle) {
+        wl_kde_timeout = org_kde_kwin_idle_get_idle_timeout(
+            wl_kde_idle, wl_idle_seat, wl_idle_timeout_ms);
+        org_kde_kwin_idle_timeout_add_listener(
+            wl_kde_timeout, &kde_idle_listener, NULL);
+        return 0;
+    }
+#endif
+    return -1;
+}
+
+// ----------------------------
+// Public: initialize idle detector (-1 without a supporting compositor)
+// ----------------------------
+static int wayland_idle_init(int wake_fd, long wake_after_idle_ms) {
+    wl_idle_wake_fd    = wake_fd;
+    wl_idle_timeout_ms = (uint32_t)wake_after_idle_ms;
+
+    wl_idle_display = wl_display_connect(NULL);
+    if (!wl_idle_display)
+        return -1;
+
+    wl_idle_registry = wl_display_get_registry(wl_idle_display);
+    wl_registry_add_listener(wl_idle_registry, &wl_idle_registry_listener, NULL);
+
+    if (wl_display_roundtrip(wl_idle_display) < 0 || !wl_idle_seat) {
+        wl_idle_disconnect();
+        return -1;
+    }
+
+    if (wl_idle_watch() < 0) {
+        wl_idle_disconnect();
+        return -1;
+    }
+
+    wl_idle_last_ms = now_ms();
+    wl_display_flush(wl_idle_display);
+    return 0;
+}
+
+// ----------------------------
+// Public: event source for the main loop
+// ----------------------------
+static int wayland_idle_fd(void) {
+    return wl_idle_display ? wl_display_get_fd(wl_idle_display) : -1;
+}
+
+static void wayland_idle_dispatch(void) {
+    if (!wl_idle_display)
+        return;
+
+    if (wl_display_dispatch(wl_idle_display) < 0) {
+        fprintf(stderr, "idle_detector: lost Wayland connection\n");
+        wl_idle_disconnect();
+    }
+}
+
+// The compositor keeps counting while we are parked; nothing to stop
+static void wayland_idle_park(int parked) {
+    (void)parked;
+}
+
+// ----------------------------
+// Public: new threshold. A notification's timeout is fixed at creation,
+// so the old one is destroyed and a new one requested: keeping it would
+// report an active user idle up to the old timeout. The compositor counts
+// the new one from its creation, so the state restarts as not idled;
+// wayland_idle_get caps what it reports at the new threshold until told.
+// ----------------------------
+static void wayland_idle_rearm(long wake_after_idle_ms) {
+    if (!wl_idle_display)
+        return;
+
+    if (wl_idle_notification)
+        ext_idle_notification_v1_destroy(wl_idle_notification);
+    wl_idle_notification = NULL;
+#ifdef HAVE_KDE_IDLE
+    if (wl_kde_timeout)
+        org_kde_kwin_idle_timeout_release(wl_kde_timeout);
+    wl_kde_timeout = NULL;
+#endif
+
+    wl_idle_timeout_ms = (uint32_t)wake_after_idle_ms;
+    wl_idle_idled = 0;
+    wl_idle_watch();
+    wl_display_flush(wl_idle_display);
+}
+
+// ----------------------------
+// Public: get idle time in milliseconds
+// ----------------------------
+static long wayland_idle_get(void) {
+    if (!wl_idle_display)
+        return 0;
+
+    wl_display_dispatch_pending(wl_idle_display);
+    wl_display_flush(wl_idle_display);
+
+    unsigned long now = now_ms();
+
+    /* Not idled yet, but longer than the threshold since we last heard:
+     * the compositor saw input we were not told about. All we know is
+     * idle < threshold, so count from now; "idled" will wake us. */
+    if (!wl_idle_idled && now - wl_idle_last_ms >= wl_idle_timeout_ms)
+        wl_idle_last_ms = now;
+
+    return (long)(now - wl_idle_last_ms);
+}
+
+#endif // IDLE_DETECTOR_WAYLAND_H
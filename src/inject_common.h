@@ -0,0 +1,36 @@
+// Shared input_event helpers for Jigglemil injection backends
+
+#ifndef INJECT_COMMON_H
+#define INJECT_COMMON_H
+
+#include <string.h>
+#include <linux/input.h>
+
+// ----------------------------
+// Event helpers
+// ----------------------------
+static inline void set_event(struct input_event *ev,
+                             unsigned short type, unsigned short code, int value) {
+    memset(ev, 0, sizeof(*ev));
+    ev->type  = type;
+    ev->code  = code;
+    ev->value = value;
+}
+
+/* fills ev[] with a relative move frame, returns number of events */
+static inline int build_rel_frame(struct input_event ev[3], int dx, int dy) {
+    int n = 0;
+    if (dx) set_event(&ev[n++], EV_REL, REL_X, dx);
+    if (dy) set_event(&ev[n++], EV_REL, REL_Y, dy);
+    set_event(&ev[n++], EV_SYN, SYN_REPORT, 0);
+    return n;
+}
+
+/* fills ev[] with one key press (1) or release (0), returns number of events */
+static inline int build_key_frame(struct input_event ev[2], int code, int value) {
+    set_event(&ev[0], EV_KEY, code, value);
+    set_event(&ev[1], EV_SYN, SYN_REPORT, 0);
+    return 2;
+}
+
+#endif // INJECT_COMMON_H
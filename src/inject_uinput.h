@@ -0,0 +1,143 @@
+// Direct /dev/uinput backend for Jigglemil
+// Creates our own virtual pointer, so no ydotoold / ydotool / socket hop is
+// needed. Any non-character-device path (pipe, file) is accepted as a fake
+// device: setup ioctls are skipped and the raw event stream is written as-is.
+// The daemon's device lives in uinput_fd; seats (seat.h) create one each
+// with uinput_create() and write through the *_to() variants.
+
+#ifndef INJECT_UINPUT_H
+#define INJECT_UINPUT_H
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <linux/input.h>
+#include <linux/uinput.h>
+
+#include "inject_common.h"
+
+static int uinput_fd = -1;
+static int uinput_is_device = 0;   /* 0 for fake sinks (no ioctls) */
+
+// ----------------------------
+// Virtual pointer setup
+// ----------------------------
+static int uinput_setup_pointer(int fd, const char *name) {
+    if (ioctl(fd, UI_SET_EVBIT, EV_KEY) < 0 ||
+        ioctl(fd, UI_SET_KEYBIT, BTN_LEFT) < 0 ||
+        ioctl(fd, UI_SET_KEYBIT, BTN_RIGHT) < 0 ||
+        ioctl(fd, UI_SET_KEYBIT, MICRO_KEY) < 0 ||     /* key action */
+        ioctl(fd, UI_SET_EVBIT, EV_REL) < 0 ||
+        ioctl(fd, UI_SET_RELBIT, REL_X) < 0 ||
+        ioctl(fd, UI_SET_RELBIT, REL_Y) < 0)
+        return -1;
+
+    struct uinput_setup setup;
+    memset(&setup, 0, sizeof(setup));
+    setup.id.bustype = BUS_USB;
+    setup.id.vendor  = UINPUT_VENDOR_ID;
+    setup.id.product = UINPUT_PRODUCT_ID;
+    snprintf(setup.name, sizeof(setup.name), "%s", name);
+
+    if (ioctl(fd, UI_DEV_SETUP, &setup) < 0)
+        return -1;
+
+    return ioctl(fd, UI_DEV_CREATE);
+}
+
+// ----------------------------
+// Public: open a device named name (real uinput or fake sink), -1 on error
+// ----------------------------
+static int uinput_create(const char *path, const char *name, int *is_device) {
+    int fd = open(path, O_WRONLY | O_CLOEXEC);
+    if (fd < 0)
+        return -1;
+
+    struct stat st;
+    *is_device = (fstat(fd, &st) == 0 && S_ISCHR(st.st_mode));
+
+    if (*is_device && uinput_setup_pointer(fd, name) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void uinput_destroy(int fd, int is_device) {
+    if (is_device)
+        ioctl(fd, UI_DEV_DESTROY);
+    close(fd);
+}
+
+// ----------------------------
+// Public: open the daemon's device
+// ----------------------------
+static int uinput_open(const char *path) {
+    int fd = uinput_create(path, UINPUT_DEVICE_NAME, &uinput_is_device);
+    if (fd < 0)
+        return -1;
+
+    uinput_fd = fd;
+    return 0;
+}
+
+static void uinput_close(void) {
+    if (uinput_fd < 0)
+        return;
+
+    uinput_destroy(uinput_fd, uinput_is_device);
+    uinput_fd = -1;
+}
+
+// ----------------------------
+// Write a frame of events with a single writev()
+// ----------------------------
+static int uinput_send(int fd, const struct input_event *ev, int n) {
+    if (fd < 0)
+        return -1;
+
+    struct iovec iov = {
+        .iov_base = (void *)ev,
+        .iov_len  = (size_t)n * sizeof(*ev)
+    };
+
+    for (;;) {
+        ssize_t r = writev(fd, &iov, 1);
+        if (r < 0 && errno == EINTR)
+            continue;
+        return r == (ssize_t)iov.iov_len ? 0 : -1;
+    }
+}
+
+// ----------------------------
+// Public: relative mouse move
+// ----------------------------
+static int uinput_move_to(int fd, int dx, int dy) {
+    struct input_event ev[3];
+    int n = build_rel_frame(ev, dx, dy);
+    return uinput_send(fd, ev, n);
+}
+
+static int uinput_move(int dx, int dy) {
+    return uinput_move_to(uinput_fd, dx, dy);
+}
+
+// ----------------------------
+// Public: key press (1) or release (0)
+// ----------------------------
+static int uinput_key_to(int fd, int code, int value) {
+    struct input_event ev[2];
+    int n = build_key_frame(ev, code, value);
+    return uinput_send(fd, ev, n);
+}
+
+static int uinput_key(int code, int value) {
+    return uinput_key_to(uinput_fd, code, value);
+}
+
+#endif // INJECT_UINPUT_H
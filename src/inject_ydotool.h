@@ -0,0 +1,121 @@
+// Native ydotoold client for Jigglemil
+// Writes raw input_event records straight to the ydotoold socket instead of
+// spawning the ydotool CLI (shell + process) for every path point.
+
+#ifndef INJECT_YDOTOOL_H
+#define INJECT_YDOTOOL_H
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <linux/input.h>
+
+#include "inject_common.h"
+
+/* connected datagram socket to ydotoold, -1 when not connected */
+static int ydotool_fd = -1;
+static char ydotool_path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+
+// ----------------------------
+// Connect to ydotoold (kept open across actions)
+// ----------------------------
+static int ydotool_connect(const char *path) {
+    if (!path || !*path)
+        return -1;
+
+    if (ydotool_fd >= 0)
+        close(ydotool_fd);
+
+    snprintf(ydotool_path, sizeof(ydotool_path), "%s", path);
+
+    ydotool_fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (ydotool_fd < 0)
+        return -1;
+
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", ydotool_path);
+
+    if (connect(ydotool_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(ydotool_fd);
+        ydotool_fd = -1;
+        return -1;
+    }
+
+    return 0;
+}
+
+static void ydotool_disconnect(void) {
+    if (ydotool_fd >= 0) {
+        close(ydotool_fd);
+        ydotool_fd = -1;
+    }
+}
+
+// ----------------------------
+// Send events: ydotoold reads one input_event per datagram,
+// so a whole frame goes out as a single sendmmsg()
+// ----------------------------
+static int ydotool_send_once(const struct input_event *ev, int n) {
+    struct mmsghdr msgs[8];
+    struct iovec iov[8];
+
+    if (n > 8) n = 8;
+
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < n; i++) {
+        iov[i].iov_base = (void *)&ev[i];
+        iov[i].iov_len  = sizeof(ev[i]);
+        msgs[i].msg_hdr.msg_iov    = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int sent = 0;
+    while (sent < n) {
+        int r = sendmmsg(ydotool_fd, msgs + sent, n - sent, 0);
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        sent += r;
+    }
+    return 0;
+}
+
+static int ydotool_send(const struct input_event *ev, int n) {
+    if (ydotool_fd < 0)
+        return -1;
+
+    if (ydotool_send_once(ev, n) == 0)
+        return 0;
+
+    /* ydotoold restarted - reconnect once and retry */
+    if (errno == ECONNREFUSED || errno == ENOTCONN || errno == ENOENT) {
+        if (ydotool_connect(ydotool_path) == 0)
+            return ydotool_send_once(ev, n);
+    }
+    return -1;
+}
+
+// ----------------------------
+// Public: relative mouse move
+// ----------------------------
+static int ydotool_move(int dx, int dy) {
+    struct input_event ev[3];
+    int n = build_rel_frame(ev, dx, dy);
+    return ydotool_send(ev, n);
+}
+
+// ----------------------------
+// Public: key press (1) or release (0)
+// ----------------------------
+static int ydotool_key(int code, int value) {
+    struct input_event ev[2];
+    int n = build_key_frame(ev, code, value);
+    return ydotool_send(ev, n);
+}
+
+#endif // INJECT_YDOTOOL_H
@@ -10,9 +10,11 @@
 
 #define _POSIX_C_SOURCE 200809L
 #define _DEFAULT_SOURCE
+#define _GNU_SOURCE
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <unistd.h>
 #include <time.h>
@@ -20,40 +22,114 @@
 #include <signal.h>
 #include <sys/wait.h>
 #include <sys/stat.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <glob.h>
 #include "config.h"
+#include "inject_ydotool.h"
+#include "inject_uinput.h"
+#include "pacer.h"
+#include "rng.h"
+#include "windmouse.h"
+#include "windmouse_multi.h"
+#include "corpus.h"
+#include "coalesce.h"
+#include "stats.h"
+#include "runtime_dir.h"
+#include "control.h"
+#include "status_page.h"
+#include "logger.h"
+#include "watch.h"
+#include "session.h"
+#include "notify.h"
+#include "seat.h"
+#include "sim.h"
+
+#include "idle_detector.h"
 
-#ifdef USE_GNOME_IDLE
-#include "idle_detector_gnome.h"
-#else
-#include "idle_detector_libinput.h"
-#endif
 
 
-
-// ============================================================================
-// DATA STRUCTURES
-// ============================================================================
-
-typedef struct {
-    int dx;
-    int dy;
-    int delay_us;
-} PathPoint;
-
-typedef struct {
-    PathPoint points[MAX_PATH_POINTS];
-    int count;
-} MousePath;
-
 // ============================================================================
 // GLOBAL STATE
 // ============================================================================
 
 volatile sig_atomic_t g_running = 1;
+volatile sig_atomic_t g_dump_stats = 0;
+volatile sig_atomic_t g_reap_children = 0;
 int g_smooth_mode = 0;
 int g_watch_mode = 0;
+int g_use_uinput = 0;
+int g_realtime = 0;
+int g_status_page = 0;
+int g_coalesce_hz = COALESCE_HZ;
+const char *g_action_mode = ACTION_MODE;
+const char *g_idle_backend = "auto";
+
+// Seats (seat.h): without --seat a single one that follows the idle
+// backend; pause / trigger / state live per seat
+static Seat *g_seats[SEAT_MAX];
+static int g_seat_count = 0;
+static const char *g_seat_specs[SEAT_MAX];
+static int g_seat_spec_count = 0;
+
+static const char *g_parked = NULL;     // logind park reason (session.h), NULL = running
+
+// Per seat: the action it is playing, one input per wakeup of the seat's
+// playback timer (seat.h), so seats play side by side on the main loop
+typedef enum { PLAY_NONE, PLAY_KEY, PLAY_PATH, PLAY_VERIFY } PlayStage;
+
+typedef struct {
+    PlayStage   stage;
+    int         kind;           // strategy being played (ActionKind)
+    int         forced;         // --action, ACTION_COUNT = auto
+    const Settings *cfg;        // one snapshot from start to end
+    long long   start_ns;
+    long long   first_due_ns;   // when it became due; 0 once the first input is out
+    long long   done_ns;        // last input of a key tap or jiggle (verification)
+    int         errors;         // failed injections of this strategy
+
+    PathStream  path;
+    Coalescer   co;
+    Pacer       pacer;
+    PackedPoint next;           // due at the pacer's deadline
+    int         have_next;
+    int         smooth;         // boosted and logged like smooth mode
+    long        fixed_us;       // > 0: every move this far apart (batch, not coalesced)
+    long        planned_us;
+
+    long        late_us[MAX_PATH_POINTS];   // per point, us past its deadline
+    PackedPoint points[MAX_PATH_POINTS];    // jiggle, replay or best candidate
+} SeatPlay;
+
+static SeatPlay *g_play[SEAT_MAX];
+
+// Daemon-wide PRNG: targets, thresholds and per-path seeds all come from
+// here, so --seed makes a run reproducible
+static Rng g_rng;
+static uint64_t g_seed;
+static int g_seed_set = 0;
+const char *g_uinput_path = UINPUT_PATH;
+
+// Motion corpus (--record / --replay)
+const char *g_record_path = NULL;
+const char *g_replay_path = NULL;
+static Corpus g_corpus = { .fd = -1 };
+
+// --simulate: replay an activity trace on a virtual clock, then exit
+static const char *g_sim_path = NULL;
+
+// Runtime files (runtime_dir.h), resolved at startup; one status page per
+// seat with --status-page
+static char g_pid_path[256];
+static char g_stats_path[256];
+static StatusPage *g_pages[SEAT_MAX];
+
+// Runtime settings file (settings.h), re-read when inotify sees it change
+static char g_config_path[256];
+static int g_config_changed = 0;
 
 // ============================================================================
 // SIGNAL HANDLING
@@ -64,6 +140,16 @@ void handle_signal(int sig) {
     g_running = 0;
 }
 
+void handle_dump(int sig) {
+    (void)sig;
+    g_dump_stats = 1;
+}
+
+void handle_child(int sig) {
+    (void)sig;
+    g_reap_children = 1;
+}
+
 void setup_signals(void) {
     struct sigaction sa = {0};
     sa.sa_handler = handle_signal;
@@ -73,158 +159,419 @@ void setup_signals(void) {
     sigaction(SIGTERM, &sa, NULL);
     sigaction(SIGINT, &sa, NULL);
     sigaction(SIGHUP, &sa, NULL);
+
+    // Stats dump request: handled by the main loop, never mid-playback
+    sa.sa_handler = handle_dump;
+    sa.sa_flags   = SA_RESTART;
+    sigaction(SIGUSR1, &sa, NULL);
+
+    // Exited helpers (notify-send fallback): reaped by the main loop
+    sa.sa_handler = handle_child;
+    sa.sa_flags   = SA_RESTART | SA_NOCLDSTOP;
+    sigaction(SIGCHLD, &sa, NULL);
+}
+
+// In a forked helper before exec: output to /dev/null, and none of the
+// signals the main loop keeps blocked (exec would pass the mask on)
+static void child_setup(void) {
+    sigset_t none;
+    sigemptyset(&none);
+    sigprocmask(SIG_SETMASK, &none, NULL);
+
+    int devnull = open("/dev/null", O_WRONLY);
+    if (devnull >= 0) {
+        dup2(devnull, STDOUT_FILENO);
+        dup2(devnull, STDERR_FILENO);
+        close(devnull);
+    }
+}
+
+// Collect every exited child; helpers we wait for ourselves are already gone
+static void reap_children(void) {
+    g_reap_children = 0;
+    while (waitpid(-1, NULL, WNOHANG) > 0)
+        ;
 }
 
 // ============================================================================
 // LOGGING & STATE
 // ============================================================================
 
-void get_timestamp(char *buf, size_t size) {
-    time_t now = time(NULL);
-    struct tm *t = localtime(&now);
-    strftime(buf, size, "%H:%M:%S", t);
+// Queued for the logger thread (logger.h): no file I/O on the caller
+void log_msg(const char *msg) {
+    log_write(LOG_INFO, "%s", msg);
 }
 
-void log_msg(const char *msg) {
-    char ts[16];
-    get_timestamp(ts, sizeof(ts));
+// Watch mode display: hand the seat's state to the render thread (watch.h)
+void display_watch(const Seat *s, const char *status, const char *emoji, long idle_ms) {
+    if (!g_watch_mode) return;
+    watch_publish(s->index, s->name, status, emoji, idle_ms, s->action_limit,
+                  g_parked ? WATCH_PARKED : s->paused, g_smooth_mode);
+}
+
+// Only touches the file when the state changes; readers see the old or the
+// new file, never a truncated one
+void save_state(Seat *s, const char *emoji) {
+    if (s->state_written && strcmp(emoji, s->state) == 0)
+        return;
 
-    FILE *fp = fopen(LOG_FILE, "a");
+    s->state = emoji;
+    s->state_written = 1;
+
+    char tmp[sizeof(s->state_path) + 4];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", s->state_path);
+    FILE *fp = fopen(tmp, "w");
     if (fp) {
-        fprintf(fp, "%s | %s\n", ts, msg);
+        fprintf(fp, "%s", emoji);
+        if (fclose(fp) == 0)
+            rename(tmp, s->state_path);
+    }
+}
+
+void save_pid(void) {
+    FILE *fp = fopen(g_pid_path, "w");
+    if (fp) {
+        fprintf(fp, "%d", getpid());
         fclose(fp);
     }
 }
 
-// Watch mode display
-void display_watch(const char *status, const char *emoji, long idle_ms, long action_limit) {
-    if (!g_watch_mode) return;
+void remove_pid(void) {
+    unlink(g_pid_path);
+}
 
-    long idle_sec = idle_ms / 1000;
-    long warning_sec = WARNING_LIMIT_MS / 1000;  // 30s
+// Stats snapshot: JSON file (atomic replace), optionally a summary in the log
+void save_stats(int to_log) {
+    static char buf[4096];
+    int len = stats_format_json(buf, sizeof(buf));
 
-    // Calculate timers
-    long green_left = warning_sec - idle_sec;  // time until red
-    if (green_left < 0) green_left = 0;
+    char tmp[sizeof(g_stats_path) + 4];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", g_stats_path);
+    FILE *fp = fopen(tmp, "w");
+    if (fp) {
+        fwrite(buf, 1, (size_t)len, fp);
+        if (fclose(fp) == 0)
+            rename(tmp, g_stats_path);
+    }
 
-    long red_left = (action_limit - idle_ms) / 1000;  // time until action
-    if (red_left < 0) red_left = 0;
+    if (!to_log) return;
+
+    char line[160];
+    snprintf(line, sizeof(line), "STATS: %llu actions, %llu points, %llu inject errors, %llu idle events",
+             (unsigned long long)atomic_load(&stat_counters[STAT_ACTIONS]),
+             (unsigned long long)atomic_load(&stat_counters[STAT_POINTS]),
+             (unsigned long long)atomic_load(&stat_counters[STAT_INJECT_ERRORS]),
+             (unsigned long long)atomic_load(&stat_counters[STAT_IDLE_EVENTS]));
+    log_msg(line);
+    for (int h = 0; h < STAT_HIST_COUNT; h++) {
+        char hl[128];
+        stats_hist_line((StatHist)h, hl, sizeof(hl));
+        snprintf(line, sizeof(line), "    %s", hl);
+        log_msg(line);
+    }
+}
 
-    char ts[16];
-    get_timestamp(ts, sizeof(ts));
 
-    // Clear screen and move cursor to top
-    printf("\033[2J\033[H");
+// ============================================================================
+// NOTIFICATION (optional, non-blocking)
+// ============================================================================
 
-    printf("═══════════════════════════════════════════\n");
-    printf("       JIGGLEMIL - WATCH MODE\n");
-    printf("═══════════════════════════════════════════\n");
-    printf("\n");
-    printf("  %s  %s\n", emoji, status);
-    printf("\n");
+// Over the session bus (notify.h), replacing the previous popup; without
+// a bus, fork notify-send and let the main loop reap it on SIGCHLD
+void notify(const char *title, const char *body) {
+    if (notify_dbus(title, body) == 0)
+        return;
 
-    if (idle_sec < warning_sec) {
-        // Green phase - show countdown to red
-        printf("      Green:  %2ld s  ↓\n", green_left);
-        printf("      Red:    --\n");
-    } else {
-        // Red phase - show countdown to action
-        printf("      Green:   0 s\n");
-        printf("      Red:   %2ld s  ↓\n", red_left);
+    pid_t pid = fork();
+    if (pid == 0) {
+        child_setup();
+        execlp("notify-send", "notify-send", title, body, NULL);
+        _exit(0);
     }
+}
 
-    printf("\n");
-    printf("═══════════════════════════════════════════\n");
-    printf("  [%s]  Mode: %s\n", ts, g_smooth_mode ? "SMOOTH" : "BATCH");
-    printf("═══════════════════════════════════════════\n");
-    printf("\n");
-    printf("  Press Ctrl+C to stop\n");
+// ============================================================================
+// SEATS
+// ============================================================================
 
-    fflush(stdout);
+static Seat *seat_find(const char *name) {
+    for (int i = 0; i < g_seat_count; i++) {
+        if (strcmp(g_seats[i]->name, name) == 0)
+            return g_seats[i];
+    }
+    return NULL;
 }
 
-void save_state(const char *emoji) {
-    FILE *fp = fopen(STATE_FILE, "w");
-    if (fp) {
-        fprintf(fp, "%s", emoji);
-        fclose(fp);
-    }
+// A runtime file of the seat: the default seat keeps the plain name
+// (jigglemil.state), a --seat one gets its own (jigglemil.NAME.state)
+static void seat_file(const Seat *s, char *buf, size_t size, const char *plain,
+                      const char *per_seat) {
+    char name[SEAT_NAME_MAX + 32];
+    if (s->backend)
+        snprintf(name, sizeof(name), "%s", plain);
+    else
+        snprintf(name, sizeof(name), per_seat, s->name);
+    runtime_path(buf, size, name);
 }
 
-void save_pid(void) {
-    FILE *fp = fopen(PID_FILE, "w");
-    if (fp) {
-        fprintf(fp, "%d", getpid());
-        fclose(fp);
+// Idle time of a seat: the idle backend for the default seat, else the
+// seat's own inputs
+static long seat_idle_time(Seat *s) {
+    return s->backend ? get_idle_time() : seat_idle_ms(s);
+}
+
+// Next slot in the seat table, on the loop's epoll
+static Seat *seat_new(int epfd, const char *name) {
+    if (g_seat_count >= SEAT_MAX || !*name || strchr(name, '/') || seat_find(name))
+        return NULL;
+
+    Seat *s = calloc(1, sizeof(*s));
+    SeatPlay *play = calloc(1, sizeof(*play));
+    if (!s || !play || seat_init(s, name, g_seat_count, epfd) < 0) {
+        free(s);
+        free(play);
+        return NULL;
     }
+    g_play[g_seat_count] = play;
+    g_seats[g_seat_count++] = s;
+    return s;
 }
 
-void remove_pid(void) {
-    unlink(PID_FILE);
+// --seat NAME[:INPUT,...[:SINK]]. Without inputs the seat takes the evdev
+// nodes udev assigns to it; without a sink it gets its own uinput device.
+static int seat_open_spec(int epfd, const char *spec) {
+    char buf[512];
+    snprintf(buf, sizeof(buf), "%s", spec);
+
+    char *inputs = strchr(buf, ':');
+    if (inputs) *inputs++ = '\0';
+    char *sink = inputs ? strchr(inputs, ':') : NULL;
+    if (sink) *sink++ = '\0';
+
+    Seat *s = seat_new(epfd, buf);
+    if (!s) {
+        fprintf(stderr, "jigglemil: cannot add seat '%s'\n", buf);
+        return -1;
+    }
+    snprintf(s->tag, sizeof(s->tag), "[%s] ", s->name);
+    seat_file(s, s->state_path, sizeof(s->state_path), STATE_FILE, SEAT_STATE_FILE);
+
+    s->discover = !inputs || !*inputs;
+    for (char *in = s->discover ? NULL : strtok(inputs, ","); in; in = strtok(NULL, ",")) {
+        if (seat_open_input(s, in) < 0) {
+            fprintf(stderr, "jigglemil: seat %s: cannot open %s: %s\n", s->name, in, strerror(errno));
+            return -1;
+        }
+    }
+
+    const char *path = sink && *sink ? sink : g_uinput_path;
+    if (seat_open_sink(s, path) < 0) {
+        fprintf(stderr, "jigglemil: seat %s: cannot open %s: %s\n", s->name, path, strerror(errno));
+        return -1;
+    }
+    return 0;
 }
 
+// ============================================================================
+// SETTINGS (config file, hot reload)
+// ============================================================================
+
+// Re-read the config file after inotify saw it change. Runs between seat
+// steps; an action that is playing keeps the snapshot it started with.
+// Every seat keeps the deadline it drew and is re-evaluated against the
+// new settings on this pass. The idle backend gets a new warning
+// threshold: a compositor watch left at the old one would report an
+// active user idle for up to the old threshold.
+static void config_reload(void) {
+    g_config_changed = 0;
+
+    long warning_ms = settings_get()->warning_limit_ms;
+    char changed[1024];
+    int n = settings_load(g_config_path, changed, sizeof(changed));
+    if (n < 0) {
+        log_write(LOG_WARN, "Config: %s, keeping the current settings", changed);
+        return;
+    }
+    if (n == 0)
+        return;
+
+    log_write(LOG_INFO, "Config: reloaded, %d changed: %s", n, changed);
+    if (settings_get()->warning_limit_ms != warning_ms)
+        idle_detector_rearm(settings_get()->warning_limit_ms);
+    for (int i = 0; i < g_seat_count; i++)
+        g_seats[i]->due = 1;
+}
 
 // ============================================================================
-// WINDMOUSE PATH GENERATOR (Pure function, no side effects)
+// CONTROL SOCKET
 // ============================================================================
 
-static double randf(double min, double max) {
-    return min + ((double)rand() / RAND_MAX) * (max - min);
+static const char *state_name(const char *emoji) {
+    if (strcmp(emoji, "🟢") == 0) return "green";
+    if (strcmp(emoji, "🔴") == 0) return "red";
+    if (strcmp(emoji, "🟡") == 0) return "action";
+    if (strcmp(emoji, "⏸") == 0)  return "paused";
+    return "stopped";
 }
 
-MousePath generate_wind_path(double target_x, double target_y) {
-    MousePath path = {0};
+// One seat's line of the status reply
+static int seat_status(Seat *s, char *reply, size_t size) {
+    long idle_ms = seat_idle_time(s);
+    long next_ms = s->action_limit - idle_ms;
+    if (next_ms < 0) next_ms = 0;
+    if (s->paused || g_parked) next_ms = -1;
+
+    return snprintf(reply, size,
+                    "{\"seat\": \"%s\", \"state\": \"%s\", \"emoji\": \"%s\", \"idle_ms\": %ld, "
+                    "\"next_action_ms\": %ld, \"paused\": %s, \"parked\": %s%s%s, "
+                    "\"actions\": %llu, \"mode\": \"%s\", \"idle_backend\": \"%s\", \"pid\": %d}\n",
+                    s->name, state_name(s->state), s->state, idle_ms, next_ms,
+                    s->paused ? "true" : "false",
+                    g_parked ? "\"" : "", g_parked ? g_parked : "false", g_parked ? "\"" : "",
+                    s->actions, g_smooth_mode ? "smooth" : "batch",
+                    s->backend ? idle_detector_name() : "seat", (int)getpid());
+}
 
-    // Randomize parameters for this movement (each path is unique)
-    double mouse_speed   = randf(MOUSE_SPEED_MIN, MOUSE_SPEED_MAX);
-    double gravity       = randf(GRAVITY_MIN, GRAVITY_MAX);
-    double wind          = randf(WIND_MIN, WIND_MAX);
-    double target_radius = randf(TARGET_RADIUS_MIN, TARGET_RADIUS_MAX);
-    double max_step      = randf(MAX_STEP_MIN, MAX_STEP_MAX);
+// One command in, one reply out (runs on the main thread). "CMD SEAT"
+// addresses one seat; without it, state answers for the first seat and
+// the rest act on every seat.
+static int control_handle(const char *req, char *reply, size_t size) {
+    const char *arg = strchr(req, ' ');
+    size_t cmd_len = arg ? (size_t)(arg - req) : strlen(req);
+    char cmd[16];
+    snprintf(cmd, sizeof(cmd), "%.*s", (int)cmd_len, req);
+
+    Seat *only = NULL;
+    if (arg && !(only = seat_find(arg + 1)))
+        return snprintf(reply, size, "error: unknown seat '%s'\n", arg + 1);
+
+    int first = only ? only->index : 0;
+    int last  = only ? only->index : g_seat_count - 1;
+
+    if (strcmp(cmd, "ping") == 0)
+        return snprintf(reply, size, "pong\n");
+
+    if (strcmp(cmd, "state") == 0)
+        return snprintf(reply, size, "%s\n", g_seats[first]->state);
+
+    if (strcmp(cmd, "status") == 0) {
+        int len = 0;
+        for (int i = first; i <= last && (size_t)len < size; i++)
+            len += seat_status(g_seats[i], reply + len, size - (size_t)len);
+        return len < (int)size ? len : (int)size - 1;
+    }
 
-    double x = 0, y = 0;
-    double vx = 0, vy = 0;
-    double wx = 0, wy = 0;
+    if (strcmp(cmd, "stats") == 0)
+        return stats_format_json(reply, size);
+
+    if (strcmp(cmd, "stop") == 0) {
+        g_running = 0;
+    } else if (strcmp(cmd, "pause") == 0 || strcmp(cmd, "resume") == 0 ||
+               strcmp(cmd, "trigger") == 0) {
+        for (int i = first; i <= last; i++) {
+            Seat *s = g_seats[i];
+            if (cmd[0] == 't')
+                s->trigger = 1;
+            else
+                s->paused = cmd[0] == 'p';
+            s->due = 1;
+        }
+        if (cmd[0] != 't')
+            notify("Jigglemil", cmd[0] == 'p' ? "Paused" : "Running");
+    } else {
+        return snprintf(reply, size,
+                        "error: unknown command (ping|state|status|stats|pause|resume|trigger|stop [SEAT])\n");
+    }
+
+    char msg[80];
+    snprintf(msg, sizeof(msg), "CONTROL: %s", req);
+    log_msg(msg);
+    return snprintf(reply, size, "ok\n");
+}
+
+// Answer every waiting client; ones whose request is still in flight
+// are parked in epoll and finished by loop_wait
+static void control_service(int epfd) {
+    int fd;
+    while ((fd = ctl_accept()) >= 0) {
+        if (ctl_serve(fd, control_handle) == 0)
+            continue;
+
+        struct epoll_event ev = { .events = EPOLLIN, .data.u64 = (uint64_t)fd };
+        if (epfd < 0 || epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) < 0)
+            close(fd);
+    }
+}
 
-    while (hypot(target_x - x, target_y - y) > target_radius
-           && path.count < MAX_PATH_POINTS) {
+// Client mode (--ctl CMD): print the daemon's reply
+static int control_client(const char *cmd) {
+    char reply[CTL_MSG_MAX];
+    if (ctl_request(cmd, reply, sizeof(reply)) < 0) {
+        if (strcmp(cmd, "state") == 0)
+            printf("⚫\n");
+        else
+            fprintf(stderr, "jigglemil: not running\n");
+        return 1;
+    }
 
-        double dist = hypot(target_x - x, target_y - y);
+    fputs(reply, stdout);
+    return strncmp(reply, "error", 5) == 0 ? 2 : 0;
+}
 
-        // Wind component (random drift)
-        wx = wx / sqrt(3.0) + randf(-wind, wind) / sqrt(5.0);
-        wy = wy / sqrt(3.0) + randf(-wind, wind) / sqrt(5.0);
+// One status page as a JSON line (--peek); -1 if it is not one, 1 if its
+// daemon has stopped
+static int status_page_print(const char *path, const char *seat) {
+    const StatusPage *page = status_page_map(path);
+    StatusPage snap;
+    int ok = page && status_page_read(page, &snap) == 0;
+    if (page)
+        status_page_unmap(page);
+    if (!ok || (seat && strcmp(snap.seat, seat) != 0))
+        return -1;
 
-        // Velocity update (gravity pulls toward target)
-        if (dist > 0) {
-            vx += (wx + (target_x - x) * gravity / dist) / mouse_speed;
-            vy += (wy + (target_y - y) * gravity / dist) / mouse_speed;
-        }
+    if (snap.pid == 0) {
+        printf("{\"seat\": \"%s\", \"state\": \"stopped\", \"emoji\": \"⚫\"}\n", snap.seat);
+        return 1;
+    }
 
-        // Clamp velocity
-        double vel = hypot(vx, vy);
-        if (vel > max_step) {
-            vx = (vx / vel) * max_step;
-            vy = (vy / vel) * max_step;
-        }
+    int64_t now = realtime_ms();
+    long long next_ms = snap.next_action_ms < 0 ? -1 :
+                        snap.next_action_ms > now ? snap.next_action_ms - now : 0;
+    printf("{\"seat\": \"%s\", \"state\": \"%s\", \"emoji\": \"%s\", \"idle_ms\": %lld, "
+           "\"next_action_ms\": %lld, \"paused\": %s, \"actions\": %llu, \"pid\": %d}\n",
+           snap.seat, state_name(snap.state), snap.state, (long long)(now - snap.last_activity_ms),
+           next_ms, snap.paused ? "true" : "false",
+           (unsigned long long)snap.actions, (int)snap.pid);
+    return 0;
+}
 
-        // Calculate pixel delta
-        int dx = (int)round(x + vx) - (int)round(x);
-        int dy = (int)round(y + vy) - (int)round(y);
+// Client mode (--peek [SEAT]): read the status pages, no daemon round-trip.
+// One line per seat (the default seat's page first), or only SEAT's.
+static int status_page_client(const char *seat) {
+    char path[256], name[64];
+    int printed = 0, running = 0, r;
 
-        x += vx;
-        y += vy;
+    if (runtime_path(path, sizeof(path), STATUS_PAGE_NAME) == 0 &&
+        (r = status_page_print(path, seat)) >= 0) {
+        printed = 1;
+        running |= r == 0;
+    }
 
-        // Only record actual movements
-        if (dx != 0 || dy != 0) {
-            path.points[path.count].dx = dx;
-            path.points[path.count].dy = dy;
-            path.points[path.count].delay_us = (int)randf(MIN_DELAY_US, MAX_DELAY_US);
-            path.count++;
+    snprintf(name, sizeof(name), SEAT_STATUS_PAGE, "*");
+    glob_t g;
+    if (runtime_path(path, sizeof(path), name) == 0 && glob(path, 0, NULL, &g) == 0) {
+        for (size_t i = 0; i < g.gl_pathc; i++) {
+            if ((r = status_page_print(g.gl_pathv[i], seat)) >= 0) {
+                printed = 1;
+                running |= r == 0;
+            }
         }
+        globfree(&g);
     }
 
-    return path;
+    if (!printed)
+        printf("{\"state\": \"stopped\", \"emoji\": \"⚫\"}\n");
+    return !running;
 }
 
 // ============================================================================
@@ -238,97 +585,954 @@ static int exec_ydotool(char *const argv[]) {
     if (pid < 0) {
         return -1;
     } else if (pid == 0) {
-        // Child process - redirect stdout/stderr to /dev/null
-        int devnull = open("/dev/null", O_WRONLY);
-        if (devnull >= 0) {
-            dup2(devnull, STDOUT_FILENO);
-            dup2(devnull, STDERR_FILENO);
-            close(devnull);
-        }
+        child_setup();
         execvp("ydotool", argv);
         _exit(127);
     } else {
         // Parent process
         int status;
-        waitpid(pid, &status, 0);
+        while (waitpid(pid, &status, 0) < 0) {
+            if (errno != EINTR)
+                return -1;
+        }
         return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
     }
 }
 
-// Batch mode: fast execution with minimal delays
-void execute_path_batch(const MousePath *path) {
-    if (path->count == 0) return;
+// Inject one relative move: the seat's device, own uinput device, or
+// persistent ydotoold socket with the CLI as fallback
+static int inject_move(const Seat *s, int dx, int dy) {
+    if (s->inject_fd >= 0)
+        return uinput_move_to(s->inject_fd, dx, dy);
+    if (g_use_uinput)
+        return uinput_move(dx, dy);
 
-    char cmd[128];
-    for (int i = 0; i < path->count && g_running; i++) {
-        snprintf(cmd, sizeof(cmd), "ydotool mousemove -- %d %d",
-                 path->points[i].dx, path->points[i].dy);
-        system(cmd);
-        usleep(5000);  // 5ms between moves
-    }
+    if (ydotool_move(dx, dy) == 0)
+        return 0;
+
+    char dx_str[16], dy_str[16];
+    snprintf(dx_str, sizeof(dx_str), "%d", dx);
+    snprintf(dy_str, sizeof(dy_str), "%d", dy);
+
+    char *argv[] = {"ydotool", "mousemove", "--", dx_str, dy_str, NULL};
+    return exec_ydotool(argv);
 }
 
-// Smooth mode: individual movements with delays (more human-like)
-void execute_path_smooth(const MousePath *path) {
-    for (int i = 0; i < path->count && g_running; i++) {
-        char dx_str[16], dy_str[16];
-        snprintf(dx_str, sizeof(dx_str), "%d", path->points[i].dx);
-        snprintf(dy_str, sizeof(dy_str), "%d", path->points[i].dy);
+// Inject one key press (1) or release (0), same backends as inject_move
+static int inject_key(const Seat *s, int code, int value) {
+    if (s->inject_fd >= 0)
+        return uinput_key_to(s->inject_fd, code, value);
+    if (g_use_uinput)
+        return uinput_key(code, value);
+
+    if (ydotool_key(code, value) == 0)
+        return 0;
 
-        char *argv[] = {"ydotool", "mousemove", "--", dx_str, dy_str, NULL};
-        exec_ydotool(argv);
+    char key_str[24];
+    snprintf(key_str, sizeof(key_str), "%d:%d", code, value);
 
-        usleep(path->points[i].delay_us);
+    char *argv[] = {"ydotool", "key", key_str, NULL};
+    return exec_ydotool(argv);
+}
+
+// Tighter wakeups while any seat plays smoothly; the settings are
+// process-wide, so the first path in boosts and the last one out restores
+static PacerBoost g_boost;
+static int g_boost_users = 0;
+
+static void playback_boost(int on) {
+    if (on && g_boost_users++ == 0)
+        pacer_boost(&g_boost, g_realtime, PLAYBACK_TIMERSLACK_NS, PLAYBACK_RT_PRIORITY);
+    else if (!on && --g_boost_users == 0)
+        pacer_unboost(&g_boost);
+}
+
+// Deadline -> first input, once per action (a jiggle and its fallback
+// path do not count twice)
+static void record_first_point(SeatPlay *p, long long t) {
+    if (!p->first_due_ns)
+        return;
+    stats_record(STAT_FIRST_POINT, t - p->first_due_ns);
+    p->first_due_ns = 0;
+}
+
+// The point's deadline has passed: inject it and account for it
+static void play_point(Seat *s, SeatPlay *p) {
+    long late = pacer_late(&p->pacer);
+
+    long long t0 = now_ns();
+    int err = inject_move(s, p->next.dx, p->next.dy);
+    long long t1 = now_ns();
+
+    stats_record(STAT_LATENESS, late * 1000ll);
+    stats_record(STAT_INJECT, t1 - t0);
+    stats_count(err ? STAT_INJECT_ERRORS : STAT_POINTS, 1);
+    p->errors += err != 0;
+    log_write(LOG_DEBUG, "%spoint %d: (%d, %d) late %ld us, inject %lld us%s", s->tag,
+              p->pacer.count, p->next.dx, p->next.dy, late, (t1 - t0) / 1000, err ? " FAILED" : "");
+    record_first_point(p, t1);
+}
+
+static void log_pacing(const Seat *s, const SeatPlay *p) {
+    const Pacer *pacer = &p->pacer;
+    if (pacer->count == 0) return;
+
+    log_write(LOG_INFO, "%s    -> Played %d points in %ld ms (planned %ld ms), "
+              "late avg %lld us / max %ld us", s->tag, pacer->count,
+              pacer_elapsed_us(pacer) / 1000, p->planned_us / 1000,
+              pacer->sum_late_us / pacer->count, pacer->max_late_us);
+}
+
+static void log_coalesce(const Seat *s, const Coalescer *co) {
+    if (co->frame_us <= 0 || co->out == 0) return;
+
+    log_write(LOG_INFO, "%s    -> Coalesced %d points into %d frames (%d Hz, %.1fx fewer writes)",
+              s->tag, co->in, co->out, g_coalesce_hz, (double)co->in / co->out);
+}
+
+// Start playing p->path on the seat's playback timer: each point fires at
+// its absolute deadline, so delays never drift. The first one is due now;
+// the rest of the path is computed in the slack between injections.
+static void play_path_begin(Seat *s, SeatPlay *p, int smooth, int hz, long fixed_us) {
+    coalesce_init(&p->co, &p->path, hz, fixed_us);
+    p->stage      = PLAY_PATH;
+    p->smooth     = smooth;
+    p->fixed_us   = hz > 0 ? 0 : fixed_us;
+    p->planned_us = 0;
+    if (smooth)
+        playback_boost(1);
+
+    pacer_start(&p->pacer, p->late_us, MAX_PATH_POINTS);
+    p->have_next = coalesce_pop(&p->co, &p->next);
+    watch_path_begin(s->index, stream_count(&p->path));
+    seat_play_at(s, &p->pacer.deadline);
+}
+
+// Smooth mode: individual movements with delays (more human-like).
+// Batch mode: fast execution, 5 ms between moves. One injection per
+// display frame at most either way (see coalesce.h).
+static void play_path(Seat *s, SeatPlay *p) {
+    if (g_smooth_mode)
+        play_path_begin(s, p, 1, g_coalesce_hz, 0);
+    else
+        play_path_begin(s, p, 0, g_coalesce_hz, 5000);
+}
+
+// The playback timer fired: play every point that is due (a late wakeup
+// catches up) and re-arm for the next one. Returns 1 once the path is out.
+static int play_path_tick(Seat *s, SeatPlay *p) {
+    while (p->have_next && pacer_due(&p->pacer)) {
+        play_point(s, p);
+        watch_path_point(s->index, p->co.in);
+        stream_fill(&p->path);
+
+        long delay = p->fixed_us > 0 ? p->fixed_us : p->next.delay_us;
+        p->have_next = coalesce_pop(&p->co, &p->next);
+        if (p->have_next) {
+            p->planned_us += delay;
+            pacer_advance(&p->pacer, delay);
+        }
     }
+    if (!p->have_next)
+        return 1;
+
+    seat_play_at(s, &p->pacer.deadline);
+    return 0;
 }
 
-void execute_path(const MousePath *path) {
-    if (g_smooth_mode) {
-        execute_path_smooth(path);
-    } else {
-        execute_path_batch(path);
+static void play_path_end(Seat *s, SeatPlay *p) {
+    if (p->smooth) {
+        playback_boost(0);
+        log_pacing(s, p);
+    }
+    log_coalesce(s, &p->co);
+    watch_path_end(s->index);
+    p->stage = PLAY_NONE;
+}
+
+// ============================================================================
+// MICRO ACTIONS
+// ============================================================================
+
+// Strategies, cheapest first. The scheduler tries them in this order and
+// keeps the first one the idle backend actually notices.
+typedef enum {
+    ACTION_KEY,         // one key press + release (4 events)
+    ACTION_JIGGLE,      // a few pixels out and back (2 * JIGGLE_STEPS moves)
+    ACTION_PATH,        // full WindMouse / replayed path (hundreds of moves)
+    ACTION_COUNT
+} ActionKind;
+
+static const char *const action_names[ACTION_COUNT] = { "key", "jiggle", "path" };
+static const StatCounter action_stats[ACTION_COUNT] = {
+    STAT_ACTION_KEY, STAT_ACTION_JIGGLE, STAT_ACTION_PATH
+};
+
+// Actions to skip after a miss, per seat and strategy
+static int g_action_skip[SEAT_MAX][ACTION_COUNT];
+
+static int action_parse(const char *name) {
+    if (strcmp(name, "auto") == 0)
+        return ACTION_COUNT;
+    for (int i = 0; i < ACTION_COUNT; i++)
+        if (strcmp(name, action_names[i]) == 0)
+            return i;
+    return -1;
+}
+
+// Press MICRO_KEY; the playback timer releases it after the hold time
+static void key_tap_begin(Seat *s, SeatPlay *p) {
+    p->stage = PLAY_KEY;
+    p->errors += inject_key(s, MICRO_KEY, 1) != 0;
+    record_first_point(p, now_ns());
+
+    pacer_start(&p->pacer, NULL, 0);
+    pacer_advance(&p->pacer, p->cfg->micro_key_hold_ms * 1000l);
+    seat_play_at(s, &p->pacer.deadline);
+}
+
+// The release goes out even if the press failed
+static void key_tap_end(Seat *s, SeatPlay *p) {
+    pacer_late(&p->pacer);
+    p->errors += inject_key(s, MICRO_KEY, 0) != 0;
+    p->stage = PLAY_NONE;
+
+    log_write(LOG_DEBUG, "%skey %d tapped%s", s->tag, MICRO_KEY, p->errors ? " FAILED" : "");
+}
+
+// JIGGLE_STEPS moves out along a random heading, then the same moves
+// negated in reverse order: the cursor ends exactly where it started
+static int build_jiggle(PackedPoint *out) {
+    const Settings *cfg = settings_get();
+    double a = rng_range(&g_rng, 0, 2 * M_PI);
+    double r = rng_range(&g_rng, cfg->jiggle_radius_px / 2.0, cfg->jiggle_radius_px);
+    int px = 0, py = 0, n = 0;
+
+    for (int i = 1; i <= JIGGLE_STEPS; i++) {
+        int x = (int)lround(r * i / JIGGLE_STEPS * cos(a));
+        int y = (int)lround(r * i / JIGGLE_STEPS * sin(a));
+        if (x == px && y == py)
+            continue;
+        out[n++] = (PackedPoint){
+            .dx = (int8_t)(x - px), .dy = (int8_t)(y - py),
+            .delay_us = (uint16_t)rng_range(&g_rng, cfg->min_delay_us, cfg->max_delay_us)
+        };
+        px = x;
+        py = y;
     }
+    for (int i = n - 1; i >= 0; i--) {
+        out[2 * n - 1 - i] = (PackedPoint){
+            .dx = (int8_t)-out[i].dx, .dy = (int8_t)-out[i].dy,
+            .delay_us = (uint16_t)rng_range(&g_rng, cfg->min_delay_us, cfg->max_delay_us)
+        };
+    }
+    return 2 * n;
+}
+
+// Not coalesced: out and back inside one frame would sum to nothing
+static void jiggle_begin(Seat *s, SeatPlay *p) {
+    int n = build_jiggle(p->points);
+    stream_init_packed(&p->path, p->points, n);
+    play_path_begin(s, p, 1, 0, 0);
+}
+
+// Did the seat's idle tracker see the action that ended at done_ns? The
+// loop keeps dispatching the idle backend and the seat's inputs meanwhile
+// (wayland learns about activity from "resumed" events).
+static int idle_reset_seen(Seat *s, const SeatPlay *p, long long now) {
+    return seat_idle_time(s) <= (now - p->done_ns) / 1000000 + p->cfg->micro_idle_slack_ms;
 }
 
 // ============================================================================
 // MAIN ACTION
 // ============================================================================
 
-void perform_wind_move(void) {
+static void wind_move_begin(Seat *s, SeatPlay *p) {
     // Random target - larger range = longer path with more waves
-    double tx = randf(-400, 400);
-    double ty = randf(-400, 400);
+    double tx = rng_range(&g_rng, -400, 400);
+    double ty = rng_range(&g_rng, -400, 400);
+    log_write(LOG_INFO, "%s    -> Target: (%.0f, %.0f)", s->tag, tx, ty);
+
+    long long t0 = now_ns();
+    int replay_count = g_corpus.map
+        ? corpus_pick(&g_corpus, &g_rng, (int)p->cfg->wind_target_points, tx, ty, p->points) : 0;
+
+    if (replay_count > 0) {
+        // A recorded segment of the user's own motion, turned toward the target
+        stream_init_packed(&p->path, p->points, replay_count);
+        stats_record(STAT_GENERATE, now_ns() - t0);
+
+        log_write(LOG_INFO, "%s    -> Replay: %d points (corpus: %llu segments)", s->tag,
+                  replay_count, (unsigned long long)corpus_segments(&g_corpus));
+    } else if (WIND_CANDIDATES > 1) {
+        // Generate every candidate up front (well under a millisecond), play
+        // a copy of the best: the next seat to act reuses the lanes
+        static WindCandidates cand;
+        int best = wind_candidates_generate(&cand, rng_next(&g_rng), tx, ty);
+        int count = cand.lanes.count[best];
+        memcpy(p->points, cand.points[best], sizeof(PackedPoint) * (size_t)count);
+        stream_init_packed(&p->path, p->points, count);
+        stats_record(STAT_GENERATE, now_ns() - t0);
+
+        log_write(LOG_INFO, "%s    -> Candidate: %d/%d (%.1fs)", s->tag,
+                  best + 1, WIND_CANDIDATES, cand.lanes.duration_us[best] / 1e6);
+    } else {
+        stream_init(&p->path, rng_next(&g_rng), tx, ty);
+        stats_record(STAT_GENERATE, now_ns() - t0);
+    }
+    play_path(s, p);
+}
 
-    char msg[128];
-    snprintf(msg, sizeof(msg), "    -> Target: (%.0f, %.0f)", tx, ty);
-    log_msg(msg);
+// Random idle threshold for the next action
+static long next_action_limit(void) {
+    const Settings *cfg = settings_get();
+    return cfg->min_action_ms +
+           (long)(rng_next(&g_rng) % (uint64_t)(cfg->max_action_ms - cfg->min_action_ms));
+}
 
-    MousePath path = generate_wind_path(tx, ty);
+// Bookkeeping once an action is over, however it played
+static void seat_action_end(Seat *s) {
+    s->actions++;
 
-    snprintf(msg, sizeof(msg), "    -> Path: %d points", path.count);
-    log_msg(msg);
+    // Randomize next threshold
+    s->action_limit = next_action_limit();
+
+    log_write(LOG_INFO, "%sDone. Next trigger: %lds", s->tag, s->action_limit / 1000);
+}
+
+// The action is over: the next pass of the seat's state machine takes it
+// from here
+static void action_end(Seat *s, SeatPlay *p) {
+    seat_play_stop(s);
+    p->stage = PLAY_NONE;
+
+    stats_record(STAT_ACTION, now_ns() - p->start_ns);
+    stats_count(STAT_ACTIONS, 1);
+    save_stats(0);
+    seat_action_end(s);
+
+    s->acting = 0;
+    s->acted  = 1;
+    s->due    = 1;
+}
+
+// Cheapest action that resets the idle time. A key tap or jiggle that the
+// idle backend does not notice is benched for micro_retry_actions actions
+// and the next strategy runs; the full path is the last resort and is not
+// verified. A forced --action skips the cheaper ones, not the fallback.
+static void action_next(Seat *s, SeatPlay *p) {
+    int *skip = g_action_skip[s->index];
+
+    while (++p->kind < ACTION_PATH) {
+        if (p->kind == p->forced || skip[p->kind] <= 0)
+            break;
+        skip[p->kind]--;
+    }
+
+    p->errors = 0;
+    if (p->kind == ACTION_KEY) {
+        key_tap_begin(s, p);
+    } else if (p->kind == ACTION_JIGGLE) {
+        jiggle_begin(s, p);
+    } else {
+        log_write(LOG_INFO, "%s    -> Action: path", s->tag);
+        wind_move_begin(s, p);
+    }
+}
+
+static void action_miss(Seat *s, SeatPlay *p) {
+    int retry = (int)p->cfg->micro_retry_actions;
+    log_write(LOG_WARN, "%s    -> Action: %s %s, skipping it for %d actions", s->tag,
+              action_names[p->kind], p->errors ? "failed to inject" : "did not reset idle", retry);
+    stats_count(STAT_ACTION_MISSES, 1);
+    g_action_skip[s->index][p->kind] = retry;
+    action_next(s, p);
+}
+
+// Look for the idle reset every 20 ms for up to micro_verify_ms
+static void action_verify(Seat *s, SeatPlay *p) {
+    long long now = now_ns();
+    if (idle_reset_seen(s, p, now)) {
+        log_write(LOG_INFO, "%s    -> Action: %s (idle reset in %lld ms)", s->tag,
+                  action_names[p->kind], (now - p->done_ns) / 1000000);
+        stats_count(action_stats[p->kind], 1);
+        g_action_skip[s->index][p->kind] = 0;
+        action_end(s, p);
+        return;
+    }
+
+    long long left_us = (p->done_ns + p->cfg->micro_verify_ms * 1000000ll - now) / 1000;
+    if (left_us <= 0) {
+        action_miss(s, p);
+        return;
+    }
+
+    struct timespec at;
+    clock_gettime(CLOCK_MONOTONIC, &at);
+    ts_add_us(&at, left_us < 20000 ? (long)left_us : 20000);
+    seat_play_at(s, &at);
+}
 
-    execute_path(&path);
+// A key tap or jiggle is out: verify it, unless it did not even inject
+static void action_check(Seat *s, SeatPlay *p) {
+    p->done_ns = now_ns();
+    if (p->errors) {
+        action_miss(s, p);
+        return;
+    }
+    p->stage = PLAY_VERIFY;
+    action_verify(s, p);
+}
+
+// Public: the seat's playback timer fired
+static void action_tick(Seat *s) {
+    SeatPlay *p = g_play[s->index];
+
+    switch (p->stage) {
+    case PLAY_KEY:
+        key_tap_end(s, p);
+        action_check(s, p);
+        break;
+    case PLAY_PATH:
+        if (!play_path_tick(s, p))
+            break;
+        play_path_end(s, p);
+        if (p->kind != ACTION_PATH) {
+            action_check(s, p);
+            break;
+        }
+        log_write(LOG_INFO, "%s    -> Path: %d points", s->tag, stream_count(&p->path));
+        stats_count(STAT_ACTION_PATH, 1);
+        action_end(s, p);
+        break;
+    case PLAY_VERIFY:
+        action_verify(s, p);
+        break;
+    case PLAY_NONE:
+        break;
+    }
+}
+
+// Public: start the seat's action; the first input is timed from
+// overdue_ms in the past (when it became due)
+static void action_begin(Seat *s, long overdue_ms) {
+    SeatPlay *p = g_play[s->index];
+    int forced = action_parse(g_action_mode);
+
+    p->forced       = forced >= 0 ? forced : ACTION_COUNT;
+    p->kind         = (p->forced < ACTION_COUNT ? p->forced : ACTION_KEY) - 1;
+    p->cfg          = settings_get();
+    p->start_ns     = now_ns();
+    p->first_due_ns = p->start_ns - overdue_ms * 1000000ll;
+    s->acting = 1;
+    s->acted  = 0;
+    action_next(s, p);
+}
+
+// Public: stop a playing action at exit (a held key goes up)
+static void action_cancel(Seat *s) {
+    SeatPlay *p = g_play[s->index];
+
+    if (p->stage == PLAY_KEY)
+        key_tap_end(s, p);
+    else if (p->stage == PLAY_PATH)
+        play_path_end(s, p);
+    p->stage = PLAY_NONE;
+    s->acting = 0;
+    seat_play_stop(s);
 }
 
 // ============================================================================
-// NOTIFICATION (optional, non-blocking)
+// EVENT LOOP (sleep until the next state transition)
 // ============================================================================
 
-void notify(const char *title, const char *body) {
-    pid_t pid = fork();
-    if (pid == 0) {
-        // Redirect to /dev/null
-        int devnull = open("/dev/null", O_WRONLY);
-        if (devnull >= 0) {
-            dup2(devnull, STDOUT_FILENO);
-            dup2(devnull, STDERR_FILENO);
-            close(devnull);
+typedef struct {
+    int epfd;
+    int wake_fd;        // eventfd: idle detector saw activity after idling
+    int tick_fd;        // watch mode: re-sample idle time every second
+    int idle_fd;        // idle detector's own pollable source, if any
+    int ctl_fd;         // control socket (listening), if open
+    int session_fd;     // logind connection (session.h), if any
+    int udev_fd;        // seat input hotplug (seat.h), if any
+    int conf_fd;        // inotify on the config file's directory, if any
+    sigset_t wait_mask; // signals are only delivered inside epoll_pwait
+} EventLoop;            // seats add their own timers and inputs (seat.h)
+
+// Watch mode tick
+static const struct itimerspec loop_tick = {
+    .it_interval = { .tv_sec = CHECK_INTERVAL_SEC },
+    .it_value    = { .tv_sec = CHECK_INTERVAL_SEC }
+};
+
+static int loop_add(EventLoop *loop, int fd) {
+    struct epoll_event ev = { .events = EPOLLIN, .data.u64 = (uint64_t)fd };
+    return epoll_ctl(loop->epfd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+static int loop_init(EventLoop *loop) {
+    loop->tick_fd  = -1;
+    loop->idle_fd  = -1;
+    loop->ctl_fd   = -1;
+    loop->session_fd = -1;
+    loop->udev_fd  = -1;
+    loop->conf_fd  = -1;
+    loop->epfd     = epoll_create1(EPOLL_CLOEXEC);
+    loop->wake_fd  = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    if (loop->epfd < 0 || loop->wake_fd < 0)
+        return -1;
+
+    if (loop_add(loop, loop->wake_fd) < 0)
+        return -1;
+
+    if (g_watch_mode) {
+        loop->tick_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+        if (loop->tick_fd < 0 || timerfd_settime(loop->tick_fd, 0, &loop_tick, NULL) < 0 ||
+            loop_add(loop, loop->tick_fd) < 0)
+            return -1;
+    }
+
+    // Block termination signals outside epoll_pwait so a signal can never
+    // slip in between the g_running check and going to sleep
+    sigset_t block;
+    sigemptyset(&block);
+    sigaddset(&block, SIGTERM);
+    sigaddset(&block, SIGINT);
+    sigaddset(&block, SIGHUP);
+    sigaddset(&block, SIGUSR1);
+    sigaddset(&block, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &block, &loop->wait_mask);
+
+    return 0;
+}
+
+static void loop_close(EventLoop *loop) {
+    if (loop->tick_fd >= 0)  close(loop->tick_fd);
+    if (loop->conf_fd >= 0)  close(loop->conf_fd);
+    if (loop->wake_fd >= 0)  close(loop->wake_fd);
+    if (loop->epfd >= 0)     close(loop->epfd);
+}
+
+// A seat's timer fired, its playback is due, or one of its inputs has events
+static void loop_seat_event(uint64_t tag) {
+    int idx = SEAT_TAG_SEAT(tag);
+    if (idx >= g_seat_count)
+        return;
+
+    Seat *s = g_seats[idx];
+    unsigned slot = SEAT_TAG_SLOT(tag);
+    uint64_t val;
+    if (slot == SEAT_SLOT_TIMER) {
+        if (read(s->timer_fd, &val, sizeof(val)) < 0) { /* drained anyway */ }
+        s->due = 1;
+    } else if (slot == SEAT_SLOT_PLAY) {
+        if (read(s->play_fd, &val, sizeof(val)) < 0) { /* drained anyway */ }
+        action_tick(s);
+    } else if (slot < SEAT_MAX_INPUTS && seat_drain(s, (int)slot) && s->watching) {
+        // Activity only matters to the loop when it ends a warning
+        s->due = 1;
+    }
+}
+
+// Sleep until a timer fires, activity wakes us, or a signal arrives
+static void loop_wait(EventLoop *loop) {
+    struct epoll_event evs[16];
+    int n = epoll_pwait(loop->epfd, evs, 16, -1, &loop->wait_mask);
+    stats_count(STAT_LOOP_WAKEUPS, 1);
+
+    for (int i = 0; i < n; i++) {
+        uint64_t tag = evs[i].data.u64;
+        if (tag & SEAT_EPOLL_TAG) {
+            loop_seat_event(tag);
+            continue;
+        }
+
+        int fd = (int)tag;
+        if (fd == loop->idle_fd) {
+            idle_detector_dispatch();
+            continue;
+        }
+        if (fd == loop->ctl_fd) {
+            control_service(loop->epfd);
+            continue;
+        }
+        if (fd == loop->session_fd) {
+            session_dispatch();
+            continue;
+        }
+        if (fd == loop->udev_fd) {
+            seat_hotplug(g_seats, g_seat_count);
+            continue;
+        }
+        if (fd == loop->conf_fd) {
+            g_config_changed |= settings_changed(fd);
+            continue;
+        }
+        if (fd != loop->wake_fd && fd != loop->tick_fd) {
+            // A parked control client; close() also drops it from epoll
+            ctl_serve(fd, control_handle);
+            continue;
+        }
+
+        uint64_t val;
+        // Drain the counter; the idle state is re-read by the seat step anyway
+        if (read(fd, &val, sizeof(val)) < 0) {
+            continue;
+        }
+        g_seats[0]->due = 1;
+    }
+}
+
+// Parked: disarm every timer and stop dispatching idle input, so only
+// logind, the control socket or a signal can wake the loop
+static void loop_park(EventLoop *loop, int parked) {
+    static const struct itimerspec off = {0};
+    for (int i = 0; i < g_seat_count; i++)
+        seat_park(g_seats[i], parked);
+    if (loop->tick_fd >= 0)
+        timerfd_settime(loop->tick_fd, 0, parked ? &off : &loop_tick, NULL);
+
+    if (loop->idle_fd >= 0) {
+        if (parked)
+            epoll_ctl(loop->epfd, EPOLL_CTL_DEL, loop->idle_fd, NULL);
+        else
+            loop_add(loop, loop->idle_fd);
+    }
+}
+
+// Follow logind: park everything while asleep, locked or switched away.
+// Nothing is carried over on resume; the next pass re-reads the idle
+// time (boot-time based) and re-arms each deadline from it.
+static void session_update(EventLoop *loop) {
+    const char *reason = session_parked();
+    if (!reason == !g_parked) {
+        g_parked = reason;      // still parked, maybe for another reason
+        return;
+    }
+
+    for (int i = 0; i < g_seat_count; i++)
+        g_seats[i]->due = 1;
+
+    if (reason) {
+        log_write(LOG_INFO, "PARKED (%s)", reason);
+        g_parked = reason;
+        for (int i = 0; i < g_seat_count; i++)
+            display_watch(g_seats[i], "PARKED", "⏸", 0);
+        loop_park(loop, 1);
+        idle_detector_park(1);
+        watch_park(1);
+    } else {
+        log_write(LOG_INFO, "RESUMED (was %s)", g_parked);
+        g_parked = NULL;
+        loop_park(loop, 0);
+        idle_detector_park(0);
+        watch_park(0);
+    }
+}
+
+// ============================================================================
+// SEAT DRIVER (real time and devices, or --simulate)
+// ============================================================================
+
+// What a seat's state machine takes from the outside world: the daemon
+// reads the idle time, arms the seat's timerfd, injects and writes the
+// state file; --simulate swaps in a virtual clock and a scripted trace
+// (sim.h) and seat_step runs unchanged. act returns 1 if the action is
+// already over, 0 if it plays on and ends the seat's own way.
+typedef struct {
+    long (*idle_time)(Seat *s);
+    void (*arm)(Seat *s, long delay_ms);
+    int  (*act)(Seat *s, long overdue_ms);
+    void (*state)(Seat *s, const char *emoji);
+} SeatDriver;
+
+// Start the action: it plays on the seat's playback timer (action_tick),
+// timed from overdue_ms in the past, and flags the seat acted when over
+static int seat_act(Seat *s, long overdue_ms) {
+    action_begin(s, overdue_ms);
+    return 0;
+}
+
+static const SeatDriver seat_driver = { seat_idle_time, seat_arm, seat_act, save_state };
+static const SeatDriver *g_driver = &seat_driver;
+
+// One pass of a seat's state machine: act if due, publish the state and
+// arm the seat's timer for its next transition. Not while the seat's
+// action plays; the pass after it ends wraps it up.
+static void seat_step(Seat *s) {
+    const SeatDriver *d = g_driver;
+    const Settings *cfg = settings_get();
+    long idle_ms = g_parked ? 0 : d->idle_time(s);
+    long next_ms;
+    int warning = 0;
+
+    if (g_parked) {
+        // === PARKED (logind: asleep, locked or another session) ===
+        s->trigger = 0;
+        d->state(s, "⏸");
+        next_ms = -1;       // timers are off; logind wakes us
+
+    } else if (s->acted) {
+        // === ACTION PLAYED (on the seat's playback timer) ===
+        s->acted = 0;
+        d->state(s, "🟢");
+        next_ms = 3000;     // Wait for system to register activity
+
+    } else if (s->trigger || (!s->paused && idle_ms > s->action_limit)) {
+        s->trigger = 0;
+
+        // === ACTION (WHITE) ===
+        d->state(s, "🟡");
+        status_page_update(g_pages[s->index], s->state, idle_ms, s->action_limit,
+                           s->paused, s->actions);
+        display_watch(s, "ACTION!", "🟡", idle_ms);
+
+        log_write(LOG_INFO, "%sACTION! Idle: %lds / Limit: %lds",
+                  s->tag, idle_ms / 1000, s->action_limit / 1000);
+
+        if (!d->act(s, idle_ms > s->action_limit ? idle_ms - s->action_limit : 0)) {
+            // Plays on; action_end flags the seat acted for the next pass
+            seat_watch(s, 0);
+            return;
+        }
+        seat_action_end(s);
+
+        d->state(s, "🟢");
+
+        // Wait for system to register activity
+        next_ms = 3000;
+        idle_ms = d->idle_time(s);
+
+    } else if (s->paused) {
+        // === PAUSED (control socket) ===
+        d->state(s, "⏸");
+        display_watch(s, "PAUSED", "⏸", idle_ms);
+        next_ms = 3600000;  // resume / trigger wake the loop
+
+    } else if (idle_ms > cfg->warning_limit_ms) {
+        // === WARNING (RED) ===
+        d->state(s, "🔴");
+        display_watch(s, "WARNING", "🔴", idle_ms);
+        next_ms = s->action_limit - idle_ms + 1;
+        warning = 1;
+
+    } else {
+        // === SAFE (GREEN) ===
+        d->state(s, "🟢");
+        display_watch(s, "SAFE", "🟢", idle_ms);
+        next_ms = cfg->warning_limit_ms - idle_ms + 1;
+    }
+
+    // Input only has to wake the loop when it can end a warning
+    seat_watch(s, warning);
+
+    status_page_update(g_pages[s->index], s->state, idle_ms, s->action_limit,
+                       s->paused || g_parked, s->actions);
+
+    if (next_ms >= 0)
+        d->arm(s, next_ms);
+}
+
+// ============================================================================
+// SIMULATION (--simulate TRACE: virtual clock, scripted activity)
+// ============================================================================
+
+// One seat, no fds: the trace stands in for input, the clock jumps from
+// one event to the next and every action only costs virtual time
+static struct {
+    SimTrace  trace;
+    SimClock  clock;
+    long long deadline;                 // the seat's timer, virtual ms
+    long long state_since;
+    long long state_ms[4];              // green, red, action, paused
+    unsigned long long actions[ACTION_COUNT], misses, steps;
+    long      max_late_ms;
+} g_sim;
+
+static const char *const sim_state_names[4] = { "green", "red", "action", "paused" };
+
+static int sim_state_slot(const char *emoji) {
+    for (int i = 0; i < 4; i++)
+        if (strcmp(state_name(emoji), sim_state_names[i]) == 0)
+            return i;
+    return -1;
+}
+
+static long sim_seat_idle(Seat *s) {
+    (void)s;
+    return sim_idle_ms(&g_sim.clock);
+}
+
+static void sim_seat_arm(Seat *s, long delay_ms) {
+    (void)s;
+    g_sim.deadline = g_sim.clock.now + (delay_ms < 1 ? 1 : delay_ms);
+}
+
+// Timeline: one JSON line per state change
+static void sim_seat_state(Seat *s, const char *emoji) {
+    if (s->state_written && strcmp(emoji, s->state) == 0)
+        return;
+
+    long long now = g_sim.clock.now;
+    int slot = sim_state_slot(s->state);
+    if (s->state_written && slot >= 0)
+        g_sim.state_ms[slot] += now - g_sim.state_since;
+    s->state = emoji;
+    s->state_written = 1;
+    g_sim.state_since = now;
+
+    char at[32];
+    sim_format(at, sizeof(at), now);
+    printf("{\"at\": \"%s\", \"t_ms\": %lld, \"state\": \"%s\", \"idle_ms\": %ld}\n",
+           at, now, state_name(emoji), sim_idle_ms(&g_sim.clock));
+}
+
+// Virtual duration of one action, drawn the way the real one plays
+static long sim_action_ms(int kind) {
+    if (kind == ACTION_KEY)
+        return settings_get()->micro_key_hold_ms;
+
+    long us = 0;
+    if (kind == ACTION_JIGGLE) {
+        PackedPoint points[2 * JIGGLE_STEPS];
+        int n = build_jiggle(points);
+        for (int i = 0; i < n; i++)
+            us += points[i].delay_us;
+        return us / 1000;
+    }
+
+    double tx = rng_range(&g_rng, -400, 400);
+    double ty = rng_range(&g_rng, -400, 400);
+    int count = 0;
+    if (WIND_CANDIDATES > 1) {
+        static WindCandidates cand;
+        int best = wind_candidates_generate(&cand, rng_next(&g_rng), tx, ty);
+        count = cand.lanes.count[best];
+        us = cand.lanes.duration_us[best];
+    } else {
+        WindState st;
+        PackedPoint p;
+        wind_init(&st, rng_next(&g_rng), tx, ty);
+        while (wind_next(&st, &p)) {
+            count++;
+            us += p.delay_us;
         }
-        execlp("notify-send", "notify-send", title, body, NULL);
-        _exit(0);
     }
-    // Don't wait - fire and forget
+    return (g_smooth_mode ? us : count * 5000l) / 1000;     // batch: 5 ms per move
+}
+
+// action_next's strategy chain; the trace's "ignore" lines decide which
+// actions the idle source notices, a miss costs the micro_verify_ms wait
+static int sim_seat_act(Seat *s, long overdue_ms) {
+    SimClock *c = &g_sim.clock;
+    long idle_ms = sim_idle_ms(c);
+    long long start = c->now;
+
+    int forced = action_parse(g_action_mode);
+    int first = forced >= 0 && forced < ACTION_COUNT ? forced : ACTION_KEY;
+    int *skip = g_action_skip[s->index];
+    int kind, tries = 0;
+
+    for (kind = first; kind < ACTION_COUNT; kind++) {
+        if (kind != forced && kind != ACTION_PATH && skip[kind] > 0) {
+            skip[kind]--;
+            continue;
+        }
+
+        // Input from the first event to the last
+        tries++;
+        int noticed = !(g_sim.trace.ignore & 1u << kind);
+        if (noticed)
+            sim_input(c);
+        sim_advance(c, c->now + sim_action_ms(kind));
+        if (noticed)
+            sim_input(c);
+        if (kind == ACTION_PATH)
+            break;          // last resort, not verified
+        if (noticed) {
+            skip[kind] = 0;
+            break;
+        }
+
+        sim_advance(c, c->now + settings_get()->micro_verify_ms);
+        g_sim.misses++;
+        skip[kind] = (int)settings_get()->micro_retry_actions;
+    }
+
+    g_sim.actions[kind]++;
+    if (overdue_ms > g_sim.max_late_ms)
+        g_sim.max_late_ms = overdue_ms;
+
+    char at[32];
+    sim_format(at, sizeof(at), start);
+    printf("{\"at\": \"%s\", \"t_ms\": %lld, \"action\": \"%s\", \"tries\": %d, "
+           "\"ms\": %lld, \"idle_ms\": %ld, \"limit_ms\": %ld, \"late_ms\": %ld}\n",
+           at, start, action_names[kind], tries, c->now - start, idle_ms,
+           s->action_limit, overdue_ms);
+    return 1;
+}
+
+static const SeatDriver sim_driver = { sim_seat_idle, sim_seat_arm, sim_seat_act, sim_seat_state };
+
+// Replay the trace through seat_step, print the timeline and a summary.
+// Exits 1 if an action ever ran more than SIM_MAX_LATE_MS past its threshold.
+static int simulate(const char *path) {
+    if (sim_trace_load(&g_sim.trace, path, action_names, ACTION_COUNT) < 0)
+        return 1;
+
+    Seat *s = seat_new(-1, "sim");
+    if (!s)
+        return 1;
+
+    g_driver = &sim_driver;
+    log_min_level = LOG_OFF;    // the timeline is the output
+    long long wall = now_ns();
+
+    SimClock *c = &g_sim.clock;
+    sim_start(c, &g_sim.trace, rng_next(&g_rng));
+    s->action_limit = next_action_limit();
+
+    for (;;) {
+        if (s->due) {
+            s->due = 0;
+            seat_step(s);
+            g_sim.steps++;
+        }
+
+        // Next event: the seat's deadline, or the user coming back while
+        // the seat watches its inputs (the daemon would not wake otherwise)
+        long long t = g_sim.deadline;
+        if (s->watching && sim_next_input(c) < t)
+            t = sim_next_input(c);
+        if (t >= sim_end(c))
+            break;
+
+        sim_advance(c, t);
+        s->due = 1;
+    }
+
+    sim_advance(c, sim_end(c));
+    sim_gap(c, c->now);
+    sim_seat_state(s, "⚫");
+
+    unsigned long long actions = 0;
+    for (int i = 0; i < ACTION_COUNT; i++)
+        actions += g_sim.actions[i];
+    int ok = g_sim.max_late_ms <= SIM_MAX_LATE_MS;
+
+    printf("{\"summary\": true, \"seed\": %llu, \"simulated_ms\": %lld, \"wall_ms\": %.1f, "
+           "\"steps\": %llu, \"actions\": %llu, \"key\": %llu, \"jiggle\": %llu, \"path\": %llu, "
+           "\"misses\": %llu, \"actions_per_hour\": %.1f, \"green_ms\": %lld, \"red_ms\": %lld, "
+           "\"action_ms\": %lld, \"max_idle_ms\": %lld, \"max_late_ms\": %ld, \"ok\": %s}\n",
+           (unsigned long long)g_seed, c->now, (now_ns() - wall) / 1e6,
+           g_sim.steps, actions, g_sim.actions[ACTION_KEY], g_sim.actions[ACTION_JIGGLE],
+           g_sim.actions[ACTION_PATH], g_sim.misses,
+           c->now ? actions * 3600000.0 / c->now : 0.0,
+           g_sim.state_ms[0], g_sim.state_ms[1], g_sim.state_ms[2],
+           c->max_idle, g_sim.max_late_ms, ok ? "true" : "false");
+
+    seat_close(s);
+    return !ok;
 }
 
 // ============================================================================
@@ -341,14 +1545,54 @@ void print_usage(const char *prog) {
     printf("Options:\n");
     printf("  --watch      Live dashboard mode (see status in real-time)\n");
     printf("  --smooth     Use smooth mode (individual moves with delays)\n");
+    char backends[64];
+    idle_detector_list(backends, sizeof(backends));
+    printf("  --idle NAME  Idle source: auto|%s (default: auto)\n", backends);
+    printf("  --seed N     Fixed PRNG seed (reproducible targets, paths, timings)\n");
+    printf("  --rt         SCHED_FIFO during smooth playback (needs CAP_SYS_NICE)\n");
+    printf("  --uinput     Inject via own /dev/uinput device (no ydotoold needed)\n");
+    printf("  --uinput-device PATH\n");
+    printf("               Use PATH instead of %s (pipe/file = fake sink)\n", UINPUT_PATH);
+    printf("  --fps HZ     Merge moves into one per display frame (default: %d, 0 = off)\n",
+           COALESCE_HZ);
+    printf("  --action MODE\n");
+    printf("               auto|key|jiggle|path (default: %s; auto = cheapest that resets idle)\n",
+           ACTION_MODE);
+    printf("  --seat NAME[:INPUT,...[:SINK]]\n");
+    printf("               Serve seat NAME (repeat for more seats): inputs from udev\n");
+    printf("               (ID_SEAT) or the listed nodes/FIFOs, own uinput device or SINK\n");
+    printf("  --record FILE\n");
+    printf("               Append your own mouse motion to FILE (--idle libinput)\n");
+    printf("  --replay FILE\n");
+    printf("               Play recorded motion from FILE instead of WindMouse\n");
+    printf("  --status-page\n");
+    printf("               Publish each seat's state in shared memory (%s, or\n", STATUS_PAGE_NAME);
+    printf("               %s per --seat)\n", SEAT_STATUS_PAGE);
+    printf("  --log-level LEVEL\n");
+    printf("               debug|info|warn|error (default: info; debug logs every point)\n");
+    printf("  --log-json   One JSON object per log line\n");
+    printf("  --config FILE\n");
+    printf("               Settings file (default: $XDG_CONFIG_HOME/%s), reloaded on save\n",
+           CONFIG_FILE_NAME);
+    printf("  --print-config\n");
+    printf("               Print the effective settings in config file format\n");
+    printf("  --simulate TRACE\n");
+    printf("               Run the scheduler on a virtual clock against activity TRACE;\n");
+    printf("               prints the timeline and a summary (JSON lines), then exits\n");
+    printf("  --peek [SEAT]\n");
+    printf("               Print the status pages, one line per seat (no syscalls on the\n");
+    printf("               daemon side)\n");
+    printf("  --ctl CMD    Send CMD to the running daemon and print the reply:\n");
+    printf("               ping|state|status|stats|pause|resume|trigger|stop [SEAT]\n");
     printf("  --help       Show this help\n");
     printf("\n");
     printf("Control:\n");
-    printf("  Kill with: pkill jigglemil  or  kill $(cat /tmp/jigglemil.pid)\n");
+    printf("  %s --ctl stop   (or: pkill jigglemil)\n", prog);
     printf("\n");
-    printf("Status:\n");
-    printf("  cat /tmp/jigglemil.state    # green/red/white/black\n");
-    printf("  tail -f /tmp/jigglemil.log  # live logs\n");
+    printf("Status (files in $XDG_RUNTIME_DIR, else " RUNTIME_DIR_FALLBACK "):\n", (unsigned)getuid());
+    printf("  cat %s    # green/red/white/black\n", STATE_FILE);
+    printf("  tail -f %s  # live logs\n", LOG_FILE);
+    printf("  kill -USR1 $(cat %s)  # stats to log + %s\n", PID_FILE, STATS_FILE);
 }
 
 // ============================================================================
@@ -356,51 +1600,303 @@ void print_usage(const char *prog) {
 // ============================================================================
 
 int main(int argc, char *argv[]) {
+    int print_config = 0;
+
     // Parse arguments
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "--smooth") == 0) {
             g_smooth_mode = 1;
         } else if (strcmp(argv[i], "--watch") == 0) {
             g_watch_mode = 1;
+        } else if (strcmp(argv[i], "--idle") == 0 && i + 1 < argc) {
+            g_idle_backend = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            g_seed = strtoull(argv[++i], NULL, 0);
+            g_seed_set = 1;
+        } else if (strcmp(argv[i], "--rt") == 0) {
+            g_realtime = 1;
+        } else if (strcmp(argv[i], "--uinput") == 0) {
+            g_use_uinput = 1;
+        } else if (strcmp(argv[i], "--uinput-device") == 0 && i + 1 < argc) {
+            g_use_uinput = 1;
+            g_uinput_path = argv[++i];
+        } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            g_coalesce_hz = atoi(argv[++i]);
+            if (g_coalesce_hz < 0) g_coalesce_hz = 0;
+        } else if (strcmp(argv[i], "--action") == 0 && i + 1 < argc) {
+            g_action_mode = argv[++i];
+            if (action_parse(g_action_mode) < 0) {
+                fprintf(stderr, "jigglemil: unknown action '%s'\n", g_action_mode);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--seat") == 0 && i + 1 < argc) {
+            if (g_seat_spec_count == SEAT_MAX) {
+                fprintf(stderr, "jigglemil: at most %d seats\n", SEAT_MAX);
+                return 1;
+            }
+            g_seat_specs[g_seat_spec_count++] = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            g_record_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            g_replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--status-page") == 0) {
+            g_status_page = 1;
+        } else if (strcmp(argv[i], "--log-level") == 0 && i + 1 < argc) {
+            int level = log_level_parse(argv[++i]);
+            if (level < 0) {
+                fprintf(stderr, "jigglemil: unknown log level '%s'\n", argv[i]);
+                return 1;
+            }
+            log_min_level = (LogLevel)level;
+        } else if (strcmp(argv[i], "--log-json") == 0) {
+            log_json = 1;
+        } else if (strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
+            snprintf(g_config_path, sizeof(g_config_path), "%s", argv[++i]);
+        } else if (strcmp(argv[i], "--print-config") == 0) {
+            print_config = 1;
+        } else if (strcmp(argv[i], "--simulate") == 0 && i + 1 < argc) {
+            g_sim_path = argv[++i];
+        } else if (strcmp(argv[i], "--peek") == 0) {
+            return status_page_client(i + 1 < argc && argv[i + 1][0] != '-' ? argv[i + 1] : NULL);
+        } else if (strcmp(argv[i], "--ctl") == 0 && i + 1 < argc) {
+            return control_client(argv[i + 1]);
         } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
             print_usage(argv[0]);
             return 0;
         }
     }
 
-    // Initialize idle detector
-    init_idle_detector();   // <-- NEW LINE
+    if (!g_seed_set) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        g_seed = ((uint64_t)ts.tv_sec << 32) ^ (uint64_t)ts.tv_nsec ^ (uint64_t)getpid();
+    }
+    rng_seed(&g_rng, g_seed);
+    stats_init();
+
+    // Settings: config.h defaults, overridden by the config file
+    char config_msg[1024] = "";
+    int overrides = 0;
+    if (!g_config_path[0])
+        settings_default_path(g_config_path, sizeof(g_config_path));
+    if (g_config_path[0] &&
+        (overrides = settings_load(g_config_path, config_msg, sizeof(config_msg))) < 0) {
+        fprintf(stderr, "jigglemil: %s\n", config_msg);
+        return 1;
+    }
+    if (print_config) {
+        settings_print(stdout);
+        return 0;
+    }
+
+    // Nothing below runs in a simulation: no devices, sockets or files
+    if (g_sim_path)
+        return simulate(g_sim_path);
+
+    // Every file the daemon shares lives in the runtime directory
+    if (!runtime_dir()) {
+        fprintf(stderr, "jigglemil: no runtime directory: $XDG_RUNTIME_DIR unset and "
+                RUNTIME_DIR_FALLBACK " unusable\n", (unsigned)getuid());
+        return 1;
+    }
+    runtime_path(g_pid_path, sizeof(g_pid_path), PID_FILE);
+    runtime_path(g_stats_path, sizeof(g_stats_path), STATS_FILE);
 
-    srand(time(NULL) ^ getpid());
     setup_signals();
+
+    EventLoop loop;
+    if (loop_init(&loop) < 0) {
+        perror("jigglemil: event loop");
+        return 1;
+    }
+
+    // One daemon per user: the control socket doubles as the instance lock
+    char ctl_sock[sizeof(ctl_path)];
+    control_socket_path(ctl_sock, sizeof(ctl_sock));
+    loop.ctl_fd = ctl_open(ctl_sock);
+    if (loop.ctl_fd < 0 && errno == EADDRINUSE) {
+        fprintf(stderr, "jigglemil: already running (%s)\n", ctl_sock);
+        return 1;
+    }
+    if (loop.ctl_fd >= 0)
+        loop_add(&loop, loop.ctl_fd);
+
+    if (g_seat_spec_count == 0) {
+        // Initialize idle detector (wakes the loop when activity ends a warning)
+        if (init_idle_detector(g_idle_backend, loop.wake_fd,
+                               settings_get()->warning_limit_ms) < 0) {
+            fprintf(stderr, "jigglemil: no usable idle detector (%s)\n", g_idle_backend);
+            ctl_close();
+            return 1;
+        }
+
+        loop.idle_fd = idle_detector_fd();
+        if (loop.idle_fd >= 0) {
+            loop_add(&loop, loop.idle_fd);
+        }
+
+        // One seat, ours: the backend's idle time, the daemon's injection
+        const char *name = getenv("XDG_SEAT");
+        Seat *seat = seat_new(loop.epfd, name && *name ? name : SEAT_DEFAULT);
+        if (!seat) {
+            perror("jigglemil: seat");
+            ctl_close();
+            return 1;
+        }
+        seat->backend = 1;
+        seat_file(seat, seat->state_path, sizeof(seat->state_path), STATE_FILE, SEAT_STATE_FILE);
+    } else {
+        // --seat: every seat brings its own inputs and injection device
+        for (int i = 0; i < g_seat_spec_count; i++) {
+            if (seat_open_spec(loop.epfd, g_seat_specs[i]) < 0) {
+                ctl_close();
+                return 1;
+            }
+        }
+
+        int discover = 0;
+        for (int i = 0; i < g_seat_count; i++)
+            discover |= g_seats[i]->discover;
+        if (discover && (loop.udev_fd = seat_discover(g_seats, g_seat_count)) < 0) {
+            fprintf(stderr, "jigglemil: --seat without inputs needs udev (or list them: NAME:INPUT,...)\n");
+            ctl_close();
+            return 1;
+        }
+        if (loop.udev_fd >= 0)
+            loop_add(&loop, loop.udev_fd);
+    }
+
+    // logind: park while asleep, locked or switched away
+    if (session_open() == 0) {
+        loop.session_fd = session_fd();
+        loop_add(&loop, loop.session_fd);
+        session_dispatch();
+    }
+
+    // Config file: re-read between steps whenever it is saved
+    if (g_config_path[0] && (loop.conf_fd = settings_watch(g_config_path)) >= 0)
+        loop_add(&loop, loop.conf_fd);
+
     save_pid();
 
-    // Set ydotool socket path
-    setenv("YDOTOOL_SOCKET", "/tmp/.ydotool_socket", 1);
+    // Set ydotool socket path (also used by the CLI fallback)
+    if (!g_use_uinput) {
+        setenv("YDOTOOL_SOCKET", YDOTOOL_SOCKET_PATH, 1);
+    }
 
-    // Clear/init log
-    FILE *fp = fopen(LOG_FILE, "w");
-    if (fp) fclose(fp);
+    // Clear/init log; lines are written by the logger thread from here on
+    char log_path[256];
+    runtime_path(log_path, sizeof(log_path), LOG_FILE);
+    logger_open(log_path, 1);
+    logger_start();
 
-    // Randomize first action threshold
-    long action_limit = MIN_ACTION_MS + (rand() % (MAX_ACTION_MS - MIN_ACTION_MS));
+    // Randomize first action thresholds
+    for (int i = 0; i < g_seat_count; i++)
+        g_seats[i]->action_limit = next_action_limit();
 
     // Startup
     log_msg("═══════════════════════════════════════");
     log_msg("JIGGLEMIL STARTED");
     log_msg(g_smooth_mode ? "    Mode: SMOOTH" : "    Mode: BATCH");
+    if (g_coalesce_hz > 0)
+        log_write(LOG_INFO, "    Coalescing: %d Hz", g_coalesce_hz);
+    else
+        log_write(LOG_INFO, "    Coalescing: off");
+    log_write(LOG_INFO, "    Action: %s", g_action_mode);
 
     char msg[128];
-    snprintf(msg, sizeof(msg), "    First trigger: %lds", action_limit / 1000);
+    if (g_seat_spec_count == 0) {
+        snprintf(msg, sizeof(msg), "    Idle: %s", idle_detector_name());
+        log_msg(msg);
+    }
+    snprintf(msg, sizeof(msg), "    Seed: %llu", (unsigned long long)g_seed);
     log_msg(msg);
+    if (g_config_path[0])
+        log_write(loop.conf_fd >= 0 ? LOG_INFO : LOG_WARN, "    Config: %s (%d override%s, %s)",
+                  g_config_path, overrides, overrides == 1 ? "" : "s",
+                  loop.conf_fd >= 0 ? "reloaded on save" : "cannot watch, not reloaded");
+    else
+        log_write(LOG_WARN, "    Config: no $XDG_CONFIG_HOME or $HOME, compiled-in defaults");
+    if (loop.session_fd >= 0)
+        log_write(LOG_INFO, "    Session: %s", session_name());
+    else
+        log_write(LOG_WARN, "    Session: logind unavailable, never parking");
+
+    // Open injection target once, keep it for the whole run
+    if (g_seat_spec_count > 0) {
+        for (int i = 0; i < g_seat_count; i++) {
+            Seat *seat = g_seats[i];
+            int inputs = seat_input_count(seat);
+            log_write(inputs ? LOG_INFO : LOG_WARN,
+                      "    Seat %s: %d input%s%s, injection %s, first trigger %lds",
+                      seat->name, inputs, inputs == 1 ? "" : "s", seat->discover ? " (udev)" : "",
+                      seat->inject_is_device ? "uinput" : "sink", seat->action_limit / 1000);
+        }
+    } else if (g_use_uinput) {
+        if (uinput_open(g_uinput_path) != 0) {
+            const char *err = strerror(errno);
+            snprintf(msg, sizeof(msg), "    Injection: cannot open %s: %s",
+                     g_uinput_path, err);
+            log_write(LOG_ERROR, "%s", msg);
+            fprintf(stderr, "jigglemil: cannot open %s: %s\n", g_uinput_path, err);
+            remove_pid();
+            ctl_close();
+            logger_stop();
+            return 1;
+        }
+        snprintf(msg, sizeof(msg), "    Injection: uinput (%s)", g_uinput_path);
+        log_msg(msg);
+    } else if (ydotool_connect(getenv("YDOTOOL_SOCKET")) == 0) {
+        log_msg("    Injection: ydotoold socket");
+    } else {
+        log_write(LOG_WARN, "    Injection: ydotool CLI (socket unavailable)");
+    }
+
+    if (g_record_path) {
+        if (strcmp(idle_detector_name(), "libinput") != 0)
+            log_write(LOG_WARN, "    Record: needs --idle libinput (now %s), not recording",
+                      idle_detector_name());
+        else if (corpus_record_open(g_record_path) != 0)
+            log_write(LOG_WARN, "    Record: cannot open %s: %s", g_record_path, strerror(errno));
+        else
+            log_write(LOG_INFO, "    Record: %s", g_record_path);
+    }
+
+    if (g_replay_path) {
+        // The recorder creates the file; replay maps it once it exists
+        if (corpus_open(&g_corpus, g_replay_path) == 0)
+            log_write(LOG_INFO, "    Replay: %s (%llu segments)", g_replay_path,
+                      (unsigned long long)corpus_segments(&g_corpus));
+        else
+            log_write(LOG_WARN, "    Replay: cannot map %s, using WindMouse", g_replay_path);
+    }
+
+    for (int i = 0; g_status_page && i < g_seat_count; i++) {
+        char page_path[256];
+        seat_file(g_seats[i], page_path, sizeof(page_path), STATUS_PAGE_NAME, SEAT_STATUS_PAGE);
+        g_pages[i] = status_page_open(page_path, g_seats[i]->name);
+        if (g_pages[i])
+            log_write(LOG_INFO, "    Status page: %s", page_path);
+        else
+            log_write(LOG_WARN, "    Status page: cannot create %s", page_path);
+    }
+
+    if (g_seat_spec_count == 0) {
+        snprintf(msg, sizeof(msg), "    First trigger: %lds", g_seats[0]->action_limit / 1000);
+        log_msg(msg);
+    }
     log_msg("═══════════════════════════════════════");
 
-    save_state("🟢");
+    for (int i = 0; i < g_seat_count; i++)
+        save_state(g_seats[i], "🟢");
     notify("Jigglemil", "Running");
 
-    // Show initial watch display
+    // Start the dashboard (renders on its own thread)
     if (g_watch_mode) {
-        display_watch("STARTING", "🟢", 0, action_limit);
+        for (int i = 0; i < g_seat_count; i++)
+            display_watch(g_seats[i], "STARTING", "🟢", 0);
+        if (watch_start(g_seat_count) != 0)
+            log_write(LOG_WARN, "Watch: cannot start render thread");
     }
 
     // ========================================================================
@@ -408,42 +1904,26 @@ int main(int argc, char *argv[]) {
     // ========================================================================
 
     while (g_running) {
-        long idle_ms = get_idle_time();
-
-        if (idle_ms > action_limit) {
-            // === ACTION (WHITE) ===
-            save_state("🟡");
-            display_watch("ACTION!", "🟡", idle_ms, action_limit);
-
-            snprintf(msg, sizeof(msg), "ACTION! Idle: %lds / Limit: %lds",
-                     idle_ms / 1000, action_limit / 1000);
-            log_msg(msg);
-
-            perform_wind_move();
-
-            // Randomize next threshold
-            action_limit = MIN_ACTION_MS + (rand() % (MAX_ACTION_MS - MIN_ACTION_MS));
-
-            snprintf(msg, sizeof(msg), "Done. Next trigger: %lds", action_limit / 1000);
-            log_msg(msg);
-
-            save_state("🟢");
-
-            // Wait for system to register activity
-            sleep(3);
+        session_update(&loop);
+
+        for (int i = 0; i < g_seat_count && g_running; i++) {
+            Seat *seat = g_seats[i];
+            if (seat->due && !seat->acting) {
+                seat->due = 0;
+                seat_step(seat);
+            }
+        }
 
-        } else if (idle_ms > WARNING_LIMIT_MS) {
-            // === WARNING (RED) ===
-            save_state("🔴");
-            display_watch("WARNING", "🔴", idle_ms, action_limit);
+        loop_wait(&loop);
 
-        } else {
-            // === SAFE (GREEN) ===
-            save_state("🟢");
-            display_watch("SAFE", "🟢", idle_ms, action_limit);
+        if (g_config_changed)
+            config_reload();
+        if (g_dump_stats) {
+            g_dump_stats = 0;
+            save_stats(1);
         }
-
-        sleep(CHECK_INTERVAL_SEC);
+        if (g_reap_children)
+            reap_children();
     }
 
     // ========================================================================
@@ -454,9 +1934,33 @@ int main(int argc, char *argv[]) {
     log_msg("JIGGLEMIL STOPPED (signal received)");
     log_msg("═══════════════════════════════════════");
 
-    save_state("⚫");
+    for (int i = 0; i < g_seat_count; i++)
+        action_cancel(g_seats[i]);
+    watch_stop();
+    corpus_record_close();
+    corpus_close(&g_corpus);
+    for (int i = 0; i < g_seat_count; i++)
+        save_state(g_seats[i], "⚫");
+    save_stats(1);
+    for (int i = 0; i < g_seat_count; i++)
+        status_page_close(g_pages[i]);
+    ctl_close();
+    session_close();
+    loop_close(&loop);
+    ydotool_disconnect();
+    uinput_close();
+    for (int i = 0; i < g_seat_count; i++) {
+        seat_close(g_seats[i]);
+        free(g_seats[i]);
+        free(g_play[i]);
+    }
+    seat_discover_close();
     remove_pid();
     notify("Jigglemil", "Stopped");
+    notify_close();
+    reap_children();
+    logger_stop();
+    settings_free();
 
     return 0;
 }
@@ -0,0 +1,329 @@
+// Asynchronous logger for Jigglemil
+// Callers format straight into a slot of a fixed ring buffer (bounded
+// MPMC queue, one sequence number per slot) and return: no locks, no
+// allocation, no file I/O. A background thread drains the ring every
+// LOG_FLUSH_MS, or sooner for errors / a filling ring, writes the batch
+// with a single write() and rotates the file past LOG_MAX_BYTES. With
+// nothing to write it sleeps without a timeout; the first line after
+// that wakes it.
+// If the ring is full the line is dropped and counted, never waited for.
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <signal.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+
+#define LOG_LINE_MAX    200
+#define LOG_BATCH_MAX   16384
+
+typedef enum {
+    LOG_DEBUG,
+    LOG_INFO,
+    LOG_WARN,
+    LOG_ERROR,
+    LOG_OFF         /* minimum level only: nothing is written */
+} LogLevel;
+
+static const char *const log_level_names[] = { "debug", "info", "warn", "error" };
+
+typedef struct {
+    _Atomic unsigned seq;       /* == pos: free, == pos + 1: ready to flush */
+    int      level;
+    int      len;
+    struct timespec ts;
+    char     text[LOG_LINE_MAX];
+} LogSlot;
+
+static LogSlot log_ring[LOG_RING_SLOTS];
+static _Atomic unsigned log_head = 0;   /* producers reserve here */
+static _Atomic unsigned log_tail = 0;   /* written by the consumer only */
+static atomic_ulong log_dropped = 0;
+
+static LogLevel log_min_level = LOG_INFO;
+static int log_json = 0;
+
+static int log_fd = -1;
+static int log_wake_fd = -1;
+static off_t log_size = 0;
+static char log_path[256];
+
+static pthread_t log_thread;
+static atomic_int log_thread_running = 0;
+static atomic_int log_sleeping = 0;     /* flusher waits for the next line */
+static pthread_mutex_t log_drain_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// ----------------------------
+// Rotation: jigglemil.log -> .1 -> .2 ... (LOG_KEEP files kept)
+// ----------------------------
+static void log_rotate(void) {
+    char from[300], to[300];
+
+    for (int i = LOG_KEEP - 1; i >= 1; i--) {
+        snprintf(from, sizeof(from), "%s.%d", log_path, i);
+        snprintf(to, sizeof(to), "%s.%d", log_path, i + 1);
+        rename(from, to);
+    }
+    snprintf(to, sizeof(to), "%s.1", log_path);
+    rename(log_path, to);
+
+    int fd = open(log_path, O_WRONLY | O_CREAT | O_APPEND | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd >= 0) {
+        close(log_fd);
+        log_fd = fd;
+    }
+    log_size = 0;
+}
+
+// JSON string body: escape quotes, backslashes and control characters
+static size_t log_json_escape(char *out, size_t size, const char *in, int len) {
+    size_t o = 0;
+    for (int i = 0; i < len && o + 7 < size; i++) {
+        unsigned char c = (unsigned char)in[i];
+        if (c == '"' || c == '\\') {
+            out[o++] = '\\';
+            out[o++] = (char)c;
+        } else if (c < 0x20) {
+            o += (size_t)snprintf(out + o, size - o, "\\u%04x", c);
+        } else {
+            out[o++] = (char)c;
+        }
+    }
+    return o;
+}
+
+static size_t log_format(char *out, size_t size, const LogSlot *s) {
+    struct tm tm;
+    localtime_r(&s->ts.tv_sec, &tm);
+
+    if (log_json) {
+        char ts[32], body[LOG_LINE_MAX * 6 + 1];
+        strftime(ts, sizeof(ts), "%Y-%m-%dT%H:%M:%S", &tm);
+        size_t blen = log_json_escape(body, sizeof(body), s->text, s->len);
+        int n = snprintf(out, size, "{\"ts\": \"%s.%03ld\", \"level\": \"%s\", \"msg\": \"%.*s\"}\n",
+                         ts, s->ts.tv_nsec / 1000000, log_level_names[s->level], (int)blen, body);
+        return n > 0 ? ((size_t)n < size ? (size_t)n : size - 1) : 0;
+    }
+
+    char ts[16];
+    strftime(ts, sizeof(ts), "%H:%M:%S", &tm);
+    int n = s->level == LOG_INFO
+        ? snprintf(out, size, "%s | %.*s\n", ts, s->len, s->text)
+        : snprintf(out, size, "%s | [%s] %.*s\n", ts, log_level_names[s->level], s->len, s->text);
+    return n > 0 ? ((size_t)n < size ? (size_t)n : size - 1) : 0;
+}
+
+static void log_write_batch(const char *buf, size_t len) {
+    if (log_fd < 0 || len == 0)
+        return;
+
+    while (len > 0) {
+        ssize_t w = write(log_fd, buf, len);
+        if (w < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        buf += w;
+        len -= (size_t)w;
+        log_size += w;
+    }
+    if (log_size >= LOG_MAX_BYTES)
+        log_rotate();
+}
+
+// ----------------------------
+// Consumer: move every ready slot to the file (one write() per batch)
+// ----------------------------
+static void log_drain(void) {
+    static char batch[LOG_BATCH_MAX];
+
+    pthread_mutex_lock(&log_drain_lock);
+
+    unsigned tail = atomic_load_explicit(&log_tail, memory_order_relaxed);
+    size_t len = 0;
+    for (;;) {
+        LogSlot *s = &log_ring[tail % LOG_RING_SLOTS];
+        if (atomic_load_explicit(&s->seq, memory_order_acquire) != tail + 1)
+            break;
+
+        if (LOG_BATCH_MAX - len < LOG_LINE_MAX * 6 + 96) {
+            log_write_batch(batch, len);
+            len = 0;
+        }
+        len += log_format(batch + len, LOG_BATCH_MAX - len, s);
+
+        /* hand the slot back for the lap after this one */
+        atomic_store_explicit(&s->seq, tail + LOG_RING_SLOTS, memory_order_release);
+        tail++;
+    }
+    atomic_store_explicit(&log_tail, tail, memory_order_relaxed);
+
+    unsigned long dropped = atomic_exchange(&log_dropped, 0);
+    if (dropped) {
+        LogSlot note = { .level = LOG_WARN };
+        clock_gettime(CLOCK_REALTIME, &note.ts);
+        note.len = snprintf(note.text, sizeof(note.text), "logger: %lu lines dropped (ring full)", dropped);
+        len += log_format(batch + len, LOG_BATCH_MAX - len, &note);
+    }
+
+    log_write_batch(batch, len);
+    pthread_mutex_unlock(&log_drain_lock);
+}
+
+static void* log_thread_main(void *arg) {
+    (void)arg;
+    struct pollfd pfd = { .fd = log_wake_fd, .events = POLLIN };
+
+    while (atomic_load(&log_thread_running)) {
+        /* empty ring: no periodic wakeups until a producer pokes us */
+        int timeout = LOG_FLUSH_MS;
+        atomic_store(&log_sleeping, 1);
+        atomic_thread_fence(memory_order_seq_cst);
+        unsigned tail = atomic_load_explicit(&log_tail, memory_order_relaxed);
+        if (atomic_load_explicit(&log_ring[tail % LOG_RING_SLOTS].seq, memory_order_acquire) != tail + 1)
+            timeout = -1;
+        else
+            atomic_store(&log_sleeping, 0);
+
+        if (poll(&pfd, 1, timeout) > 0) {
+            uint64_t val;
+            if (read(log_wake_fd, &val, sizeof(val)) < 0) { /* drained anyway */ }
+        }
+        atomic_store(&log_sleeping, 0);
+        log_drain();
+    }
+    return NULL;
+}
+
+// ----------------------------
+// Public: producer side (any thread, never blocks)
+// ----------------------------
+__attribute__((format(printf, 2, 3)))
+static void log_write(LogLevel level, const char *fmt, ...) {
+    if (level < log_min_level)
+        return;
+
+    unsigned pos = atomic_load_explicit(&log_head, memory_order_relaxed);
+    LogSlot *s;
+    for (;;) {
+        s = &log_ring[pos % LOG_RING_SLOTS];
+        unsigned seq = atomic_load_explicit(&s->seq, memory_order_acquire);
+        int diff = (int)(seq - pos);
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&log_head, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            atomic_fetch_add_explicit(&log_dropped, 1, memory_order_relaxed);
+            return;     /* full: the flusher is a lap behind */
+        } else {
+            pos = atomic_load_explicit(&log_head, memory_order_relaxed);
+        }
+    }
+
+    clock_gettime(CLOCK_REALTIME, &s->ts);
+    s->level = level;
+
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(s->text, sizeof(s->text), fmt, ap);
+    va_end(ap);
+    s->len = n < 0 ? 0 : n < (int)sizeof(s->text) ? n : (int)sizeof(s->text) - 1;
+
+    atomic_store_explicit(&s->seq, pos + 1, memory_order_release);
+    atomic_thread_fence(memory_order_seq_cst);  /* pairs with the flusher's sleep check */
+
+    if (!atomic_load_explicit(&log_thread_running, memory_order_relaxed)) {
+        log_drain();    /* no flusher (startup, tools): write through */
+    } else if (level >= LOG_ERROR ||
+               pos - atomic_load_explicit(&log_tail, memory_order_relaxed) >=
+                   LOG_RING_SLOTS * 3 / 4 ||
+               (atomic_load_explicit(&log_sleeping, memory_order_relaxed) &&
+                atomic_exchange(&log_sleeping, 0))) {
+        eventfd_write(log_wake_fd, 1);
+    }
+}
+
+// ----------------------------
+// Public: lifecycle
+// ----------------------------
+static int logger_open(const char *path, int truncate) {
+    for (unsigned i = 0; i < LOG_RING_SLOTS; i++)
+        atomic_store(&log_ring[i].seq, i);
+    atomic_store(&log_head, 0);
+    atomic_store(&log_tail, 0);
+
+    snprintf(log_path, sizeof(log_path), "%s", path);
+    log_fd = open(log_path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC |
+                  (truncate ? O_TRUNC : 0), 0644);
+    if (log_fd < 0)
+        return -1;
+
+    struct stat st;
+    log_size = fstat(log_fd, &st) == 0 ? st.st_size : 0;
+    return 0;
+}
+
+static int logger_start(void) {
+    log_wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (log_wake_fd < 0)
+        return -1;
+
+    /* signals belong to the main loop */
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &old);
+
+    atomic_store(&log_thread_running, 1);
+    int r = pthread_create(&log_thread, NULL, log_thread_main, NULL);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    if (r != 0) {
+        atomic_store(&log_thread_running, 0);
+        close(log_wake_fd);
+        log_wake_fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+// Flush everything and stop the thread (safe to call without a thread)
+static void logger_stop(void) {
+    if (atomic_exchange(&log_thread_running, 0)) {
+        eventfd_write(log_wake_fd, 1);
+        pthread_join(log_thread, NULL);
+        close(log_wake_fd);
+        log_wake_fd = -1;
+    }
+    log_drain();
+
+    if (log_fd >= 0) {
+        close(log_fd);
+        log_fd = -1;
+    }
+}
+
+static int log_level_parse(const char *name) {
+    for (int i = LOG_DEBUG; i <= LOG_ERROR; i++) {
+        if (strcmp(name, log_level_names[i]) == 0)
+            return i;
+    }
+    return -1;
+}
+
+#endif // LOGGER_H
@@ -0,0 +1,96 @@
+// Desktop notifications for Jigglemil
+// org.freedesktop.Notifications.Notify over one session-bus connection
+// (sd-bus), opened on the first notification and kept for the whole run.
+// Every call passes the id the server returned for the previous one as
+// replaces_id, so a state change updates the same popup instead of
+// stacking a new one. Calls are asynchronous: the reply (the id) is
+// collected when the next notification goes out. Nothing here waits (a
+// notification can go out mid-path); if that reply has not arrived yet,
+// the call opens a new popup instead.
+//
+// Compiled in with HAVE_DBUS_NOTIFY (install.sh sets it with libsystemd).
+// Without it, or without a session bus, notify_dbus() returns -1 and the
+// caller falls back to notify-send.
+
+#ifndef NOTIFY_H
+#define NOTIFY_H
+
+#include <stdint.h>
+
+#ifdef HAVE_DBUS_NOTIFY
+
+#include <systemd/sd-bus.h>
+
+#define NOTIFY_DEST         "org.freedesktop.Notifications"
+#define NOTIFY_PATH         "/org/freedesktop/Notifications"
+#define NOTIFY_IFACE        "org.freedesktop.Notifications"
+
+static sd_bus *notify_bus = NULL;
+static int notify_unavailable = 0;      /* no session bus: do not retry */
+static uint32_t notify_id = 0;          /* popup to replace, 0 = new */
+static int notify_pending = 0;          /* Notify replies outstanding */
+
+static int notify_on_reply(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
+    (void)userdata;
+    (void)ret_error;
+
+    notify_pending--;
+    uint32_t id;
+    if (!sd_bus_message_is_method_error(m, NULL) && sd_bus_message_read(m, "u", &id) >= 0)
+        notify_id = id;
+    return 0;
+}
+
+// ----------------------------
+// Public: send (0) or report that there is no bus (-1)
+// ----------------------------
+static int notify_dbus(const char *title, const char *body) {
+    if (!notify_bus && !notify_unavailable && sd_bus_open_user(&notify_bus) < 0) {
+        notify_bus = NULL;
+        notify_unavailable = 1;
+    }
+    if (!notify_bus)
+        return -1;
+
+    /* the previous reply carries the id to replace; it is normally long
+     * since queued. Only what has already arrived is read. */
+    while (sd_bus_process(notify_bus, NULL) > 0)
+        ;
+    uint32_t replaces = notify_pending ? 0 : notify_id;
+
+    int r = sd_bus_call_method_async(notify_bus, NULL, NOTIFY_DEST, NOTIFY_PATH, NOTIFY_IFACE,
+                                     "Notify", notify_on_reply, NULL, "susssasa{sv}i",
+                                     title, replaces, "", title, body,
+                                     0, 0, (int32_t)-1);
+    if (r < 0) {
+        /* connection lost: start over on the next call */
+        notify_bus = sd_bus_flush_close_unref(notify_bus);
+        notify_pending = 0;
+        notify_id = 0;
+        return -1;
+    }
+
+    notify_pending++;
+    sd_bus_flush(notify_bus);
+    return 0;
+}
+
+// Push out anything queued (the last notification before exit)
+static void notify_close(void) {
+    if (notify_bus)
+        notify_bus = sd_bus_flush_close_unref(notify_bus);
+}
+
+#else
+
+static int notify_dbus(const char *title, const char *body) {
+    (void)title;
+    (void)body;
+    return -1;
+}
+
+static void notify_close(void) { }
+
+#endif // HAVE_DBUS_NOTIFY
+
+#endif // NOTIFY_H
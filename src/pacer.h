@@ -0,0 +1,136 @@
+// Absolute-deadline pacing for Jigglemil path playback
+// Every point is scheduled against start + sum(previous delays) on
+// CLOCK_MONOTONIC, so injection time and sleep overshoot never accumulate.
+// The daemon waits for each deadline on a seat's playback timer (seat.h)
+// and reports it with pacer_late; pacer_wait sleeps instead.
+
+#ifndef PACER_H
+#define PACER_H
+
+#include <time.h>
+#include <errno.h>
+#include <sched.h>
+#include <sys/prctl.h>
+
+typedef struct {
+    struct timespec start;
+    struct timespec deadline;
+    long     *late_us;      /* optional per-point lateness log */
+    int       cap;
+    int       count;        /* points waited for */
+    long      max_late_us;
+    long long sum_late_us;
+} Pacer;
+
+// ----------------------------
+// timespec helpers
+// ----------------------------
+static inline long long ts_us(const struct timespec *ts) {
+    return (long long)ts->tv_sec * 1000000ll + ts->tv_nsec / 1000;
+}
+
+static inline void ts_add_us(struct timespec *ts, long us) {
+    ts->tv_sec  += us / 1000000;
+    ts->tv_nsec += (us % 1000000) * 1000;
+    if (ts->tv_nsec >= 1000000000l) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000l;
+    }
+}
+
+// ----------------------------
+// Public: start pacing now (first point is due immediately)
+// ----------------------------
+static void pacer_start(Pacer *p, long *late_us, int cap) {
+    clock_gettime(CLOCK_MONOTONIC, &p->start);
+    p->deadline    = p->start;
+    p->late_us     = late_us;
+    p->cap         = cap;
+    p->count       = 0;
+    p->max_late_us = 0;
+    p->sum_late_us = 0;
+}
+
+// ----------------------------
+// Public: the current deadline was reached (a timerfd armed at it fired,
+// or pacer_due said so); return how late we are (us)
+// ----------------------------
+static long pacer_late(Pacer *p) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    long late = (long)(ts_us(&now) - ts_us(&p->deadline));
+    if (late < 0) late = 0;
+
+    if (p->late_us && p->count < p->cap)
+        p->late_us[p->count] = late;
+    if (late > p->max_late_us)
+        p->max_late_us = late;
+    p->sum_late_us += late;
+    p->count++;
+
+    return late;
+}
+
+// ----------------------------
+// Public: sleep until the current deadline, return how late we woke (us)
+// ----------------------------
+static inline long pacer_wait(Pacer *p) {
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME,
+                           &p->deadline, NULL) == EINTR)
+        ;
+    return pacer_late(p);
+}
+
+// Is the current deadline already behind us?
+static inline int pacer_due(const Pacer *p) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ts_us(&now) >= ts_us(&p->deadline);
+}
+
+// Next point is due delay_us after the previous *deadline*, not after now
+static inline void pacer_advance(Pacer *p, long delay_us) {
+    ts_add_us(&p->deadline, delay_us);
+}
+
+static inline long pacer_elapsed_us(const Pacer *p) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long)(ts_us(&now) - ts_us(&p->start));
+}
+
+// ----------------------------
+// Optional: tighter wakeups while a path plays back
+// ----------------------------
+typedef struct {
+    int  old_policy;
+    struct sched_param old_param;
+    long old_slack_ns;
+    int  rt_active;
+} PacerBoost;
+
+static void pacer_boost(PacerBoost *b, int realtime, long slack_ns, int rt_prio) {
+    b->rt_active    = 0;
+    b->old_slack_ns = prctl(PR_GET_TIMERSLACK, 0, 0, 0, 0);
+    prctl(PR_SET_TIMERSLACK, slack_ns, 0, 0, 0);
+
+    if (!realtime)
+        return;
+
+    b->old_policy = sched_getscheduler(0);
+    sched_getparam(0, &b->old_param);
+
+    struct sched_param sp = { .sched_priority = rt_prio };
+    if (sched_setscheduler(0, SCHED_FIFO, &sp) == 0)
+        b->rt_active = 1;
+}
+
+static void pacer_unboost(PacerBoost *b) {
+    if (b->rt_active)
+        sched_setscheduler(0, b->old_policy, &b->old_param);
+    if (b->old_slack_ns > 0)
+        prctl(PR_SET_TIMERSLACK, b->old_slack_ns, 0, 0, 0);
+}
+
+#endif // PACER_H
@@ -0,0 +1,76 @@
+// Runtime directory for Jigglemil
+// Every file the daemon shares with other processes (control socket,
+// status pages, state / pid / stats files, the log) lives in one per-user
+// directory: $XDG_RUNTIME_DIR, else RUNTIME_DIR_FALLBACK in /tmp, created
+// 0700. Nothing is ever written under a predictable name in a shared
+// directory, so another user cannot plant a symlink there for the daemon
+// to follow. The fallback is only used if it is a real directory owned by
+// us and closed to everyone else.
+
+#ifndef RUNTIME_DIR_H
+#define RUNTIME_DIR_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+static char runtime_dir_path[256];
+
+// Ours, a directory (not a symlink to one) and private
+static int runtime_dir_private(const char *path) {
+    struct stat st;
+    if (lstat(path, &st) != 0)
+        return -1;
+    if (!S_ISDIR(st.st_mode) || st.st_uid != getuid() || (st.st_mode & 077)) {
+        errno = EPERM;
+        return -1;
+    }
+    return 0;
+}
+
+// ----------------------------
+// Public: the directory (NULL if the fallback is unusable, errno set)
+// ----------------------------
+static const char *runtime_dir(void) {
+    if (runtime_dir_path[0])
+        return runtime_dir_path;
+
+    const char *xdg = getenv("XDG_RUNTIME_DIR");
+    if (xdg && *xdg) {
+        snprintf(runtime_dir_path, sizeof(runtime_dir_path), "%s", xdg);
+        return runtime_dir_path;
+    }
+
+    char path[sizeof(runtime_dir_path)];
+    snprintf(path, sizeof(path), RUNTIME_DIR_FALLBACK, (unsigned)getuid());
+    if (mkdir(path, 0700) != 0 && errno != EEXIST)
+        return NULL;
+    if (runtime_dir_private(path) != 0)
+        return NULL;
+
+    snprintf(runtime_dir_path, sizeof(runtime_dir_path), "%s", path);
+    return runtime_dir_path;
+}
+
+// ----------------------------
+// Public: NAME in the runtime directory; an absolute NAME is taken as is.
+// -1 (buf empty) without a usable directory.
+// ----------------------------
+static int runtime_path(char *buf, size_t size, const char *name) {
+    if (name[0] == '/') {
+        snprintf(buf, size, "%s", name);
+        return 0;
+    }
+
+    const char *dir = runtime_dir();
+    if (!dir) {
+        if (size) buf[0] = '\0';
+        return -1;
+    }
+    snprintf(buf, size, "%s/%s", dir, name);
+    return 0;
+}
+
+#endif // RUNTIME_DIR_H
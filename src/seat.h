@@ -0,0 +1,479 @@
+// Seats for Jigglemil (--seat)
+// One daemon can serve several seats of a multi-seat machine, each with its
+// own idle tracker, action deadline, injection device and state file, all
+// on the main loop's epoll: no thread or process per seat. A seat's inputs
+// are the evdev nodes udev assigns to it (ID_SEAT; untagged nodes belong to
+// seat0), or paths given on the command line (a FIFO of input_events is a
+// fake device for testing).
+//
+// Nodes that stamp their events on our clock (EVIOCSCLOCKID) are only in
+// the wait set while the seat is in its warning phase. Otherwise their
+// events wait in the kernel and are drained when the seat next reads its
+// idle time; only the newest timestamp counts, and evdev keeps the newest
+// packets when its buffer overflows. A busy seat therefore costs one wakeup
+// per WARNING_LIMIT_MS and an idle one a wakeup per transition. Inputs
+// without timestamps (FIFOs) are drained as they arrive.
+//
+// A seat's action plays on its own playback timer, one wakeup per point, so
+// seats act side by side and the loop serves everything else in between.
+//
+// Each seat injects through its own uinput device, named after the seat so
+// a udev rule can assign it there, or into the sink given on the command
+// line. The default seat (no --seat) has neither: it follows the idle
+// backend and injects like the single-seat daemon always did.
+
+#ifndef SEAT_H
+#define SEAT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+#include <linux/input.h>
+
+#ifdef HAVE_EVDEV_IDLE
+#include <libudev.h>
+#endif
+
+#include "clock.h"
+#include "stats.h"
+#include "inject_uinput.h"
+
+#define SEAT_NAME_MAX       32
+#define SEAT_READ_BATCH     256             /* events per read() */
+
+/* epoll tags: seat index and slot (input index, or one of the timers) */
+#define SEAT_EPOLL_TAG      (1ull << 63)
+#define SEAT_SLOT_TIMER     0xffffu
+#define SEAT_SLOT_PLAY      0xfffeu
+#define SEAT_TAG_SEAT(tag)  ((int)(((tag) >> 16) & 0xffffu))
+#define SEAT_TAG_SLOT(tag)  ((unsigned)((tag) & 0xffffu))
+
+typedef struct {
+    int  fd;                /* -1 = free slot */
+    int  kernel_ts;         /* stamped on our clock: drained lazily */
+    char path[64];
+} SeatInput;
+
+typedef struct {
+    char name[SEAT_NAME_MAX];
+    char tag[SEAT_NAME_MAX + 3];    /* "[name] " in the log, empty for a lone seat */
+    int  index;                     /* in the seat table, part of every epoll tag */
+    int  epfd;
+
+    /* idle tracking: the idle backend, or the seat's own inputs */
+    int  backend;
+    int  discover;                  /* inputs come from udev (ID_SEAT) */
+    SeatInput inputs[SEAT_MAX_INPUTS];
+    int  watching;                  /* stamped inputs are in the wait set */
+    int  parked;                    /* no input is in the wait set */
+    unsigned long last_ms;          /* newest activity, now_ms() */
+
+    /* injection: own uinput device or fake sink, -1 = the daemon's */
+    int  inject_fd;
+    int  inject_is_device;
+
+    /* scheduling (driven by the main loop) */
+    int  timer_fd;                  /* one-shot, armed for the next transition */
+    int  due;                       /* re-evaluate on the next pass */
+    int  play_fd;                   /* playback: absolute, armed for the next input */
+    int  acting;                    /* an action is playing */
+    int  acted;                     /* ... and has ended; the next pass wraps it up */
+    long action_limit;
+    int  paused;
+    int  trigger;
+    unsigned long long actions;
+    const char *state;              /* emoji */
+    int  state_written;
+    char state_path[128];
+} Seat;
+
+// One-shot timerfd on the loop's epoll, tagged with the seat and slot
+static int seat_timer_open(Seat *s, int clock, unsigned slot) {
+    int fd = timerfd_create(clock, TFD_CLOEXEC | TFD_NONBLOCK);
+    if (fd < 0)
+        return -1;
+
+    struct epoll_event ev = {
+        .events = EPOLLIN,
+        .data.u64 = SEAT_EPOLL_TAG | (uint64_t)s->index << 16 | slot
+    };
+    if (epoll_ctl(s->epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// ----------------------------
+// Public: set up an empty seat on the loop's epoll (-1 without a timer);
+// with epfd -1 it stays off any loop
+// ----------------------------
+static int seat_init(Seat *s, const char *name, int index, int epfd) {
+    memset(s, 0, sizeof(*s));
+    snprintf(s->name, sizeof(s->name), "%s", name);
+    s->index     = index;
+    s->epfd      = epfd;
+    s->inject_fd = -1;
+    s->timer_fd  = -1;
+    s->play_fd   = -1;
+    s->last_ms   = now_ms();
+    s->state     = "⚫";
+    s->due       = 1;
+    for (int i = 0; i < SEAT_MAX_INPUTS; i++)
+        s->inputs[i].fd = -1;
+    if (epfd < 0)
+        return 0;           // no loop (--simulate): the caller keeps time
+
+    // Boot time, like now_ms(): a deadline that passed during suspend fires
+    // on resume. Playback runs on the pacer's clock (pacer.h).
+    s->timer_fd = seat_timer_open(s, CLOCK_BOOTTIME, SEAT_SLOT_TIMER);
+    s->play_fd  = seat_timer_open(s, CLOCK_MONOTONIC, SEAT_SLOT_PLAY);
+    if (s->timer_fd >= 0 && s->play_fd >= 0)
+        return 0;
+
+    if (s->timer_fd >= 0) close(s->timer_fd);
+    if (s->play_fd >= 0)  close(s->play_fd);
+    s->timer_fd = s->play_fd = -1;
+    return -1;
+}
+
+// ----------------------------
+// Wait set membership of one input
+// ----------------------------
+static uint32_t seat_input_events(const Seat *s, const SeatInput *in) {
+    if (s->parked)
+        return 0;
+    return !in->kernel_ts || s->watching ? EPOLLIN : 0;
+}
+
+static void seat_input_rearm(Seat *s, int idx) {
+    SeatInput *in = &s->inputs[idx];
+    struct epoll_event ev = {
+        .events = seat_input_events(s, in),
+        .data.u64 = SEAT_EPOLL_TAG | (uint64_t)s->index << 16 | (uint64_t)idx
+    };
+    epoll_ctl(s->epfd, EPOLL_CTL_MOD, in->fd, &ev);
+}
+
+// ----------------------------
+// Public: track an open input node (evdev, or a FIFO / file for testing)
+// ----------------------------
+static int seat_add_input(Seat *s, int fd, const char *path) {
+    for (int i = 0; i < SEAT_MAX_INPUTS; i++) {
+        SeatInput *in = &s->inputs[i];
+        if (in->fd >= 0)
+            continue;
+
+        int clk = CLOCK_BOOTTIME;
+        in->fd        = fd;
+        in->kernel_ts = (ioctl(fd, EVIOCSCLOCKID, &clk) == 0);
+        snprintf(in->path, sizeof(in->path), "%s", path);
+
+        struct epoll_event ev = {
+            .events = seat_input_events(s, in),
+            .data.u64 = SEAT_EPOLL_TAG | (uint64_t)s->index << 16 | (uint64_t)i
+        };
+        if (epoll_ctl(s->epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            in->fd = -1;
+            return -1;
+        }
+        return 0;
+    }
+    return -1;
+}
+
+static int seat_find_input(const Seat *s, const char *path) {
+    for (int i = 0; i < SEAT_MAX_INPUTS; i++) {
+        if (s->inputs[i].fd >= 0 && strcmp(s->inputs[i].path, path) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static void seat_remove_input(Seat *s, int idx) {
+    SeatInput *in = &s->inputs[idx];
+    if (in->fd < 0)
+        return;
+
+    epoll_ctl(s->epfd, EPOLL_CTL_DEL, in->fd, NULL);
+    close(in->fd);
+    in->fd = -1;
+}
+
+// Public: open and track a path; a FIFO is opened read-write so it never
+// reads end-of-file when the test feeding it closes its end
+static int seat_open_input(Seat *s, const char *path) {
+    if (seat_find_input(s, path) >= 0)
+        return 0;
+
+    struct stat st;
+    int flags = stat(path, &st) == 0 && S_ISFIFO(st.st_mode) ? O_RDWR : O_RDONLY;
+    int fd = open(path, flags | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+        return -1;
+
+    if (seat_add_input(s, fd, path) < 0) {
+        close(fd);
+        return -1;
+    }
+    return 0;
+}
+
+static int seat_input_count(const Seat *s) {
+    int n = 0;
+    for (int i = 0; i < SEAT_MAX_INPUTS; i++)
+        n += s->inputs[i].fd >= 0;
+    return n;
+}
+
+// ----------------------------
+// Public: drain one input, 1 if any input was seen
+// ----------------------------
+static int seat_drain(Seat *s, int idx) {
+    SeatInput *in = &s->inputs[idx];
+    struct input_event buf[SEAT_READ_BATCH];
+    const struct input_event *newest = NULL;
+
+    while (in->fd >= 0) {
+        ssize_t r = read(in->fd, buf, sizeof(buf));
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN)
+                seat_remove_input(s, idx);    /* ENODEV: unplugged */
+            break;
+        }
+        if (r < (ssize_t)sizeof(buf[0])) {
+            if (r == 0)
+                seat_remove_input(s, idx);    /* end of a regular file */
+            break;
+        }
+
+        newest = &buf[r / sizeof(buf[0]) - 1];
+        stats_count(STAT_IDLE_EVENTS, (unsigned long long)(r / sizeof(buf[0])));
+        if (r < (ssize_t)sizeof(buf))
+            break;                            /* short read: buffer is empty */
+    }
+
+    if (!newest)
+        return 0;
+
+    unsigned long ts = in->kernel_ts
+        ? (unsigned long)newest->input_event_sec * 1000ul +
+          (unsigned long)newest->input_event_usec / 1000ul
+        : now_ms();
+    if (ts > s->last_ms)
+        s->last_ms = ts;
+    return 1;
+}
+
+// ----------------------------
+// Public: idle time in ms (collects whatever the kernel queued meanwhile)
+// ----------------------------
+static long seat_idle_ms(Seat *s) {
+    for (int i = 0; i < SEAT_MAX_INPUTS; i++) {
+        if (s->inputs[i].fd >= 0)
+            seat_drain(s, i);
+    }
+
+    unsigned long now = now_ms();
+    /* kernel timestamps can be a hair ahead of now_ms() */
+    return now > s->last_ms ? (long)(now - s->last_ms) : 0;
+}
+
+// ----------------------------
+// Public: watch stamped inputs (warning phase) or leave them queued
+// ----------------------------
+static void seat_watch(Seat *s, int on) {
+    if (on == s->watching)
+        return;
+    s->watching = on;
+
+    for (int i = 0; i < SEAT_MAX_INPUTS; i++) {
+        if (s->inputs[i].fd >= 0 && s->inputs[i].kernel_ts)
+            seat_input_rearm(s, i);
+    }
+}
+
+// ----------------------------
+// Public: timer
+// ----------------------------
+static void seat_arm(Seat *s, long delay_ms) {
+    if (delay_ms < 1) delay_ms = 1;
+
+    struct itimerspec its = {0};
+    its.it_value.tv_sec  = delay_ms / 1000;
+    its.it_value.tv_nsec = (delay_ms % 1000) * 1000000l;
+    timerfd_settime(s->timer_fd, 0, &its, NULL);
+}
+
+// Playback timer: fire at deadline (CLOCK_MONOTONIC), or not at all
+static void seat_play_at(Seat *s, const struct timespec *deadline) {
+    struct itimerspec its = { .it_value = *deadline };
+    if (its.it_value.tv_sec == 0 && its.it_value.tv_nsec == 0)
+        its.it_value.tv_nsec = 1;       /* zero would disarm it */
+    timerfd_settime(s->play_fd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+static void seat_play_stop(Seat *s) {
+    static const struct itimerspec off = {0};
+    timerfd_settime(s->play_fd, 0, &off, NULL);
+}
+
+// Parked: timer off and every input out of the wait set (nodes stay open).
+// A playing action keeps its playback timer and finishes first.
+static void seat_park(Seat *s, int parked) {
+    static const struct itimerspec off = {0};
+    timerfd_settime(s->timer_fd, 0, &off, NULL);
+
+    s->parked = parked;
+    s->watching = 0;
+    for (int i = 0; i < SEAT_MAX_INPUTS; i++) {
+        if (s->inputs[i].fd >= 0)
+            seat_input_rearm(s, i);
+    }
+}
+
+// ----------------------------
+// Public: own injection device (uinput, or a fake sink path)
+// ----------------------------
+static int seat_open_sink(Seat *s, const char *path) {
+    char name[80];
+    snprintf(name, sizeof(name), "%s %s", UINPUT_DEVICE_NAME, s->name);
+
+    s->inject_fd = uinput_create(path, name, &s->inject_is_device);
+    return s->inject_fd >= 0 ? 0 : -1;
+}
+
+static void seat_close(Seat *s) {
+    for (int i = 0; i < SEAT_MAX_INPUTS; i++)
+        seat_remove_input(s, i);
+    if (s->inject_fd >= 0)
+        uinput_destroy(s->inject_fd, s->inject_is_device);
+    if (s->timer_fd >= 0)
+        close(s->timer_fd);
+    if (s->play_fd >= 0)
+        close(s->play_fd);
+    s->inject_fd = -1;
+    s->timer_fd  = -1;
+    s->play_fd   = -1;
+}
+
+// ============================================================================
+// Input discovery (udev: ID_SEAT of each evdev node, with hotplug)
+// ============================================================================
+
+#ifdef HAVE_EVDEV_IDLE
+
+static struct udev *seat_udev = NULL;
+static struct udev_monitor *seat_monitor = NULL;
+
+static Seat *seat_for_node(Seat *const *seats, int count, struct udev_device *d) {
+    const char *node = udev_device_get_devnode(d);
+    if (!node || strncmp(node, "/dev/input/event", 16) != 0)
+        return NULL;
+
+    const char *id = udev_device_get_property_value(d, "ID_SEAT");
+    if (!id || !*id)
+        id = SEAT_DEFAULT;
+
+    for (int i = 0; i < count; i++) {
+        if (seats[i]->discover && strcmp(seats[i]->name, id) == 0)
+            return seats[i];
+    }
+    return NULL;
+}
+
+// ----------------------------
+// Public: open every node of the discovering seats, then follow hotplug.
+// Returns the monitor fd for the loop, -1 without udev.
+// ----------------------------
+static int seat_discover(Seat *const *seats, int count) {
+    seat_udev = udev_new();
+    if (!seat_udev)
+        return -1;
+
+    seat_monitor = udev_monitor_new_from_netlink(seat_udev, "udev");
+    if (seat_monitor) {
+        udev_monitor_filter_add_match_subsystem_devtype(seat_monitor, "input", NULL);
+        udev_monitor_enable_receiving(seat_monitor);
+    }
+
+    struct udev_enumerate *en = udev_enumerate_new(seat_udev);
+    if (en) {
+        udev_enumerate_add_match_subsystem(en, "input");
+        udev_enumerate_scan_devices(en);
+
+        struct udev_list_entry *e;
+        udev_list_entry_foreach(e, udev_enumerate_get_list_entry(en)) {
+            struct udev_device *d =
+                udev_device_new_from_syspath(seat_udev, udev_list_entry_get_name(e));
+            if (!d)
+                continue;
+            Seat *s = seat_for_node(seats, count, d);
+            if (s)
+                seat_open_input(s, udev_device_get_devnode(d));
+            udev_device_unref(d);
+        }
+        udev_enumerate_unref(en);
+    }
+
+    return seat_monitor ? udev_monitor_get_fd(seat_monitor) : -1;
+}
+
+// Public: the monitor fd is readable
+static void seat_hotplug(Seat *const *seats, int count) {
+    struct udev_device *d;
+    while ((d = udev_monitor_receive_device(seat_monitor)) != NULL) {
+        const char *node   = udev_device_get_devnode(d);
+        const char *action = udev_device_get_action(d);
+
+        if (node && action && strcmp(action, "add") == 0) {
+            Seat *s = seat_for_node(seats, count, d);
+            if (s)
+                seat_open_input(s, node);
+        } else if (node && action && strcmp(action, "remove") == 0) {
+            for (int i = 0; i < count; i++) {
+                int idx = seat_find_input(seats[i], node);
+                if (idx >= 0)
+                    seat_remove_input(seats[i], idx);
+            }
+        }
+        udev_device_unref(d);
+    }
+}
+
+static void seat_discover_close(void) {
+    if (seat_monitor) udev_monitor_unref(seat_monitor);
+    if (seat_udev)    udev_unref(seat_udev);
+    seat_monitor = NULL;
+    seat_udev    = NULL;
+}
+
+#else
+
+static int seat_discover(Seat *const *seats, int count) {
+    (void)seats;
+    (void)count;
+    return -1;
+}
+
+static void seat_hotplug(Seat *const *seats, int count) {
+    (void)seats;
+    (void)count;
+}
+
+static void seat_discover_close(void) { }
+
+#endif // HAVE_EVDEV_IDLE
+
+#endif // SEAT_H
@@ -0,0 +1,236 @@
+// logind session tracking for Jigglemil
+// One persistent system-bus connection (sd-bus), dispatched from the main
+// loop's epoll like the idle backends. The daemon parks while the machine
+// prepares for sleep, while its session is locked and while the session
+// is not the active one on its seat (user switch, VT switch). Nothing is
+// polled: PrepareForSleep, Lock / Unlock and the session's
+// PropertiesChanged (Active, LockedHint) drive the state.
+//
+// sd-bus honours DBUS_SYSTEM_BUS_ADDRESS, so a stub logind on a private
+// bus can stand in for the real one. Compiled in with HAVE_LOGIND
+// (install.sh sets it with libsystemd); without it the session is always
+// active.
+
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef HAVE_LOGIND
+
+#include <systemd/sd-bus.h>
+
+#define LOGIND_DEST         "org.freedesktop.login1"
+#define LOGIND_PATH         "/org/freedesktop/login1"
+#define LOGIND_MANAGER      "org.freedesktop.login1.Manager"
+#define LOGIND_SESSION      "org.freedesktop.login1.Session"
+#define LOGIND_USER         "org.freedesktop.login1.User"
+#define DBUS_PROPERTIES     "org.freedesktop.DBus.Properties"
+
+static sd_bus *session_bus = NULL;
+static sd_bus_slot *session_slots[4];
+static char session_path[256];
+
+static int session_sleeping = 0;    /* between PrepareForSleep(true) and (false) */
+static int session_locked = 0;
+static int session_active = 1;
+static int session_reread = 0;      /* properties were invalidated */
+
+// ----------------------------
+// Which session are we? $XDG_SESSION_ID, else the one our PID is in, else
+// the user's display session (daemon started from a user service)
+// ----------------------------
+static int session_find_path(void) {
+    sd_bus_error err = SD_BUS_ERROR_NULL;
+    sd_bus_message *reply = NULL;
+    const char *path = NULL;
+
+    const char *id = getenv("XDG_SESSION_ID");
+    int r = id && *id
+        ? sd_bus_call_method(session_bus, LOGIND_DEST, LOGIND_PATH, LOGIND_MANAGER,
+                             "GetSession", &err, &reply, "s", id)
+        : sd_bus_call_method(session_bus, LOGIND_DEST, LOGIND_PATH, LOGIND_MANAGER,
+                             "GetSessionByPID", &err, &reply, "u", (uint32_t)getpid());
+    if (r >= 0 && sd_bus_message_read(reply, "o", &path) >= 0)
+        snprintf(session_path, sizeof(session_path), "%s", path);
+
+    sd_bus_message_unref(reply);
+    reply = NULL;
+    sd_bus_error_free(&err);
+    if (path)
+        return 0;
+
+    const char *display = NULL;
+    r = sd_bus_get_property(session_bus, LOGIND_DEST, LOGIND_PATH "/user/self", LOGIND_USER,
+                            "Display", &err, &reply, "(so)");
+    if (r >= 0 && sd_bus_message_read(reply, "(so)", &id, &display) >= 0 &&
+        display && strcmp(display, "/") != 0)
+        snprintf(session_path, sizeof(session_path), "%s", display);
+    else
+        display = NULL;
+
+    sd_bus_message_unref(reply);
+    sd_bus_error_free(&err);
+    return display ? 0 : -1;
+}
+
+static void session_read_properties(void) {
+    int v;
+    if (sd_bus_get_property_trivial(session_bus, LOGIND_DEST, session_path, LOGIND_SESSION,
+                                    "Active", NULL, 'b', &v) >= 0)
+        session_active = v;
+    if (sd_bus_get_property_trivial(session_bus, LOGIND_DEST, session_path, LOGIND_SESSION,
+                                    "LockedHint", NULL, 'b', &v) >= 0)
+        session_locked = v;
+    if (sd_bus_get_property_trivial(session_bus, LOGIND_DEST, LOGIND_PATH, LOGIND_MANAGER,
+                                    "PreparingForSleep", NULL, 'b', &v) >= 0)
+        session_sleeping = v;
+}
+
+// ----------------------------
+// Signal handlers (no bus calls in here, see session_dispatch)
+// ----------------------------
+static int session_on_sleep(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
+    (void)userdata;
+    (void)ret_error;
+
+    int start;
+    if (sd_bus_message_read(m, "b", &start) >= 0)
+        session_sleeping = start;
+    return 0;
+}
+
+static int session_on_lock(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
+    (void)ret_error;
+    (void)m;
+    session_locked = userdata != NULL;
+    return 0;
+}
+
+static int session_on_properties(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
+    (void)userdata;
+    (void)ret_error;
+
+    const char *iface;
+    if (sd_bus_message_read(m, "s", &iface) < 0 || strcmp(iface, LOGIND_SESSION) != 0)
+        return 0;
+
+    if (sd_bus_message_enter_container(m, 'a', "{sv}") < 0)
+        return 0;
+    while (sd_bus_message_enter_container(m, 'e', "sv") > 0) {
+        const char *name;
+        int v;
+        if (sd_bus_message_read(m, "s", &name) < 0)
+            return 0;
+
+        int *field = strcmp(name, "Active") == 0     ? &session_active
+                   : strcmp(name, "LockedHint") == 0 ? &session_locked : NULL;
+        if (field && sd_bus_message_read(m, "v", "b", &v) >= 0)
+            *field = v;
+        else if (!field)
+            sd_bus_message_skip(m, "v");
+
+        sd_bus_message_exit_container(m);
+    }
+    sd_bus_message_exit_container(m);
+
+    /* invalidated without a value: ask again from dispatch */
+    if (sd_bus_message_enter_container(m, 'a', "s") >= 0) {
+        const char *name;
+        while (sd_bus_message_read(m, "s", &name) > 0)
+            if (strcmp(name, "Active") == 0 || strcmp(name, "LockedHint") == 0)
+                session_reread = 1;
+        sd_bus_message_exit_container(m);
+    }
+    return 0;
+}
+
+// ----------------------------
+// Public: connect and subscribe (-1 without logind or a session)
+// ----------------------------
+static int session_open(void) {
+    if (sd_bus_open_system(&session_bus) < 0) {
+        session_bus = NULL;
+        return -1;
+    }
+
+    if (session_find_path() < 0) {
+        session_bus = sd_bus_flush_close_unref(session_bus);
+        return -1;
+    }
+
+    int r = 0;
+    r |= sd_bus_match_signal(session_bus, &session_slots[0], LOGIND_DEST, LOGIND_PATH,
+                             LOGIND_MANAGER, "PrepareForSleep", session_on_sleep, NULL);
+    r |= sd_bus_match_signal(session_bus, &session_slots[1], LOGIND_DEST, session_path,
+                             LOGIND_SESSION, "Lock", session_on_lock, (void *)1);
+    r |= sd_bus_match_signal(session_bus, &session_slots[2], LOGIND_DEST, session_path,
+                             LOGIND_SESSION, "Unlock", session_on_lock, NULL);
+    r |= sd_bus_match_signal(session_bus, &session_slots[3], LOGIND_DEST, session_path,
+                             DBUS_PROPERTIES, "PropertiesChanged", session_on_properties, NULL);
+    if (r < 0)
+        fprintf(stderr, "session: cannot subscribe to logind signals\n");
+
+    session_read_properties();
+    return 0;
+}
+
+static void session_close(void) {
+    for (size_t i = 0; i < sizeof(session_slots) / sizeof(session_slots[0]); i++)
+        session_slots[i] = sd_bus_slot_unref(session_slots[i]);
+    if (session_bus)
+        session_bus = sd_bus_flush_close_unref(session_bus);
+}
+
+static int session_fd(void) {
+    return session_bus ? sd_bus_get_fd(session_bus) : -1;
+}
+
+static const char *session_name(void) {
+    return session_bus ? session_path : "none";
+}
+
+// ----------------------------
+// Public: drain queued bus traffic (the calls in session_open may have
+// left signals in the read queue, so call this before waiting)
+// ----------------------------
+static void session_dispatch(void) {
+    if (!session_bus)
+        return;
+
+    while (sd_bus_process(session_bus, NULL) > 0)
+        ;
+
+    if (session_reread) {
+        session_reread = 0;
+        session_read_properties();
+        while (sd_bus_process(session_bus, NULL) > 0)
+            ;
+    }
+}
+
+// ----------------------------
+// Public: why the daemon should park right now, NULL if it should run
+// ----------------------------
+static const char *session_parked(void) {
+    if (session_sleeping) return "sleep";
+    if (session_locked)   return "locked";
+    if (!session_active)  return "inactive";
+    return NULL;
+}
+
+#else
+
+static int session_open(void) { return -1; }
+static void session_close(void) { }
+static int session_fd(void) { return -1; }
+static const char *session_name(void) { return "none"; }
+static void session_dispatch(void) { }
+static const char *session_parked(void) { return NULL; }
+
+#endif // HAVE_LOGIND
+
+#endif // SESSION_H
@@ -0,0 +1,342 @@
+// Runtime settings for Jigglemil
+// The timers, WindMouse ranges and action timings of config.h, read from
+// a key = value file ($XDG_CONFIG_HOME/jigglemil/jigglemil.conf, --config)
+// into one compact struct. The #defines stay the defaults: a key missing
+// from the file, or no file at all, means the compiled-in value.
+//
+// Readers take a snapshot pointer once (per path, per step) and read plain
+// fields from it: no lock, no parsing, no atomics per point. A reload
+// parses into a fresh struct and swaps the pointer only if the whole file
+// is valid, so readers see the old settings or the new ones, never a mix.
+// Replaced snapshots are kept until exit (a late reader on another thread
+// may still hold one; a reload is a human editing a file, so few pile up).
+//
+// The file's directory is watched with inotify (editors save by rename),
+// nothing polls.
+
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+
+typedef struct Settings {
+    /* timers */
+    long   warning_limit_ms;
+    long   min_action_ms;
+    long   max_action_ms;
+
+    /* WindMouse ranges, drawn per path */
+    double mouse_speed_min, mouse_speed_max;
+    double gravity_min, gravity_max;
+    double wind_min, wind_max;
+    double target_radius_min, target_radius_max;
+    double max_step_min, max_step_max;
+    long   min_delay_us, max_delay_us;
+    long   wind_target_points;          /* candidate pick / replay length */
+    long   wind_target_duration_ms;
+
+    /* micro actions */
+    long   micro_key_hold_ms;
+    long   jiggle_radius_px;
+    long   micro_verify_ms;
+    long   micro_idle_slack_ms;
+    long   micro_retry_actions;
+
+    const struct Settings *retired;     /* snapshot this one replaced */
+} Settings;
+
+static const Settings settings_defaults = {
+    .warning_limit_ms        = WARNING_LIMIT_MS,
+    .min_action_ms           = MIN_ACTION_MS,
+    .max_action_ms           = MAX_ACTION_MS,
+    .mouse_speed_min         = MOUSE_SPEED_MIN,
+    .mouse_speed_max         = MOUSE_SPEED_MAX,
+    .gravity_min             = GRAVITY_MIN,
+    .gravity_max             = GRAVITY_MAX,
+    .wind_min                = WIND_MIN,
+    .wind_max                = WIND_MAX,
+    .target_radius_min       = TARGET_RADIUS_MIN,
+    .target_radius_max       = TARGET_RADIUS_MAX,
+    .max_step_min            = MAX_STEP_MIN,
+    .max_step_max            = MAX_STEP_MAX,
+    .min_delay_us            = MIN_DELAY_US,
+    .max_delay_us            = MAX_DELAY_US,
+    .wind_target_points      = WIND_TARGET_POINTS,
+    .wind_target_duration_ms = WIND_TARGET_DURATION_MS,
+    .micro_key_hold_ms       = MICRO_KEY_HOLD_MS,
+    .jiggle_radius_px        = JIGGLE_RADIUS_PX,
+    .micro_verify_ms         = MICRO_VERIFY_MS,
+    .micro_idle_slack_ms     = MICRO_IDLE_SLACK_MS,
+    .micro_retry_actions     = MICRO_RETRY_ACTIONS,
+};
+
+static _Atomic(const Settings *) settings_current = &settings_defaults;
+
+// ----------------------------
+// Public: the current snapshot (valid until exit)
+// ----------------------------
+static inline const Settings *settings_get(void) {
+    return atomic_load_explicit(&settings_current, memory_order_acquire);
+}
+
+// ----------------------------
+// Keys: the config.h name in lower case, with the accepted range
+// ----------------------------
+typedef struct {
+    const char *name;
+    size_t offset;
+    int    is_long;
+    double min, max;
+} SettingsKey;
+
+#define SETTINGS_LONG(f, lo, hi)    { #f, offsetof(Settings, f), 1, lo, hi }
+#define SETTINGS_DOUBLE(f, lo, hi)  { #f, offsetof(Settings, f), 0, lo, hi }
+
+static const SettingsKey settings_keys[] = {
+    SETTINGS_LONG(warning_limit_ms, 1000, 86400000),
+    SETTINGS_LONG(min_action_ms, 1000, 86400000),
+    SETTINGS_LONG(max_action_ms, 1000, 86400000),
+    SETTINGS_DOUBLE(mouse_speed_min, 0.1, 1000),
+    SETTINGS_DOUBLE(mouse_speed_max, 0.1, 1000),
+    SETTINGS_DOUBLE(gravity_min, 0, 100),
+    SETTINGS_DOUBLE(gravity_max, 0, 100),
+    SETTINGS_DOUBLE(wind_min, 0, 1000),
+    SETTINGS_DOUBLE(wind_max, 0, 1000),
+    SETTINGS_DOUBLE(target_radius_min, 0.5, 100),
+    SETTINGS_DOUBLE(target_radius_max, 0.5, 100),
+    SETTINGS_DOUBLE(max_step_min, 0.5, 63),         /* a step must fit PackedPoint */
+    SETTINGS_DOUBLE(max_step_max, 0.5, 63),
+    SETTINGS_LONG(min_delay_us, 100, 65535),        /* and so must its delay */
+    SETTINGS_LONG(max_delay_us, 100, 65535),
+    SETTINGS_LONG(wind_target_points, 1, MAX_PATH_POINTS),
+    SETTINGS_LONG(wind_target_duration_ms, 1, 60000),
+    SETTINGS_LONG(micro_key_hold_ms, 1, 1000),
+    SETTINGS_LONG(jiggle_radius_px, 1, 100),
+    SETTINGS_LONG(micro_verify_ms, 10, 10000),
+    SETTINGS_LONG(micro_idle_slack_ms, 0, 10000),
+    SETTINGS_LONG(micro_retry_actions, 0, 1000),
+};
+
+#define SETTINGS_KEY_COUNT (sizeof(settings_keys) / sizeof(settings_keys[0]))
+
+static double settings_value(const Settings *s, const SettingsKey *k) {
+    const char *p = (const char *)s + k->offset;
+    return k->is_long ? (double)*(const long *)p : *(const double *)p;
+}
+
+// Ranges that only make sense together
+static const char *settings_check(const Settings *s) {
+    if (s->min_action_ms >= s->max_action_ms)     return "min_action_ms must be below max_action_ms";
+    if (s->warning_limit_ms >= s->min_action_ms)  return "warning_limit_ms must be below min_action_ms";
+    if (s->mouse_speed_min > s->mouse_speed_max)  return "mouse_speed_min > mouse_speed_max";
+    if (s->gravity_min > s->gravity_max)          return "gravity_min > gravity_max";
+    if (s->wind_min > s->wind_max)                return "wind_min > wind_max";
+    if (s->target_radius_min > s->target_radius_max) return "target_radius_min > target_radius_max";
+    if (s->max_step_min > s->max_step_max)        return "max_step_min > max_step_max";
+    if (s->min_delay_us > s->max_delay_us)        return "min_delay_us > max_delay_us";
+    return NULL;
+}
+
+// ----------------------------
+// Public: parse path over the defaults. 0 ok (a missing file is ok),
+// -1 with the reason in err.
+// ----------------------------
+static int settings_parse(const char *path, Settings *out, char *err, size_t err_size) {
+    *out = settings_defaults;
+
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        if (errno == ENOENT)
+            return 0;
+        snprintf(err, err_size, "%s: %s", path, strerror(errno));
+        return -1;
+    }
+
+    char line[256];
+    int lineno = 0, bad = 0;
+    while (!bad && fgets(line, sizeof(line), fp)) {
+        lineno++;
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        char *eq = strchr(line, '=');
+        char *name = strtok(line, " \t\r\n=");
+        if (!name)
+            continue;
+        char *arg = eq ? strtok(eq + 1, " \t\r\n") : NULL;
+        if (arg && strtok(NULL, " \t\r\n"))
+            arg = NULL;
+
+        size_t i = 0;
+        while (i < SETTINGS_KEY_COUNT && strcmp(name, settings_keys[i].name) != 0)
+            i++;
+        if (i == SETTINGS_KEY_COUNT || !arg) {
+            snprintf(err, err_size, "%s:%d: %s '%s'", path, lineno,
+                     arg ? "unknown key" : "expected key = value for", name);
+            bad = 1;
+            break;
+        }
+
+        const SettingsKey *k = &settings_keys[i];
+        char *end;
+        double v = strtod(arg, &end);
+        if (*end || v < k->min || v > k->max || (k->is_long && v != (double)(long)v)) {
+            snprintf(err, err_size, "%s:%d: %s = %s (want %s%.10g..%.10g)", path, lineno, name, arg,
+                     k->is_long ? "an integer in " : "", k->min, k->max);
+            bad = 1;
+            break;
+        }
+
+        char *p = (char *)out + k->offset;
+        if (k->is_long)
+            *(long *)p = (long)v;
+        else
+            *(double *)p = v;
+    }
+    fclose(fp);
+    if (bad)
+        return -1;
+
+    const char *why = settings_check(out);
+    if (why) {
+        snprintf(err, err_size, "%s: %s", path, why);
+        return -1;
+    }
+    return 0;
+}
+
+// ----------------------------
+// Public: load path and publish it. Returns the number of keys that
+// changed (listed in changed), -1 if the file was rejected (reason in
+// changed); the current snapshot stays in place then.
+// ----------------------------
+static int settings_load(const char *path, char *changed, size_t size) {
+    Settings *next = malloc(sizeof(*next));
+    if (!next) {
+        snprintf(changed, size, "out of memory");
+        return -1;
+    }
+    if (settings_parse(path, next, changed, size) < 0) {
+        free(next);
+        return -1;
+    }
+
+    const Settings *cur = settings_get();
+    int n = 0;
+    size_t len = 0;
+    changed[0] = '\0';
+    for (size_t i = 0; i < SETTINGS_KEY_COUNT; i++) {
+        const SettingsKey *k = &settings_keys[i];
+        double was = settings_value(cur, k), now = settings_value(next, k);
+        if (was == now)
+            continue;
+        if (len < size)
+            len += (size_t)snprintf(changed + len, size - len, "%s%s %.10g -> %.10g",
+                                    n ? ", " : "", k->name, was, now);
+        n++;
+    }
+
+    if (n == 0) {
+        free(next);
+        return 0;
+    }
+    next->retired = cur;
+    atomic_store_explicit(&settings_current, next, memory_order_release);
+    return n;
+}
+
+// Every key with its current value, in file format (--print-config)
+static void settings_print(FILE *out) {
+    const Settings *s = settings_get();
+    for (size_t i = 0; i < SETTINGS_KEY_COUNT; i++)
+        fprintf(out, "%s = %.10g\n", settings_keys[i].name, settings_value(s, &settings_keys[i]));
+}
+
+// Drop every snapshot (exit only: nothing may read settings afterwards)
+static void settings_free(void) {
+    const Settings *s = atomic_exchange(&settings_current, &settings_defaults);
+    while (s && s != &settings_defaults) {
+        const Settings *prev = s->retired;
+        free((void *)s);
+        s = prev;
+    }
+}
+
+// ----------------------------
+// Public: default path, $XDG_CONFIG_HOME (or ~/.config) / CONFIG_FILE_NAME
+// ----------------------------
+static int settings_default_path(char *buf, size_t size) {
+    const char *xdg = getenv("XDG_CONFIG_HOME");
+    const char *home = getenv("HOME");
+    int n = xdg && *xdg ? snprintf(buf, size, "%s/%s", xdg, CONFIG_FILE_NAME)
+          : home && *home ? snprintf(buf, size, "%s/.config/%s", home, CONFIG_FILE_NAME)
+          : -1;
+    return n < 0 || (size_t)n >= size ? -1 : 0;
+}
+
+// ----------------------------
+// Public: inotify on the file's directory (created if missing).
+// Returns the fd for the main loop, -1 if nothing can be watched.
+// ----------------------------
+static char settings_file_name[256];
+
+static int settings_watch(const char *path) {
+    char dir[512];
+    snprintf(dir, sizeof(dir), "%s", path);
+    char *slash = strrchr(dir, '/');
+    if (slash == dir) {
+        slash[1] = '\0';
+    } else if (slash) {
+        *slash = '\0';
+    } else {
+        snprintf(dir, sizeof(dir), ".");
+    }
+    snprintf(settings_file_name, sizeof(settings_file_name), "%s",
+             strrchr(path, '/') ? strrchr(path, '/') + 1 : path);
+
+    for (char *p = dir + 1; *p; p++) {
+        if (*p != '/')
+            continue;
+        *p = '\0';
+        mkdir(dir, 0755);
+        *p = '/';
+    }
+    if (mkdir(dir, 0755) < 0 && errno != EEXIST)
+        return -1;
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+        return -1;
+    if (inotify_add_watch(fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Drain the watch; 1 if the settings file itself was written, replaced or removed
+static int settings_changed(int fd) {
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    int hit = 0;
+    ssize_t n;
+
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+        for (char *p = buf; p < buf + n; ) {
+            const struct inotify_event *ev = (const struct inotify_event *)p;
+            if (ev->len && strcmp(ev->name, settings_file_name) == 0)
+                hit = 1;
+            p += sizeof(*ev) + ev->len;
+        }
+    }
+    return hit;
+}
+
+#endif // SETTINGS_H
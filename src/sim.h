@@ -0,0 +1,247 @@
+// Virtual clock and activity trace for Jigglemil (--simulate)
+// The scheduler runs against a clock that only moves when told to and an
+// idle time taken from a scripted trace instead of real input, so days of
+// use replay in milliseconds. The caller jumps the clock straight to the
+// next event (a seat deadline, or the user coming back while a seat
+// watches for it); nothing sleeps.
+//
+// Trace file, one directive per line, '#' starts a comment:
+//
+//   active 2h          user at the machine (input throughout, idle stays 0)
+//   idle 5m            away from it
+//   idle 1m..20m       duration drawn uniformly from the range
+//   ignore key         the idle source does not notice this action
+//   repeat 5           play the whole trace this many times
+//
+// Durations take ms, s, m, h or d (a bare number is seconds). The trace
+// draws from its own generator, so tuning the thresholds does not change
+// the activity it replays.
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "rng.h"
+
+#define SIM_MAX_SEGMENTS    256
+#define SIM_MS_PER_DAY      86400000ll
+
+typedef struct {
+    int  active;                /* 1 = user input, 0 = away */
+    long min_ms, max_ms;
+} SimSegment;
+
+typedef struct {
+    SimSegment seg[SIM_MAX_SEGMENTS];
+    int  count;
+    int  repeat;                /* plays of the whole trace */
+    unsigned ignore;            /* unnoticed actions, one bit per name */
+} SimTrace;
+
+typedef struct {
+    const SimTrace *trace;
+    Rng  rng;
+    long long now;              /* virtual ms since the start */
+    long long last_input;       /* newest input, the user's or injected */
+    long long run_end;          /* end of the current run of same-kind segments */
+    int  active;
+    int  next, lap;             /* next segment to play */
+    int  last;                  /* the current run ends the trace */
+    long long max_idle;         /* longest gap between inputs so far */
+} SimClock;
+
+// ----------------------------
+// Trace parsing
+// ----------------------------
+static int sim_parse_ms(const char *s, long *ms) {
+    char *end;
+    double v = strtod(s, &end);
+    if (end == s || v < 0)
+        return -1;
+
+    double unit = 1000;
+    if (strcmp(end, "ms") == 0)     unit = 1;
+    else if (strcmp(end, "m") == 0) unit = 60000;
+    else if (strcmp(end, "h") == 0) unit = 3600000;
+    else if (strcmp(end, "d") == 0) unit = SIM_MS_PER_DAY;
+    else if (*end && strcmp(end, "s") != 0)
+        return -1;
+
+    if (v * unit > LONG_MAX / 2)
+        return -1;
+    *ms = (long)(v * unit);
+    return 0;
+}
+
+// "DUR" or "MIN..MAX"
+static int sim_parse_range(char *s, long *min_ms, long *max_ms) {
+    char *dots = strstr(s, "..");
+    if (dots) *dots = '\0';
+    if (sim_parse_ms(s, min_ms) < 0)
+        return -1;
+    if (!dots) {
+        *max_ms = *min_ms;
+        return 0;
+    }
+    return sim_parse_ms(dots + 2, max_ms) < 0 || *max_ms < *min_ms ? -1 : 0;
+}
+
+// ----------------------------
+// Public: load a trace; names are the actions "ignore" may list
+// ----------------------------
+static int sim_trace_load(SimTrace *t, const char *path, const char *const *names, int name_count) {
+    memset(t, 0, sizeof(*t));
+    t->repeat = 1;
+
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        fprintf(stderr, "sim: cannot open %s\n", path);
+        return -1;
+    }
+
+    char line[256], raw[256];
+    int lineno = 0, err = 0;
+    while (!err && fgets(line, sizeof(line), fp)) {
+        lineno++;
+        snprintf(raw, sizeof(raw), "%s", line);
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        char *word = strtok(line, " \t\r\n");
+        char *arg  = strtok(NULL, " \t\r\n");
+        if (!word)
+            continue;
+        if (!arg || strtok(NULL, " \t\r\n")) {
+            err = 1;
+            break;
+        }
+
+        if (strcmp(word, "active") == 0 || strcmp(word, "idle") == 0) {
+            if (t->count == SIM_MAX_SEGMENTS) {
+                err = 1;
+                break;
+            }
+            SimSegment *g = &t->seg[t->count++];
+            g->active = word[0] == 'a';
+            err = sim_parse_range(arg, &g->min_ms, &g->max_ms) < 0;
+        } else if (strcmp(word, "repeat") == 0) {
+            t->repeat = atoi(arg);
+            err = t->repeat < 1;
+        } else if (strcmp(word, "ignore") == 0) {
+            int i = 0;
+            while (i < name_count && strcmp(arg, names[i]) != 0)
+                i++;
+            err = i == name_count;
+            t->ignore |= 1u << i;
+        } else {
+            err = 1;
+        }
+    }
+    fclose(fp);
+
+    if (err) {
+        raw[strcspn(raw, "\r\n")] = '\0';
+        fprintf(stderr, "sim: %s:%d: cannot parse: %s\n", path, lineno, raw);
+        return -1;
+    }
+    if (t->count == 0) {
+        fprintf(stderr, "sim: %s: no active / idle lines\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+// ----------------------------
+// Clock: segments of the same kind are merged into one run, so the end of
+// a run is always an edge (the user leaves or comes back)
+// ----------------------------
+static void sim_next_run(SimClock *c) {
+    const SimTrace *t = c->trace;
+    int kind = -1;
+
+    for (;;) {
+        if (c->next == t->count) {
+            if (c->lap + 1 == t->repeat) {
+                c->last = 1;
+                return;
+            }
+            c->lap++;
+            c->next = 0;
+        }
+
+        const SimSegment *g = &t->seg[c->next];
+        if (kind >= 0 && g->active != kind)
+            return;
+
+        kind = g->active;
+        c->active = kind;
+        c->run_end += g->min_ms == g->max_ms
+            ? g->min_ms : (long long)rng_range(&c->rng, g->min_ms, g->max_ms);
+        c->next++;
+    }
+}
+
+// ----------------------------
+// Public: clock
+// ----------------------------
+static void sim_start(SimClock *c, const SimTrace *t, uint64_t seed) {
+    memset(c, 0, sizeof(*c));
+    c->trace = t;
+    rng_seed(&c->rng, seed);
+    sim_next_run(c);
+}
+
+static void sim_gap(SimClock *c, long long t) {
+    if (t - c->last_input > c->max_idle)
+        c->max_idle = t - c->last_input;
+}
+
+// Move the clock forward to t, through as many runs as that takes
+static void sim_advance(SimClock *c, long long t) {
+    while (!c->last && t >= c->run_end) {
+        if (c->active)
+            c->last_input = c->run_end;
+        else
+            sim_gap(c, c->run_end);
+        sim_next_run(c);
+    }
+    if (t > c->now)
+        c->now = t;
+    if (c->active)
+        c->last_input = c->now < c->run_end ? c->now : c->run_end;
+}
+
+// Injected input the idle source noticed
+static void sim_input(SimClock *c) {
+    sim_gap(c, c->now);
+    if (c->now > c->last_input)
+        c->last_input = c->now;
+}
+
+static long sim_idle_ms(const SimClock *c) {
+    return (long)(c->now - c->last_input);
+}
+
+// When the user comes back (LLONG_MAX: not before the trace ends)
+static long long sim_next_input(const SimClock *c) {
+    return c->active || c->last ? LLONG_MAX : c->run_end;
+}
+
+// End of the trace (LLONG_MAX until its last run has been drawn)
+static long long sim_end(const SimClock *c) {
+    return c->last ? c->run_end : LLONG_MAX;
+}
+
+// "1d 02:03:04.005"
+static void sim_format(char *buf, size_t size, long long ms) {
+    long long day = ms / SIM_MS_PER_DAY;
+    ms %= SIM_MS_PER_DAY;
+    snprintf(buf, size, "%lldd %02lld:%02lld:%02lld.%03lld", day,
+             ms / 3600000, ms / 60000 % 60, ms / 1000 % 60, ms % 1000);
+}
+
+#endif // SIM_H
@@ -0,0 +1,187 @@
+// Runtime statistics for Jigglemil
+// Event counters plus log-linear (HDR-style) latency histograms: every
+// power of two is split into 2^HIST_SUB_BITS buckets, so any recorded value
+// is known to within 12.5% with a fixed 2 KB table and no allocation.
+// Recording is a few integer ops and never locks. Histograms are only
+// written by the main thread; counters bumped by input threads are relaxed
+// atomics. Snapshots are formatted outside the playback path.
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <math.h>
+
+#include "clock.h"
+
+#define HIST_SUB_BITS   3
+#define HIST_SUB        (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS    ((64 - HIST_SUB_BITS + 1) * HIST_SUB)
+
+typedef struct {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+    uint32_t buckets[HIST_BUCKETS];
+} Histogram;
+
+typedef enum {
+    STAT_IDLE_EVENTS,       // activity reports from the idle backend
+    STAT_LOOP_WAKEUPS,      // main loop wakeups
+    STAT_ACTIONS,
+    STAT_POINTS,            // points injected
+    STAT_INJECT_ERRORS,
+    STAT_ACTION_KEY,        // actions settled by a key tap
+    STAT_ACTION_JIGGLE,     // ... by a net-zero jiggle
+    STAT_ACTION_PATH,       // ... by a full path
+    STAT_ACTION_MISSES,     // key taps / jiggles that did not reset the idle time
+    STAT_COUNTER_COUNT
+} StatCounter;
+
+typedef enum {
+    STAT_GENERATE,          // path generation time
+    STAT_FIRST_POINT,       // action deadline -> first input (point or key press), once per action
+    STAT_INJECT,            // one inject_move() call
+    STAT_LATENESS,          // point fired vs its planned time
+    STAT_ACTION,            // whole action, start to last point
+    STAT_HIST_COUNT
+} StatHist;
+
+static const char *const stat_counter_names[STAT_COUNTER_COUNT] = {
+    "idle_events", "loop_wakeups", "actions", "points", "inject_errors",
+    "action_key", "action_jiggle", "action_path", "action_misses"
+};
+
+static const char *const stat_hist_names[STAT_HIST_COUNT] = {
+    "generate", "first_point", "inject", "lateness", "action"
+};
+
+static atomic_ullong stat_counters[STAT_COUNTER_COUNT];
+static Histogram stat_hists[STAT_HIST_COUNT];
+static long long stat_start_ns = 0;
+
+// ----------------------------
+// Recording
+// ----------------------------
+static inline void stats_count(StatCounter c, unsigned long long n) {
+    atomic_fetch_add_explicit(&stat_counters[c], n, memory_order_relaxed);
+}
+
+static inline int hist_bucket(uint64_t v) {
+    if (v < HIST_SUB)
+        return (int)v;
+    int e = 63 - __builtin_clzll(v);
+    int sub = (int)(v >> (e - HIST_SUB_BITS)) & (HIST_SUB - 1);
+    return (e - HIST_SUB_BITS + 1) * HIST_SUB + sub;
+}
+
+// Smallest value that lands in bucket i
+static inline uint64_t hist_bucket_low(int i) {
+    if (i < HIST_SUB)
+        return (uint64_t)i;
+    int e = i / HIST_SUB + HIST_SUB_BITS - 1;
+    return (uint64_t)(HIST_SUB + i % HIST_SUB) << (e - HIST_SUB_BITS);
+}
+
+static inline void hist_add(Histogram *hg, uint64_t v) {
+    hg->buckets[hist_bucket(v)]++;
+    hg->count++;
+    hg->sum += v;
+    if (v > hg->max)
+        hg->max = v;
+}
+
+// Fold from into into; histograms filled on separate threads merge exactly
+static inline void hist_merge(Histogram *into, const Histogram *from) {
+    for (int i = 0; i < HIST_BUCKETS; i++)
+        into->buckets[i] += from->buckets[i];
+    into->count += from->count;
+    into->sum   += from->sum;
+    if (from->max > into->max)
+        into->max = from->max;
+}
+
+static inline void stats_record(StatHist h, long long ns) {
+    hist_add(&stat_hists[h], ns > 0 ? (uint64_t)ns : 0);
+}
+
+// ----------------------------
+// Reading
+// ----------------------------
+static uint64_t hist_percentile(const Histogram *hg, double q) {
+    if (hg->count == 0)
+        return 0;
+
+    /* nearest rank: smallest value with at least q of the samples at or below it */
+    uint64_t rank = (uint64_t)ceil(q * (double)hg->count);
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += hg->buckets[i];
+        if (seen >= rank) {
+            /* middle of the bucket, never above the real maximum */
+            uint64_t lo = hist_bucket_low(i);
+            uint64_t hi = i + 1 < HIST_BUCKETS ? hist_bucket_low(i + 1) : lo;
+            uint64_t mid = lo + (hi - lo) / 2;
+            return mid < hg->max ? mid : hg->max;
+        }
+    }
+    return hg->max;
+}
+
+static void stats_init(void) {
+    memset(stat_hists, 0, sizeof(stat_hists));
+    for (int i = 0; i < STAT_COUNTER_COUNT; i++)
+        atomic_store(&stat_counters[i], 0);
+    stat_start_ns = now_ns();
+}
+
+// One histogram as a single human-readable line (us)
+static void stats_hist_line(StatHist h, char *buf, size_t size) {
+    const Histogram *hg = &stat_hists[h];
+    snprintf(buf, size, "%-11s n=%-7llu p50=%.1f p90=%.1f p99=%.1f max=%.1f us",
+             stat_hist_names[h], (unsigned long long)hg->count,
+             hist_percentile(hg, 0.50) / 1000.0, hist_percentile(hg, 0.90) / 1000.0,
+             hist_percentile(hg, 0.99) / 1000.0, hg->max / 1000.0);
+}
+
+// ----------------------------
+// Public: whole snapshot as JSON (times in us); returns length
+// ----------------------------
+static int stats_format_json(char *buf, size_t size) {
+    double uptime = (now_ns() - stat_start_ns) / 1e9;
+    size_t len = 0;
+
+#define STATS_APPEND(...) do { \
+        int n_ = snprintf(buf + len, len < size ? size - len : 0, __VA_ARGS__); \
+        if (n_ > 0) len += (size_t)n_; \
+    } while (0)
+
+    STATS_APPEND("{\"uptime_s\": %.1f, \"counters\": {", uptime);
+    for (int i = 0; i < STAT_COUNTER_COUNT; i++) {
+        STATS_APPEND("%s\"%s\": %llu", i ? ", " : "", stat_counter_names[i],
+                     (unsigned long long)atomic_load_explicit(&stat_counters[i],
+                                                              memory_order_relaxed));
+    }
+    STATS_APPEND(", \"idle_events_per_sec\": %.2f}, \"histograms_us\": {",
+                 uptime > 0 ? atomic_load(&stat_counters[STAT_IDLE_EVENTS]) / uptime : 0.0);
+
+    for (int i = 0; i < STAT_HIST_COUNT; i++) {
+        const Histogram *hg = &stat_hists[i];
+        STATS_APPEND("%s\"%s\": {\"count\": %llu, \"mean\": %.1f, \"p50\": %.1f, "
+                     "\"p90\": %.1f, \"p99\": %.1f, \"max\": %.1f}",
+                     i ? ", " : "", stat_hist_names[i], (unsigned long long)hg->count,
+                     hg->count ? (double)hg->sum / hg->count / 1000.0 : 0.0,
+                     hist_percentile(hg, 0.50) / 1000.0, hist_percentile(hg, 0.90) / 1000.0,
+                     hist_percentile(hg, 0.99) / 1000.0, hg->max / 1000.0);
+    }
+    STATS_APPEND("}}\n");
+
+#undef STATS_APPEND
+    return (int)(len < size ? len : size - 1);
+}
+
+#endif // STATS_H
@@ -0,0 +1,192 @@
+// Shared-memory status pages for Jigglemil
+// One small file per seat in the runtime directory (runtime_dir.h, tmpfs
+// under $XDG_RUNTIME_DIR) that the daemon keeps mmap'd and updates in
+// place: jigglemil.status for the default seat, jigglemil.NAME.status for
+// each --seat. Panels and scripts map it read-only and read the current
+// state with no syscalls at all. A sequence counter (seqlock) makes every
+// read a consistent snapshot: odd = write in progress, changed = retry.
+// A daemon killed mid-update leaves the counter odd; the next one to open
+// the page makes it even again, and readers give up after a bounded number
+// of tries (a dead writer's page reads as stopped).
+//
+// Times are CLOCK_REALTIME milliseconds so readers in other processes can
+// compute countdowns themselves without the daemon rewriting anything.
+
+#ifndef STATUS_PAGE_H
+#define STATUS_PAGE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <errno.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define STATUS_PAGE_MAGIC    0x534c474au     /* "JGLS" */
+#define STATUS_PAGE_VERSION  2
+#define STATUS_PAGE_SPINS    100         /* reader: busy retries, then yield between them */
+#define STATUS_PAGE_TRIES    10000       /* reader: give up after this many */
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    _Atomic uint32_t seq;           /* even = stable, odd = being written */
+    int32_t  pid;                   /* 0 once the daemon has stopped */
+
+    int64_t  last_activity_ms;      /* realtime ms of the last user input */
+    int64_t  next_action_ms;        /* realtime ms of the next action, -1 = none */
+    int64_t  updated_ms;            /* realtime ms of this snapshot */
+    uint64_t actions;               /* actions performed so far */
+    uint32_t paused;
+    char     state[16];             /* UTF-8 emoji, NUL-terminated */
+    char     seat[32];              /* seat name, NUL-terminated */
+} StatusPage;
+
+static inline int64_t realtime_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// ----------------------------
+// Public (daemon): create and map the page at path, for seat
+// ----------------------------
+static StatusPage *status_page_open(const char *path, const char *seat) {
+    int fd = open(path, O_RDWR | O_CREAT | O_NOFOLLOW | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return NULL;
+
+    if (ftruncate(fd, sizeof(StatusPage)) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    StatusPage *page = mmap(NULL, sizeof(StatusPage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (page == MAP_FAILED)
+        return NULL;
+
+    /* whatever the last daemon left: odd (write open) from here on, and
+     * even once this first write is done */
+    uint32_t seq = atomic_load_explicit(&page->seq, memory_order_relaxed);
+    atomic_store_explicit(&page->seq, (seq + 1) | 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    page->magic   = STATUS_PAGE_MAGIC;
+    page->version = STATUS_PAGE_VERSION;
+    page->pid     = (int32_t)getpid();
+    snprintf(page->seat, sizeof(page->seat), "%s", seat);
+
+    atomic_fetch_add_explicit(&page->seq, 1, memory_order_release);
+    return page;
+}
+
+// ----------------------------
+// Public (daemon): publish a new snapshot (a few stores, no syscalls
+// beyond the vDSO clock read)
+// ----------------------------
+static void status_page_update(StatusPage *page, const char *state, long idle_ms,
+                               long action_limit_ms, int paused, uint64_t actions) {
+    if (!page)
+        return;
+
+    int64_t now = realtime_ms();
+
+    atomic_fetch_add_explicit(&page->seq, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    page->last_activity_ms = now - idle_ms;
+    page->next_action_ms   = paused ? -1 : now - idle_ms + action_limit_ms;
+    page->updated_ms       = now;
+    page->actions          = actions;
+    page->paused           = (uint32_t)paused;
+    snprintf(page->state, sizeof(page->state), "%s", state);
+
+    atomic_fetch_add_explicit(&page->seq, 1, memory_order_release);
+}
+
+static void status_page_close(StatusPage *page) {
+    if (!page)
+        return;
+
+    atomic_fetch_add_explicit(&page->seq, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    page->pid = 0;
+    page->next_action_ms = -1;
+    snprintf(page->state, sizeof(page->state), "%s", "⚫");
+    atomic_fetch_add_explicit(&page->seq, 1, memory_order_release);
+
+    munmap(page, sizeof(StatusPage));
+}
+
+// A writer that is gone for good (no such process)
+static int status_page_writer_dead(int32_t pid) {
+    return pid <= 0 || (kill((pid_t)pid, 0) < 0 && errno == ESRCH);
+}
+
+// ----------------------------
+// Public (reader): consistent copy of the page; -1 if not a status page,
+// or if a live writer kept it mid-update for all STATUS_PAGE_TRIES. A page
+// stuck mid-update by a dead daemon reads as stopped (pid 0).
+// ----------------------------
+static int status_page_read(const StatusPage *page, StatusPage *out) {
+    int tries = 0;
+    for (;; tries++) {
+        if (tries >= STATUS_PAGE_SPINS)
+            sched_yield();      /* the writer may be preempted */
+        if (tries == STATUS_PAGE_TRIES) {
+            memcpy(out, (const void *)page, sizeof(*out));
+            if (!status_page_writer_dead(out->pid))
+                return -1;
+            out->pid = 0;
+            snprintf(out->state, sizeof(out->state), "%s", "⚫");
+            break;
+        }
+
+        uint32_t s1 = atomic_load_explicit(&page->seq, memory_order_acquire);
+        if (s1 & 1)
+            continue;       /* writer mid-update: a handful of stores */
+
+        memcpy(out, (const void *)page, sizeof(*out));
+        atomic_thread_fence(memory_order_acquire);
+
+        if (atomic_load_explicit(&page->seq, memory_order_relaxed) == s1)
+            break;
+    }
+
+    if (out->magic != STATUS_PAGE_MAGIC || out->version != STATUS_PAGE_VERSION)
+        return -1;
+    out->state[sizeof(out->state) - 1] = '\0';
+    out->seat[sizeof(out->seat) - 1] = '\0';
+    return 0;
+}
+
+// Map an existing page read-only (NULL if the daemon never created one)
+static const StatusPage *status_page_map(const char *path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return NULL;
+
+    /* a short file would SIGBUS on access */
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(StatusPage)) {
+        close(fd);
+        return NULL;
+    }
+
+    void *p = mmap(NULL, sizeof(StatusPage), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    return p == MAP_FAILED ? NULL : p;
+}
+
+static void status_page_unmap(const StatusPage *page) {
+    munmap((void *)page, sizeof(StatusPage));
+}
+
+#endif // STATUS_PAGE_H
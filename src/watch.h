@@ -0,0 +1,368 @@
+// Watch-mode dashboard for Jigglemil (--watch)
+// The main loop only publishes a snapshot per seat: a few stores under a
+// sequence counter, as on the status pages. A render thread composes a
+// frame from them every WATCH_REFRESH_MS, one block per seat, extrapolating
+// countdowns from each snapshot's timestamp. Playback only bumps the seat's
+// atomic point counter, so rendering can never delay an action.
+//
+// Frames are diffed against the previous one. For each changed row the
+// renderer moves the cursor to the first changed column and rewrites from
+// there, then erases to the end of the line. Only the first frame clears
+// the screen. A steady countdown costs a few dozen bytes per refresh,
+// which keeps SSH and tmux flicker-free. While the daemon is parked the
+// thread draws one last frame and then waits without a timeout.
+
+#ifndef WATCH_H
+#define WATCH_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "clock.h"
+#include "settings.h"
+
+#define WATCH_SEAT_ROW  4       /* first row of the first seat's block */
+#define WATCH_SEAT_ROWS 7       /* rows per seat, blank line included */
+#define WATCH_ROWS      (WATCH_SEAT_ROW + WATCH_SEAT_ROWS * SEAT_MAX + 5)
+#define WATCH_COLS      160     /* bytes per row, UTF-8 included */
+#define WATCH_BAR       20      /* path progress bar width */
+
+typedef struct {
+    _Atomic uint32_t seq;       /* even = stable, odd = being written */
+    const char *seat;           /* the seat's name, valid until watch_stop */
+    const char *status;         /* string literals only */
+    const char *emoji;
+    long        idle_ms;        /* idle time at stamp_ns */
+    long        action_limit_ms;
+    long long   stamp_ns;
+    int         paused;
+    int         smooth;
+} WatchSnapshot;
+
+static WatchSnapshot watch_snap[SEAT_MAX];
+static int watch_seats = 1;     /* blocks drawn; set before the thread starts */
+
+#define WATCH_PARKED    2       /* snapshot.paused: parked by logind, not by --ctl */
+
+// Path progress per seat, written from playback
+static atomic_int watch_points_played[SEAT_MAX];
+static atomic_int watch_points_total[SEAT_MAX];     /* 0 = no path playing */
+static _Atomic long long watch_path_start_ns[SEAT_MAX];
+
+static char watch_frame[2][WATCH_ROWS][WATCH_COLS];
+static int watch_cur = 0;
+static int watch_first = 1;
+
+static pthread_t watch_thread;
+static atomic_int watch_running = 0;
+
+static pthread_mutex_t watch_park_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t watch_park_cond = PTHREAD_COND_INITIALIZER;
+static int watch_parked = 0;
+
+// ----------------------------
+// Public (main loop): publish the state the dashboard should show for a seat
+// ----------------------------
+static void watch_publish(int seat, const char *name, const char *status, const char *emoji,
+                          long idle_ms, long action_limit_ms, int paused, int smooth) {
+    WatchSnapshot *w = &watch_snap[seat];
+    atomic_fetch_add_explicit(&w->seq, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    w->seat            = name;
+    w->status          = status;
+    w->emoji           = emoji;
+    w->idle_ms         = idle_ms;
+    w->action_limit_ms = action_limit_ms;
+    w->stamp_ns        = now_ns();
+    w->paused          = paused;
+    w->smooth          = smooth;
+
+    atomic_fetch_add_explicit(&w->seq, 1, memory_order_release);
+}
+
+// ----------------------------
+// Public (playback): path progress of a seat, relaxed stores only
+// ----------------------------
+static inline void watch_path_begin(int seat, int total) {
+    atomic_store_explicit(&watch_points_played[seat], 0, memory_order_relaxed);
+    atomic_store_explicit(&watch_path_start_ns[seat], now_ns(), memory_order_relaxed);
+    atomic_store_explicit(&watch_points_total[seat], total, memory_order_relaxed);
+}
+
+static inline void watch_path_point(int seat, int played) {
+    atomic_store_explicit(&watch_points_played[seat], played, memory_order_relaxed);
+}
+
+static inline void watch_path_end(int seat) {
+    atomic_store_explicit(&watch_points_total[seat], 0, memory_order_relaxed);
+}
+
+// ----------------------------
+// Frame composition
+// ----------------------------
+static void watch_snapshot_read(int seat, WatchSnapshot *out) {
+    const WatchSnapshot *w = &watch_snap[seat];
+    for (;;) {
+        uint32_t s1 = atomic_load_explicit(&w->seq, memory_order_acquire);
+        if (s1 & 1)
+            continue;
+
+        out->seat            = w->seat;
+        out->status          = w->status;
+        out->emoji           = w->emoji;
+        out->idle_ms         = w->idle_ms;
+        out->action_limit_ms = w->action_limit_ms;
+        out->stamp_ns        = w->stamp_ns;
+        out->paused          = w->paused;
+        out->smooth          = w->smooth;
+        atomic_thread_fence(memory_order_acquire);
+
+        if (atomic_load_explicit(&w->seq, memory_order_relaxed) == s1)
+            return;
+    }
+}
+
+enum { WATCH_IDLE, WATCH_RUNNING, WATCH_DONE };
+
+static void watch_countdown(char *buf, size_t size, const char *label, long ms, int mode) {
+    if (ms < 0) ms = 0;
+    if (mode == WATCH_IDLE)
+        snprintf(buf, size, "      %-6s   --", label);
+    else
+        snprintf(buf, size, "      %-6s %3ld.%03ld s%s", label, ms / 1000, ms % 1000,
+                 mode == WATCH_RUNNING ? "  ↓" : "");
+}
+
+// One seat's block: state, countdowns and path progress from row r on
+static void watch_compose_seat(char frame[WATCH_ROWS][WATCH_COLS], int r, int seat,
+                               long long now, long warning_ms) {
+    WatchSnapshot s;
+    watch_snapshot_read(seat, &s);
+    if (!s.status)
+        return;             /* nothing published yet */
+
+    int total = atomic_load_explicit(&watch_points_total[seat], memory_order_relaxed);
+    int playing = total > 0;
+
+    /* idle keeps growing until the next snapshot; frozen while a path plays */
+    long idle = s.idle_ms;
+    if (!playing && !s.paused)
+        idle += (long)((now - s.stamp_ns) / 1000000);
+
+    if (watch_seats > 1 && s.seat)
+        snprintf(frame[r], WATCH_COLS, "  %s  %-10s [%s]", s.emoji, s.status, s.seat);
+    else
+        snprintf(frame[r], WATCH_COLS, "  %s  %s", s.emoji, s.status);
+
+    if (s.paused == WATCH_PARKED) {
+        snprintf(frame[r + 2], WATCH_COLS, "      Parked until the session is active again");
+    } else if (s.paused) {
+        snprintf(frame[r + 2], WATCH_COLS, "      Paused  (jigglemil --ctl resume)");
+    } else if (idle < warning_ms && !playing) {
+        watch_countdown(frame[r + 2], WATCH_COLS, "Green:", warning_ms - idle, WATCH_RUNNING);
+        watch_countdown(frame[r + 3], WATCH_COLS, "Red:", 0, WATCH_IDLE);
+    } else {
+        watch_countdown(frame[r + 2], WATCH_COLS, "Green:", 0, WATCH_DONE);
+        watch_countdown(frame[r + 3], WATCH_COLS, "Red:", s.action_limit_ms - idle,
+                        playing ? WATCH_DONE : WATCH_RUNNING);
+    }
+
+    if (playing) {
+        int played = atomic_load_explicit(&watch_points_played[seat], memory_order_relaxed);
+        long long start = atomic_load_explicit(&watch_path_start_ns[seat], memory_order_relaxed);
+        if (played > total) total = played;   /* streaming: total still growing */
+
+        char bar[WATCH_BAR * 3 + 1];
+        int fill = total ? played * WATCH_BAR / total : 0;
+        size_t b = 0;
+        for (int i = 0; i < WATCH_BAR; i++) {
+            const char *c = i < fill ? "█" : "░";
+            memcpy(bar + b, c, 3);
+            b += 3;
+        }
+        bar[b] = '\0';
+
+        snprintf(frame[r + 5], WATCH_COLS, "      Path:  %4d/%-4d %s %5.1f s",
+                 played, total, bar, (now - start) / 1e9);
+    } else {
+        snprintf(frame[r + 5], WATCH_COLS, "      Path:    --");
+    }
+}
+
+static void watch_compose(char frame[WATCH_ROWS][WATCH_COLS]) {
+    static const char rule[] = "═══════════════════════════════════════════";
+
+    long long now = now_ns();
+    long warning_ms = settings_get()->warning_limit_ms;
+    WatchSnapshot first;
+    watch_snapshot_read(0, &first);
+
+    for (int r = 0; r < WATCH_ROWS; r++)
+        frame[r][0] = '\0';
+
+    snprintf(frame[0], WATCH_COLS, "%s", rule);
+    snprintf(frame[1], WATCH_COLS, "       JIGGLEMIL - WATCH MODE");
+    snprintf(frame[2], WATCH_COLS, "%s", rule);
+
+    for (int i = 0; i < watch_seats; i++)
+        watch_compose_seat(frame, WATCH_SEAT_ROW + i * WATCH_SEAT_ROWS, i, now, warning_ms);
+
+    char ts[16];
+    time_t t = time(NULL);
+    struct tm tm;
+    localtime_r(&t, &tm);
+    strftime(ts, sizeof(ts), "%H:%M:%S", &tm);
+
+    int r = WATCH_SEAT_ROW + watch_seats * WATCH_SEAT_ROWS;
+    snprintf(frame[r], WATCH_COLS, "%s", rule);
+    snprintf(frame[r + 1], WATCH_COLS, "  [%s]  Mode: %s", ts,
+             first.smooth ? "SMOOTH" : "BATCH");
+    snprintf(frame[r + 2], WATCH_COLS, "%s", rule);
+    snprintf(frame[r + 4], WATCH_COLS, "  Press Ctrl+C to stop");
+}
+
+// ----------------------------
+// Diff: cursor-addressed rewrite of each changed row. Columns are only
+// counted through ASCII; past the first multi-byte character the row is
+// rewritten from there (emoji widths vary between terminals).
+// ----------------------------
+static size_t watch_diff(char *out, size_t size, char prev[WATCH_ROWS][WATCH_COLS],
+                         char next[WATCH_ROWS][WATCH_COLS]) {
+    size_t len = 0;
+
+    for (int r = 0; r < WATCH_ROWS && len < size; r++) {
+        const char *a = prev[r], *b = next[r];
+        if (strcmp(a, b) == 0)
+            continue;
+
+        int i = 0;
+        while (b[i] && a[i] == b[i] && !(b[i] & 0x80))
+            i++;
+
+        int n = snprintf(out + len, size - len, "\033[%d;%dH%s\033[K", r + 1, i + 1, b + i);
+        if (n > 0)
+            len += (size_t)n;
+    }
+    return len < size ? len : size;
+}
+
+static void watch_write(const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t w = write(STDOUT_FILENO, buf, len);
+        if (w < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        buf += w;
+        len -= (size_t)w;
+    }
+}
+
+static void watch_render(void) {
+    static char out[WATCH_ROWS * (WATCH_COLS + 16) + 32];
+    size_t len = 0;
+
+    int next = watch_cur ^ 1;
+    watch_compose(watch_frame[next]);
+
+    if (watch_first) {
+        /* hide the cursor, clear once; the previous frame is all blank */
+        memcpy(out, "\033[?25l\033[H\033[2J", 14);
+        len = 14;
+        memset(watch_frame[watch_cur], 0, sizeof(watch_frame[watch_cur]));
+        watch_first = 0;
+    }
+
+    len += watch_diff(out + len, sizeof(out) - len, watch_frame[watch_cur], watch_frame[next]);
+    watch_cur = next;
+
+    if (len > 0)
+        watch_write(out, len);
+}
+
+static void* watch_thread_main(void *arg) {
+    (void)arg;
+    struct timespec tick;
+    clock_gettime(CLOCK_MONOTONIC, &tick);
+
+    while (atomic_load(&watch_running)) {
+        watch_render();
+
+        pthread_mutex_lock(&watch_park_lock);
+        if (watch_parked) {
+            /* the frame above may predate the parked snapshot */
+            watch_render();
+            while (watch_parked && atomic_load(&watch_running))
+                pthread_cond_wait(&watch_park_cond, &watch_park_lock);
+            clock_gettime(CLOCK_MONOTONIC, &tick);
+        }
+        pthread_mutex_unlock(&watch_park_lock);
+
+        tick.tv_nsec += WATCH_REFRESH_MS * 1000000l;
+        while (tick.tv_nsec >= 1000000000l) {
+            tick.tv_sec++;
+            tick.tv_nsec -= 1000000000l;
+        }
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &tick, NULL) == EINTR)
+            ;
+    }
+    return NULL;
+}
+
+// ----------------------------
+// Public: lifecycle
+// ----------------------------
+static int watch_start(int seats) {
+    watch_seats = seats < 1 ? 1 : seats > SEAT_MAX ? SEAT_MAX : seats;
+
+    /* signals belong to the main loop */
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &old);
+
+    atomic_store(&watch_running, 1);
+    int r = pthread_create(&watch_thread, NULL, watch_thread_main, NULL);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    if (r != 0) {
+        atomic_store(&watch_running, 0);
+        return -1;
+    }
+    return 0;
+}
+
+// ----------------------------
+// Public: stop / resume redrawing (publish the parked snapshot first)
+// ----------------------------
+static void watch_park(int parked) {
+    pthread_mutex_lock(&watch_park_lock);
+    watch_parked = parked;
+    pthread_cond_signal(&watch_park_cond);
+    pthread_mutex_unlock(&watch_park_lock);
+}
+
+// Draw the final frame, then leave the cursor below the dashboard
+static void watch_stop(void) {
+    if (!atomic_exchange(&watch_running, 0))
+        return;
+    watch_park(0);
+    pthread_join(watch_thread, NULL);
+
+    watch_render();
+
+    char buf[32];
+    int n = snprintf(buf, sizeof(buf), "\033[%d;1H\033[?25h",
+                     WATCH_SEAT_ROW + watch_seats * WATCH_SEAT_ROWS + 6);
+    watch_write(buf, (size_t)n);
+}
+
+#endif // WATCH_H
@@ -0,0 +1,216 @@
+// WindMouse path generator for Jigglemil
+// Resumable: a WindState produces one point per call, so playback can start
+// with the first point while the rest of the path is still being computed.
+// Each WindState owns its PRNG: the same (seed, target) gives the same path.
+// Points are stored packed (int8 dx/dy + uint16 delay, 4 bytes each).
+
+#ifndef WINDMOUSE_H
+#define WINDMOUSE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "rng.h"
+#include "settings.h"
+
+// ============================================================================
+// DATA STRUCTURES
+// ============================================================================
+
+typedef struct {
+    int dx;
+    int dy;
+    int delay_us;
+} PathPoint;
+
+typedef struct {
+    PathPoint points[MAX_PATH_POINTS];
+    int count;
+} MousePath;
+
+/* compact form for streamed / recorded / preloaded paths */
+typedef struct {
+    int8_t   dx;
+    int8_t   dy;
+    uint16_t delay_us;
+} PackedPoint;
+
+_Static_assert(MAX_DELAY_US <= UINT16_MAX, "delay_us must fit PackedPoint");
+_Static_assert(MAX_STEP_MAX < 64, "per-point delta must fit PackedPoint");
+
+typedef struct {
+    // Randomized parameters for this movement
+    double mouse_speed;
+    double gravity;
+    double wind;
+    double target_radius;
+    double max_step;
+
+    double target_x, target_y;
+    double x, y;
+    double vx, vy;
+    double wx, wy;
+
+    const Settings *cfg;    // snapshot taken when the path started
+    Rng rng;
+    int count;      // points produced so far
+    int done;
+} WindState;
+
+// ============================================================================
+// GENERATOR
+// ============================================================================
+
+static void wind_init(WindState *st, uint64_t seed, double target_x, double target_y) {
+    const Settings *cfg = settings_get();
+    rng_seed(&st->rng, seed);
+    st->cfg = cfg;
+
+    // Randomize parameters for this movement (each path is unique)
+    st->mouse_speed   = rng_range(&st->rng, cfg->mouse_speed_min, cfg->mouse_speed_max);
+    st->gravity       = rng_range(&st->rng, cfg->gravity_min, cfg->gravity_max);
+    st->wind          = rng_range(&st->rng, cfg->wind_min, cfg->wind_max);
+    st->target_radius = rng_range(&st->rng, cfg->target_radius_min, cfg->target_radius_max);
+    st->max_step      = rng_range(&st->rng, cfg->max_step_min, cfg->max_step_max);
+
+    st->target_x = target_x;
+    st->target_y = target_y;
+    st->x  = st->y  = 0;
+    st->vx = st->vy = 0;
+    st->wx = st->wy = 0;
+    st->count = 0;
+    st->done  = 0;
+}
+
+// Advance until the next non-zero pixel delta; returns 0 once the path ended
+static int wind_next(WindState *st, PackedPoint *out) {
+    while (!st->done) {
+        double dist = hypot(st->target_x - st->x, st->target_y - st->y);
+
+        if (dist <= st->target_radius || st->count >= MAX_PATH_POINTS) {
+            st->done = 1;
+            break;
+        }
+
+        // Wind component (random drift)
+        st->wx = st->wx / sqrt(3.0) + rng_range(&st->rng, -st->wind, st->wind) / sqrt(5.0);
+        st->wy = st->wy / sqrt(3.0) + rng_range(&st->rng, -st->wind, st->wind) / sqrt(5.0);
+
+        // Velocity update (gravity pulls toward target)
+        if (dist > 0) {
+            st->vx += (st->wx + (st->target_x - st->x) * st->gravity / dist) / st->mouse_speed;
+            st->vy += (st->wy + (st->target_y - st->y) * st->gravity / dist) / st->mouse_speed;
+        }
+
+        // Clamp velocity
+        double vel = hypot(st->vx, st->vy);
+        if (vel > st->max_step) {
+            st->vx = (st->vx / vel) * st->max_step;
+            st->vy = (st->vy / vel) * st->max_step;
+        }
+
+        // Calculate pixel delta
+        int dx = (int)round(st->x + st->vx) - (int)round(st->x);
+        int dy = (int)round(st->y + st->vy) - (int)round(st->y);
+
+        st->x += st->vx;
+        st->y += st->vy;
+
+        // Only record actual movements
+        if (dx != 0 || dy != 0) {
+            out->dx       = (int8_t)dx;
+            out->dy       = (int8_t)dy;
+            out->delay_us = (uint16_t)rng_range(&st->rng, st->cfg->min_delay_us,
+                                                st->cfg->max_delay_us);
+            st->count++;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// ============================================================================
+// STREAM (small ring buffer in front of the generator)
+// ============================================================================
+
+typedef struct {
+    WindState   gen;
+    PackedPoint ring[PATH_RING_SIZE];
+    unsigned    head;   // next slot to fill
+    unsigned    tail;   // next slot to play
+
+    const PackedPoint *preset;  // finished path to play instead of gen
+    int                preset_count;
+} PathStream;
+
+static void stream_init(PathStream *s, uint64_t seed, double target_x, double target_y) {
+    wind_init(&s->gen, seed, target_x, target_y);
+    s->head = s->tail = 0;
+    s->preset = NULL;
+    s->preset_count = 0;
+}
+
+// Play an already generated path (points must outlive the stream)
+static void stream_init_packed(PathStream *s, const PackedPoint *points, int count) {
+    s->head = s->tail = 0;
+    s->preset = points;
+    s->preset_count = count;
+}
+
+// Top up the ring; cheap enough to call between two injections
+static void stream_fill(PathStream *s) {
+    if (s->preset)
+        return;
+
+    while (s->head - s->tail < PATH_RING_SIZE &&
+           wind_next(&s->gen, &s->ring[s->head % PATH_RING_SIZE])) {
+        s->head++;
+    }
+}
+
+// Next point to play; generates on demand if the ring ran dry
+static int stream_pop(PathStream *s, PackedPoint *out) {
+    if (s->preset) {
+        if ((int)s->tail >= s->preset_count)
+            return 0;
+        *out = s->preset[s->tail++];
+        return 1;
+    }
+
+    if (s->head == s->tail) {
+        if (!wind_next(&s->gen, &s->ring[s->head % PATH_RING_SIZE]))
+            return 0;
+        s->head++;
+    }
+    *out = s->ring[s->tail % PATH_RING_SIZE];
+    s->tail++;
+    return 1;
+}
+
+static inline int stream_count(const PathStream *s) {
+    return s->preset ? s->preset_count : s->gen.count;
+}
+
+// ============================================================================
+// WHOLE-PATH API (thin wrapper over the streaming generator)
+// ============================================================================
+
+// Same ranges as a streamed path: wind_init takes the settings snapshot
+MousePath generate_wind_path(uint64_t seed, double target_x, double target_y) {
+    MousePath path = {0};
+    WindState st;
+    PackedPoint p;
+
+    wind_init(&st, seed, target_x, target_y);
+    while (wind_next(&st, &p)) {
+        path.points[path.count].dx       = p.dx;
+        path.points[path.count].dy       = p.dy;
+        path.points[path.count].delay_us = p.delay_us;
+        path.count++;
+    }
+
+    return path;
+}
+
+#endif // WINDMOUSE_H
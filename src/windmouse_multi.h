@@ -0,0 +1,215 @@
+// Multi-candidate WindMouse for Jigglemil
+// Advances WIND_CANDIDATES WindMouse states in lockstep, structure-of-arrays,
+// and keeps the candidate whose point count, duration and end point best
+// match the configured targets. The per-step lane loop is branch-free so
+// the compiler vectorizes it; target_clones adds an AVX2 build next to the
+// baseline (SSE2 / scalar) one and picks at load time.
+
+#ifndef WINDMOUSE_MULTI_H
+#define WINDMOUSE_MULTI_H
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "rng.h"
+#include "windmouse.h"
+
+#define WIND_LANES WIND_CANDIDATES
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+#define WIND_SIMD_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+#define WIND_SIMD_CLONES
+#endif
+
+typedef struct {
+    // Randomized parameters (one per lane)
+    double mouse_speed[WIND_LANES];
+    double gravity[WIND_LANES];
+    double wind[WIND_LANES];
+    double target_radius[WIND_LANES];
+    double max_step[WIND_LANES];
+
+    double x[WIND_LANES],  y[WIND_LANES];
+    double vx[WIND_LANES], vy[WIND_LANES];
+    double wx[WIND_LANES], wy[WIND_LANES];
+
+    // xoshiro256** state, split per word so lanes sit side by side
+    uint64_t s0[WIND_LANES], s1[WIND_LANES], s2[WIND_LANES], s3[WIND_LANES];
+
+    // Step output
+    int32_t  dx[WIND_LANES], dy[WIND_LANES];
+    int32_t  delay_us[WIND_LANES];
+    int32_t  emit[WIND_LANES];
+    int32_t  active[WIND_LANES];
+
+    double target_x, target_y;
+    int    count[WIND_LANES];
+    long   duration_us[WIND_LANES];
+
+    const Settings *cfg;        // snapshot taken when the lanes started
+} WindLanes;
+
+typedef struct {
+    WindLanes   lanes;
+    PackedPoint points[WIND_LANES][MAX_PATH_POINTS];
+} WindCandidates;
+
+// ----------------------------
+// One xoshiro256** draw as a double in [lo, hi) for lane l
+// (multiplies by 5 / 9 written as shift+add: no 64-bit vector multiply)
+// ----------------------------
+static inline double lanes_rand(WindLanes *w, int l, double lo, double hi) {
+    uint64_t s1 = w->s1[l];
+    uint64_t m5 = (s1 << 2) + s1;
+    uint64_t r  = (m5 << 7) | (m5 >> 57);
+    r = (r << 3) + r;
+
+    uint64_t t = s1 << 17;
+    w->s2[l] ^= w->s0[l];
+    w->s3[l] ^= s1;
+    w->s1[l]  = s1 ^ w->s2[l];
+    w->s0[l] ^= w->s3[l];
+    w->s2[l] ^= t;
+    w->s3[l]  = (w->s3[l] << 45) | (w->s3[l] >> 19);
+
+    // 52 random mantissa bits -> [1, 2) -> [0, 1)
+    union { uint64_t u; double d; } bits = { (r >> 12) | 0x3ff0000000000000ull };
+    return lo + (bits.d - 1.0) * (hi - lo);
+}
+
+static void lanes_init(WindLanes *w, uint64_t seed, double target_x, double target_y) {
+    const Settings *cfg = settings_get();
+    memset(w, 0, sizeof(*w));
+    w->cfg = cfg;
+    w->target_x = target_x;
+    w->target_y = target_y;
+
+    for (int l = 0; l < WIND_LANES; l++) {
+        Rng r;
+        rng_seed(&r, seed + (uint64_t)l * 0x9e3779b97f4a7c15ull);
+        w->s0[l] = r.s[0];
+        w->s1[l] = r.s[1];
+        w->s2[l] = r.s[2];
+        w->s3[l] = r.s[3];
+
+        w->mouse_speed[l]   = lanes_rand(w, l, cfg->mouse_speed_min, cfg->mouse_speed_max);
+        w->gravity[l]       = lanes_rand(w, l, cfg->gravity_min, cfg->gravity_max);
+        w->wind[l]          = lanes_rand(w, l, cfg->wind_min, cfg->wind_max);
+        w->target_radius[l] = lanes_rand(w, l, cfg->target_radius_min, cfg->target_radius_max);
+        w->max_step[l]      = lanes_rand(w, l, cfg->max_step_min, cfg->max_step_max);
+        w->active[l]        = 1;
+    }
+}
+
+// ----------------------------
+// Advance every lane one WindMouse step (branch-free, vectorizable).
+// Returns the number of lanes still active.
+// ----------------------------
+WIND_SIMD_CLONES
+static int lanes_step(WindLanes *w) {
+    const double inv_sqrt3 = 1.0 / sqrt(3.0);
+    const double inv_sqrt5 = 1.0 / sqrt(5.0);
+    const double delay_min = (double)w->cfg->min_delay_us;
+    const double delay_max = (double)w->cfg->max_delay_us;
+    int alive = 0;
+
+    for (int l = 0; l < WIND_LANES; l++) {
+        double ex = w->target_x - w->x[l];
+        double ey = w->target_y - w->y[l];
+        double dist = sqrt(ex * ex + ey * ey);
+
+        int on = w->active[l] & (dist > w->target_radius[l]) &
+                 (w->count[l] < MAX_PATH_POINTS);
+
+        // Always draw, so every lane consumes its stream in lockstep
+        double rwx = lanes_rand(w, l, -w->wind[l], w->wind[l]);
+        double rwy = lanes_rand(w, l, -w->wind[l], w->wind[l]);
+        double rdl = lanes_rand(w, l, delay_min, delay_max);
+
+        double wx = w->wx[l] * inv_sqrt3 + rwx * inv_sqrt5;
+        double wy = w->wy[l] * inv_sqrt3 + rwy * inv_sqrt5;
+
+        // dist == 0 only when ex == ey == 0, so the guard value is harmless
+        double g  = w->gravity[l] / (dist > 1e-9 ? dist : 1e-9);
+        double vx = w->vx[l] + (wx + ex * g) / w->mouse_speed[l];
+        double vy = w->vy[l] + (wy + ey * g) / w->mouse_speed[l];
+
+        double vel   = sqrt(vx * vx + vy * vy);
+        double scale = w->max_step[l] / (vel > w->max_step[l] ? vel : w->max_step[l]);
+        vx *= scale;
+        vy *= scale;
+
+        int dx = (int)floor(w->x[l] + vx + 0.5) - (int)floor(w->x[l] + 0.5);
+        int dy = (int)floor(w->y[l] + vy + 0.5) - (int)floor(w->y[l] + 0.5);
+
+        // Commit only for active lanes
+        w->wx[l] = on ? wx : w->wx[l];
+        w->wy[l] = on ? wy : w->wy[l];
+        w->vx[l] = on ? vx : w->vx[l];
+        w->vy[l] = on ? vy : w->vy[l];
+        w->x[l]  = on ? w->x[l] + vx : w->x[l];
+        w->y[l]  = on ? w->y[l] + vy : w->y[l];
+
+        w->dx[l]       = dx;
+        w->dy[l]       = dy;
+        w->delay_us[l] = (int32_t)rdl;
+        w->emit[l]     = on & ((dx | dy) != 0);
+        w->active[l]   = on;
+        alive += on;
+    }
+    return alive;
+}
+
+// ----------------------------
+// Scoring: relative distance to the configured targets (lower = better)
+// ----------------------------
+static double candidate_score(const WindLanes *w, int l) {
+    double ex = w->target_x - w->x[l];
+    double ey = w->target_y - w->y[l];
+    double want = sqrt(w->target_x * w->target_x + w->target_y * w->target_y);
+
+    double points = (double)w->cfg->wind_target_points;
+    double ms = (double)w->cfg->wind_target_duration_ms;
+
+    double s = fabs((double)w->count[l] - points) / points;
+    s += fabs(w->duration_us[l] / 1000.0 - ms) / ms;
+    s += sqrt(ex * ex + ey * ey) / (want > 1.0 ? want : 1.0);
+    return s;
+}
+
+// ----------------------------
+// Public: generate all candidates, return index of the best fit
+// ----------------------------
+static int wind_candidates_generate(WindCandidates *c, uint64_t seed,
+                                    double target_x, double target_y) {
+    WindLanes *w = &c->lanes;
+    lanes_init(w, seed, target_x, target_y);
+
+    while (lanes_step(w) > 0) {
+        for (int l = 0; l < WIND_LANES; l++) {
+            if (!w->emit[l])
+                continue;
+
+            PackedPoint *p = &c->points[l][w->count[l]++];
+            p->dx       = (int8_t)w->dx[l];
+            p->dy       = (int8_t)w->dy[l];
+            p->delay_us = (uint16_t)w->delay_us[l];
+            w->duration_us[l] += p->delay_us;
+        }
+    }
+
+    int best = 0;
+    double best_score = candidate_score(w, 0);
+    for (int l = 1; l < WIND_LANES; l++) {
+        double s = candidate_score(w, l);
+        if (s < best_score) {
+            best_score = s;
+            best = l;
+        }
+    }
+    return best;
+}
+
+#endif // WINDMOUSE_MULTI_H